@@ -4,6 +4,8 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include "src/SettingsDialog.h"
+#include "src/StatsDialog.h"
+#include "src/RevisionsDialog.h"
 #include <QCoreApplication>
 #include <QScrollArea>
 #include <QVBoxLayout>
@@ -14,25 +16,53 @@
 #include <QHBoxLayout>
 #include <QPushButton>
 #include <QProgressDialog>
+#include <QMenu>
+#include <QInputDialog>
+#include <QComboBox>
+#include <QPointer>
+#include <QRegularExpression>
+#include "diagnostics/Tracing.h"
+#include "database/DatabaseWorker.h"
+#include "database/SyncMerge.h"
+#include "models/PostMerge.h"
+#include <QTime>
+#include <utility>
+
+namespace {
+
+// 停止输入多久之后自动保存
+const int AutosaveDelayMs = 2000;
+// 一直在输入时，最早的未保存修改最多等待这么久
+const int AutosaveMaxDelayMs = 10000;
+
+// 冲突字段的显示名称，例如"标题、正文"
+QString fieldNames(Post::Fields fields)
+{
+    const QPair<Post::Field, QString> names[] = {
+        {Post::TitleField, "标题"}, {Post::ContentField, "正文"}, {Post::ExcerptField, "摘要"},
+        {Post::PublishDateField, "发布日期"}, {Post::AuthorField, "作者"}, {Post::StatusField, "状态"},
+        {Post::FeaturedImageField, "特色图片"}, {Post::TermsField, "分类和标签"}
+    };
+    QStringList result;
+    for (const auto& name : names) {
+        if (fields & name.first) {
+            result << name.second;
+        }
+    }
+    return result.join("、");
+}
+
+}
 
 BlogClient::BlogClient(QWidget *parent)
-    : QMainWindow(parent), m_isEditing(false)
+    : QMainWindow(parent), m_isEditing(false), m_autosaveTimer(new QTimer(this)), m_loadingEditor(false),
+      m_siteCombo(nullptr)
 {
     ui.setupUi(this);
     
     // 输出QSettings的文件路径和组织/应用信息
-    qDebug() << "QSettings组织名:" << QCoreApplication::organizationName();
-    qDebug() << "QSettings应用名:" << QCoreApplication::applicationName();
-    
-    // 连接WordPressAPI的信号
-    connect(&WordPressAPI::instance(), &WordPressAPI::postsReceived, this, &BlogClient::onPostsReceived);
-    connect(&WordPressAPI::instance(), &WordPressAPI::postCreated, this, &BlogClient::onPostCreated);
-    connect(&WordPressAPI::instance(), &WordPressAPI::postUpdated, this, &BlogClient::onPostUpdated);
-    connect(&WordPressAPI::instance(), &WordPressAPI::postDeleted, this, &BlogClient::onPostDeleted);
-    connect(&WordPressAPI::instance(), &WordPressAPI::categoriesReceived, this, &BlogClient::onCategoriesReceived);
-    connect(&WordPressAPI::instance(), &WordPressAPI::tagsReceived, this, &BlogClient::onTagsReceived);
-    connect(&WordPressAPI::instance(), &WordPressAPI::mediaUploaded, this, &BlogClient::onMediaUploaded);
-    connect(&WordPressAPI::instance(), &WordPressAPI::error, this, &BlogClient::onApiError);
+    qCDebug(lcUi) << "QSettings组织名:" << QCoreApplication::organizationName();
+    qCDebug(lcUi) << "QSettings应用名:" << QCoreApplication::applicationName();
     
     // 允许窗口自由调整大小
     this->setMinimumSize(640, 480);
@@ -90,7 +120,7 @@ BlogClient::BlogClient(QWidget *parent)
     // 检查标题栏是否存在且正确显示，如果找不到则手动创建
     QLineEdit* titleEdit = ui.editorContainer->findChild<QLineEdit*>("titleEdit");
     if (!titleEdit) {
-        qDebug() << "标题输入框未找到，正在创建新的标题栏...";
+        qCDebug(lcUi) << "标题输入框未找到，正在创建新的标题栏...";
         
         // 创建新的标题栏布局
         QHBoxLayout* titleLayout = new QHBoxLayout();
@@ -114,7 +144,7 @@ BlogClient::BlogClient(QWidget *parent)
         // 将标题编辑框赋值给UI成员变量
         ui.titleEdit = titleEdit;
     } else {
-        qDebug() << "找到标题输入框";
+        qCDebug(lcUi) << "找到标题输入框";
         titleEdit->setEnabled(true);
         titleEdit->setPlaceholderText(tr("请在此输入文章标题"));
     }
@@ -122,26 +152,47 @@ BlogClient::BlogClient(QWidget *parent)
     // 确保UI中分类和标签的按钮正确设置
     setupAddButtons();
     
+    // 自动保存：只有用户的编辑会标记字段，程序填充编辑器时由m_loadingEditor屏蔽
+    m_autosaveTimer->setSingleShot(true);
+    connect(m_autosaveTimer, &QTimer::timeout, this, &BlogClient::autosave);
+    connect(ui.titleEdit, &QLineEdit::textEdited, this, [this]() { markDirty(Post::TitleField); });
+    connect(ui.contentEdit, &QPlainTextEdit::textChanged, this, [this]() { markDirty(Post::ContentField); });
+    connect(ui.excerptEdit, &QLineEdit::textEdited, this, [this]() { markDirty(Post::ExcerptField); });
+    connect(ui.publishDateEdit, &QDateTimeEdit::dateTimeChanged, this, [this]() { markDirty(Post::PublishDateField); });
+    connect(ui.authorEdit, &QLineEdit::textEdited, this, [this]() { markDirty(Post::AuthorField); });
+    connect(ui.featuredImageUrlEdit, &QLineEdit::textEdited, this, [this]() { markDirty(Post::FeaturedImageField); });
+    connect(ui.isDraftCheckBox, &QCheckBox::toggled, this, [this]() { markDirty(Post::StatusField); });
+    connect(&DatabaseWorker::instance(), &DatabaseWorker::postSaved, this, &BlogClient::onAutosaved);
+    
+    setupSiteSelector();
+    
     // 清空编辑器
     clearEditor();
+    
+    // 启动时预热到已配置站点的连接，第一次获取文章时无需再等待完整的TLS握手
+    SiteProfile site = SiteProfiles::current();
+    if (!site.apiUrl.isEmpty()) {
+        WordPressAPI::instance().setApiUrl(site.apiUrl);
+        WordPressAPI::instance().setCredentials(site.username, site.password);
+        WordPressAPI::instance().warmUp();
+    }
 }
 
 BlogClient::~BlogClient()
 {
-    // 断开所有WordPressAPI的信号连接
-    disconnect(&WordPressAPI::instance(), nullptr, this, nullptr);
-    
     // 确保当前文章对象正确释放
     m_currentPost.reset();
     
-    // 关闭数据库连接
+    // 先结束后台写入线程，再关闭数据库连接
+    DatabaseWorker::instance().stop();
     DatabaseManager::instance().close();
 }
 
 void BlogClient::on_actionNew_triggered()
 {
-    // 如果当前有未保存的更改，提示保存
-    if (m_currentPost && !m_isEditing) {
+    // 先写入待自动保存的修改，仍未保存的（例如没有标题）提示保存
+    flushAutosave();
+    if (m_currentPost && m_dirtyFields) {
         QMessageBox::StandardButton result = QMessageBox::question(this, tr("保存更改"),
             tr("您有未保存的更改。是否保存？"),
             QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
@@ -164,8 +215,10 @@ void BlogClient::on_actionNew_triggered()
     m_currentPost->setPublishDate(QDateTime::currentDateTime());
     
     // 更新UI
+    m_loadingEditor = true;
     ui.isDraftCheckBox->setChecked(true);
     ui.publishDateEdit->setDateTime(QDateTime::currentDateTime());
+    m_loadingEditor = false;
     
     // 确保标题输入框是启用的并可以编辑
     QLineEdit* titleEdit = findChild<QLineEdit*>("titleEdit");
@@ -174,7 +227,7 @@ void BlogClient::on_actionNew_triggered()
         titleEdit->setFocus();
         titleEdit->setPlaceholderText(tr("请在此输入文章标题"));
     } else {
-        qDebug() << "警告: 找不到标题输入控件";
+        qCWarning(lcUi) << "警告: 找不到标题输入控件";
     }
     
     // 确保添加按钮设置正确
@@ -205,6 +258,7 @@ void BlogClient::on_actionOpen_triggered()
     }
     
     if (currentItem) {
+        flushAutosave();
         int postId = currentItem->data(Qt::UserRole).toInt();
         Post post = DatabaseManager::instance().getPostById(postId);
         populateEditor(post);
@@ -233,12 +287,12 @@ void BlogClient::on_actionPublish_triggered()
 
 void BlogClient::on_actionFetch_triggered()
 {
-    QSettings settings;
-    QString apiUrl = settings.value("api/url").toString();
-    QString username = settings.value("api/username").toString();
-    QString password = settings.value("api/password").toString();
+    SiteProfile site = SiteProfiles::current();
+    QString apiUrl = site.apiUrl;
+    QString username = site.username;
+    QString password = site.password;
     
-    qDebug() << "API设置：" << apiUrl << username << (password.isEmpty() ? "密码为空" : "密码已设置");
+    qCDebug(lcUi) << "API设置：" << apiUrl << username << (password.isEmpty() ? "密码为空" : "密码已设置");
     
     if (apiUrl.isEmpty() || username.isEmpty() || password.isEmpty()) {
         QMessageBox::warning(this, tr("API设置缺失"), 
@@ -262,11 +316,34 @@ void BlogClient::on_actionFetch_triggered()
     WordPressAPI::instance().setCredentials(username, password);
     
     // 获取远程文章
-    WordPressAPI::instance().fetchPosts();
+    ApiReply* postsReply = WordPressAPI::instance().fetchPosts();
+    connect(postsReply, &ApiReply::finished, this, [this, postsReply]() {
+        if (postsReply->hasError()) {
+            onApiError(postsReply->errorString());
+            return;
+        }
+        onPostsReceived(postsReply->posts());
+        reconcileDeletedPosts();
+    });
     
     // 获取分类和标签
-    WordPressAPI::instance().fetchCategories();
-    WordPressAPI::instance().fetchTags();
+    ApiReply* categoriesReply = WordPressAPI::instance().fetchCategories();
+    connect(categoriesReply, &ApiReply::finished, this, [this, categoriesReply]() {
+        if (categoriesReply->hasError()) {
+            onApiError(categoriesReply->errorString());
+            return;
+        }
+        onCategoriesReceived(categoriesReply->categories());
+    });
+    
+    ApiReply* tagsReply = WordPressAPI::instance().fetchTags();
+    connect(tagsReply, &ApiReply::finished, this, [this, tagsReply]() {
+        if (tagsReply->hasError()) {
+            onApiError(tagsReply->errorString());
+            return;
+        }
+        onTagsReceived(tagsReply->tags());
+    });
     
     // 更新分类和标签列表
     updateCategoriesList();
@@ -281,10 +358,13 @@ void BlogClient::on_actionSync_triggered()
         return;
     }
     
-    QSettings settings;
-    QString apiUrl = settings.value("api/url").toString();
-    QString username = settings.value("api/username").toString();
-    QString password = settings.value("api/password").toString();
+    // 先写入编辑器中未保存的修改，推送和合并都以数据库中的最新版本为准
+    flushAutosave();
+    
+    SiteProfile site = SiteProfiles::current();
+    QString apiUrl = site.apiUrl;
+    QString username = site.username;
+    QString password = site.password;
     
     if (apiUrl.isEmpty() || username.isEmpty() || password.isEmpty()) {
         QMessageBox::warning(this, tr("API设置缺失"), 
@@ -296,19 +376,166 @@ void BlogClient::on_actionSync_triggered()
     WordPressAPI::instance().setApiUrl(apiUrl);
     WordPressAPI::instance().setCredentials(username, password);
     
+    // 记录发起请求时的本地ID，回调时当前文章可能已经切换
+    int localId = m_currentPost->id();
+    
     // 同步当前文章到WordPress
     if (m_currentPost->hasRemoteId() && m_currentPost->status() == Post::Published) {
         // 有远程ID且已发布，执行更新
-        qDebug() << "更新远程文章: 本地ID=" << m_currentPost->id() << "远程ID=" << m_currentPost->remoteId();
-        WordPressAPI::instance().updatePost(*m_currentPost);
+        Post post = *m_currentPost;
+        
+        // 本地有修改时先获取远程的当前版本：远程在上次同步后也被修改过时先合并，不直接覆盖
+        PostSchema::FieldHashes synced = DatabaseManager::instance().syncedHashes(localId);
+        if (synced.isEmpty() || !PostSchema::changedSince(synced, post)) {
+            pushUpdate(localId, post);
+            return;
+        }
+        
+        qCDebug(lcUi) << "检查远程文章是否被修改: 本地ID=" << localId << "远程ID=" << post.remoteId();
+        ApiReply* remoteReply = WordPressAPI::instance().fetchPost(post.remoteId());
+        connect(remoteReply, &ApiReply::finished, this, [this, remoteReply, post]() {
+            if (remoteReply->hasError()) {
+                onApiError(remoteReply->errorString());
+                return;
+            }
+            if (remoteReply->posts().isEmpty()) {
+                QMessageBox::warning(this, tr("同步错误"),
+                    tr("远程文章已不存在。"));
+                return;
+            }
+            
+            SyncMerge::Result result = SyncMerge::prepareUpdate(post, remoteReply->posts().first(), this,
+                [this, post](const SyncMerge::Result& merged) {
+                    onUpdatePrepared(post, merged);
+                });
+            if (result.outcome != SyncMerge::Pending) {
+                onUpdatePrepared(post, result);
+            }
+        });
     } else {
         // 无远程ID或者是草稿，执行创建
-        qDebug() << "创建远程文章: 本地ID=" << m_currentPost->id();
+        qCDebug(lcUi) << "创建远程文章: 本地ID=" << localId;
         // 如果是草稿，先将其状态改为已发布
         Post postCopy = *m_currentPost;
         postCopy.setStatus(Post::Published);
-        WordPressAPI::instance().createPost(postCopy);
+        ApiReply* reply = WordPressAPI::instance().createPost(postCopy);
+        connect(reply, &ApiReply::finished, this, [this, reply, localId]() {
+            if (reply->hasError()) {
+                onApiError(reply->errorString());
+                return;
+            }
+            onPostCreated(localId, reply->post());
+        });
+    }
+}
+
+void BlogClient::pushUpdate(int localId, const Post& post)
+{
+    qCDebug(lcUi) << "更新远程文章: 本地ID=" << localId << "远程ID=" << post.remoteId();
+    ApiReply* reply = WordPressAPI::instance().updatePost(post, DatabaseManager::instance().unsyncedFields(post));
+    connect(reply, &ApiReply::finished, this, [this, reply, localId]() {
+        if (reply->hasError()) {
+            onApiError(reply->errorString());
+            return;
+        }
+        if (reply->isUnchanged()) {
+            QMessageBox::information(this, tr("无需更新"),
+                tr("文章自上次同步后没有修改，未发送更新。"));
+            return;
+        }
+        onPostUpdated(localId, reply->post());
+    });
+}
+
+void BlogClient::onUpdatePrepared(const Post& local, const SyncMerge::Result& result)
+{
+    int localId = local.id();
+    bool isCurrent = m_currentPost && m_currentPost->id() == localId;
+    
+    switch (result.outcome) {
+    case SyncMerge::KeptLocal:
+        // 远程自上次同步后没有修改
+        pushUpdate(localId, local);
+        break;
+    case SyncMerge::Merged:
+        // 合并期间编辑器中又有修改时不能用合并结果覆盖编辑器
+        if (isCurrent && m_dirtyFields) {
+            mergeEditorChanges(local, result.post);
+            break;
+        }
+        // 合并结果已保存到本地，只推送本地修改的部分
+        if (isCurrent) {
+            *m_currentPost = result.post;
+            populateEditor(result.post);
+        }
+        updatePostListItem(result.post);
+        pushUpdate(localId, result.post);
+        break;
+    case SyncMerge::Conflict: {
+        QMessageBox box(QMessageBox::Warning, tr("同步冲突"),
+            tr("这篇文章在上次同步后也在WordPress中被修改过，以下内容无法自动合并：%1\n\n"
+               "保留本地版本会覆盖远程的修改；使用远程版本会放弃本地的修改。")
+                .arg(fieldNames(result.conflicts)),
+            QMessageBox::Cancel, this);
+        QPushButton* keepLocalButton = box.addButton(tr("保留本地版本"), QMessageBox::AcceptRole);
+        QPushButton* useRemoteButton = box.addButton(tr("使用远程版本"), QMessageBox::DestructiveRole);
+        box.exec();
+        
+        if (box.clickedButton() == keepLocalButton) {
+            SyncMerge::acceptLocal(localId, result.post);
+            pushUpdate(localId, local);
+        } else if (box.clickedButton() == useRemoteButton) {
+            SyncMerge::Result saved = SyncMerge::acceptRemote(localId, result.post);
+            if (saved.outcome == SyncMerge::Failed) {
+                QMessageBox::warning(this, tr("同步错误"), tr("保存远程版本失败。"));
+                break;
+            }
+            if (isCurrent) {
+                *m_currentPost = saved.post;
+                populateEditor(saved.post);
+            }
+            updatePostListItem(saved.post);
+        }
+        break;
+    }
+    default:
+        QMessageBox::warning(this, tr("同步错误"), tr("保存合并结果失败。"));
+        break;
+    }
+}
+
+void BlogClient::mergeEditorChanges(const Post& local, const Post& merged)
+{
+    // 编辑器的修改是在local的基础上做的，以local为基线与合并结果再做一次三方合并
+    // 只有合并期间又在编辑时才会走到这里，文章只有一篇，直接在界面线程中合并
+    Post editor = *m_currentPost;
+    readEditorFields(editor, m_dirtyFields);
+    PostMerge::Result merge = PostMerge::merge(local, editor, merged);
+    updatePostListItem(merged);
+    if (merge.conflicts) {
+        // 编辑器保持不变；自动保存会把编辑器的修改写入合并结果，之后再同步时推送
+        QMessageBox::warning(this, tr("同步冲突"),
+            tr("同步期间编辑器中的修改与WordPress中的修改冲突：%1
+
+编辑器中的内容没有改变，请检查后重新同步。")
+                .arg(fieldNames(merge.conflicts)));
+        return;
+    }
+    
+    // 等待已经交给后台线程的自动保存完成，再写入合并结果
+    m_autosaveTimer->stop();
+    DatabaseWorker::instance().waitForIdle();
+    Post post = merge.merged;
+    if (!DatabaseManager::instance().savePost(post)) {
+        QMessageBox::warning(this, tr("同步错误"), tr("保存合并结果失败。"));
+        return;
     }
+    m_dirtyFields = {};
+    m_dirtySince.invalidate();
+    *m_currentPost = post;
+    populateEditor(post);
+    updatePostListItem(post);
+    pushUpdate(post.id(), post);
 }
 
 void BlogClient::on_actionSettings_triggered()
@@ -320,6 +547,122 @@ void BlogClient::on_actionSettings_triggered()
         QSettings settings;
         QString userName = settings.value("user/name").toString();
         ui.authorEdit->setText(userName);
+        
+        // 当前站点在对话框中被删除时切换到剩下的站点，否则使用修改后的站点信息
+        SiteProfile site = SiteProfiles::current();
+        if (site.id != WordPressAPI::currentSession()) {
+            switchSite(site.id);
+        } else {
+            reloadSiteSelector();
+            applyApiSettings();
+        }
+    }
+}
+
+void BlogClient::setupSiteSelector()
+{
+    ui.mainToolBar->addSeparator();
+    ui.mainToolBar->addWidget(new QLabel(tr("站点: "), ui.mainToolBar));
+    m_siteCombo = new QComboBox(ui.mainToolBar);
+    m_siteCombo->setSizeAdjustPolicy(QComboBox::AdjustToContents);
+    ui.mainToolBar->addWidget(m_siteCombo);
+    reloadSiteSelector();
+    
+    // activated只在用户选择时发出，重新填充列表不会触发切换
+    connect(m_siteCombo, QOverload<int>::of(&QComboBox::activated), this, [this](int index) {
+        switchSite(m_siteCombo->itemData(index).toString());
+    });
+}
+
+void BlogClient::reloadSiteSelector()
+{
+    m_siteCombo->clear();
+    for (const SiteProfile& site : SiteProfiles::all()) {
+        m_siteCombo->addItem(site.displayName(), site.id);
+        m_siteCombo->setItemData(m_siteCombo->count() - 1, site.apiUrl, Qt::ToolTipRole);
+    }
+    m_siteCombo->setCurrentIndex(m_siteCombo->findData(WordPressAPI::currentSession()));
+}
+
+void BlogClient::switchSite(const QString& siteId)
+{
+    SiteProfile site = SiteProfiles::find(siteId);
+    if (!site.isValid() || site.id == WordPressAPI::currentSession()) {
+        return;
+    }
+    
+    // 请求的结果会写入发起请求时的站点数据库，完成之前不能切换
+    if (WordPressAPI::instance().inFlightRequests() > 0) {
+        QMessageBox::information(this, tr("切换站点"), tr("当前站点还有未完成的请求，请稍后再切换。"));
+        reloadSiteSelector();
+        return;
+    }
+    
+    // 编辑器中的修改先写入原来站点的数据库，仍未保存的提示保存
+    flushAutosave();
+    if (m_currentPost && m_dirtyFields) {
+        QMessageBox::StandardButton result = QMessageBox::question(this, tr("保存更改"),
+            tr("您有未保存的更改。是否保存？"),
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+            
+        if ((result == QMessageBox::Yes && !saveCurrentPost()) || result == QMessageBox::Cancel) {
+            reloadSiteSelector();
+            return;
+        }
+    }
+    m_autosaveTimer->stop();
+    DatabaseWorker::instance().waitForIdle();
+    
+    QString previousPath = DatabaseManager::instance().databasePath();
+    if (!DatabaseManager::instance().initialize(site.databasePath())) {
+        DatabaseManager::instance().initialize(previousPath);
+        QMessageBox::warning(this, tr("切换站点"), tr("无法打开站点 %1 的数据库。").arg(site.displayName()));
+        reloadSiteSelector();
+        return;
+    }
+    
+    // 每个站点保留自己的API会话，切回来时已经建立的连接可以继续使用
+    SiteProfiles::setCurrent(site.id);
+    WordPressAPI::setCurrentSession(site.id);
+    if (applyApiSettings()) {
+        WordPressAPI::instance().warmUp();
+    }
+    
+    clearEditor();
+    loadPostsList();
+    loadDraftsList();
+    updateCategoriesList();
+    updateTagsList();
+    reloadSiteSelector();
+    
+    qCDebug(lcUi) << "切换到站点" << site.id << "数据库" << site.databasePath();
+    statusBar()->showMessage(tr("已切换到站点 %1").arg(site.displayName()), 3000);
+}
+
+void BlogClient::on_actionStats_triggered()
+{
+    // 显示网络、解析和数据库操作的耗时统计
+    StatsDialog dialog(this);
+    dialog.exec();
+}
+
+void BlogClient::on_actionRevisions_triggered()
+{
+    if (!m_currentPost || m_currentPost->id() <= 0) {
+        QMessageBox::information(this, tr("提示"), tr("请先打开或保存一篇文章"));
+        return;
+    }
+    
+    // 选中的修订恢复到编辑器中，之后和普通编辑一样自动保存；手动保存时成为一个新的修订
+    RevisionsDialog dialog(m_currentPost->id(), this);
+    if (dialog.exec() == QDialog::Accepted) {
+        Post post = DatabaseManager::instance().getRevision(m_currentPost->id(), dialog.selectedRevision());
+        if (post.id() <= 0) {
+            QMessageBox::warning(this, tr("恢复失败"), tr("无法还原所选的修订。"));
+            return;
+        }
+        populateEditor(post);
+        markDirty(Post::AllFields);
     }
 }
 
@@ -336,6 +679,8 @@ void BlogClient::on_actionAbout_triggered()
 void BlogClient::on_postsListWidget_itemClicked(QListWidgetItem *item)
 {
     if (item) {
+        // 切换文章之前写入上一篇的修改（点击的是同一篇时也能读到最新内容）
+        flushAutosave();
         int postId = item->data(Qt::UserRole).toInt();
         Post post = DatabaseManager::instance().getPostById(postId);
         populateEditor(post);
@@ -345,12 +690,24 @@ void BlogClient::on_postsListWidget_itemClicked(QListWidgetItem *item)
 void BlogClient::on_draftsListWidget_itemClicked(QListWidgetItem *item)
 {
     if (item) {
+        // 切换文章之前写入上一篇的修改（点击的是同一篇时也能读到最新内容）
+        flushAutosave();
         int postId = item->data(Qt::UserRole).toInt();
         Post post = DatabaseManager::instance().getPostById(postId);
         populateEditor(post);
     }
 }
 
+void BlogClient::on_postsListWidget_customContextMenuRequested(const QPoint& pos)
+{
+    showBulkMenu(ui.postsListWidget, pos);
+}
+
+void BlogClient::on_draftsListWidget_customContextMenuRequested(const QPoint& pos)
+{
+    showBulkMenu(ui.draftsListWidget, pos);
+}
+
 void BlogClient::on_saveButton_clicked()
 {
     saveCurrentPost();
@@ -368,8 +725,9 @@ void BlogClient::on_publishButton_clicked()
 
 void BlogClient::on_cancelButton_clicked()
 {
-    // 如果有未保存的更改，提示保存
-    if (m_currentPost && !m_isEditing) {
+    // 先写入待自动保存的修改，仍未保存的提示保存
+    flushAutosave();
+    if (m_currentPost && m_dirtyFields) {
         QMessageBox::StandardButton result = QMessageBox::question(this, tr("保存更改"),
             tr("您有未保存的更改。是否保存？"),
             QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
@@ -409,11 +767,11 @@ void BlogClient::on_addCategoryButton_clicked()
         // 更新当前文章
         if (m_currentPost) {
             m_currentPost->addCategory(category);
-            qDebug() << "已添加分类：" << category;
+            qCDebug(lcUi) << "已添加分类：" << category;
         }
         
-        // 立即保存以更新数据库
-        saveCurrentPost();
+        // 和其他修改一起自动保存
+        markDirty(Post::TermsField);
     } else {
         QMessageBox::information(this, tr("提示"), tr("请先在分类框中输入分类名称"));
     }
@@ -432,6 +790,7 @@ void BlogClient::on_removeCategoryButton_clicked()
         if (m_currentPost) {
             m_currentPost->removeCategory(category);
         }
+        markDirty(Post::TermsField);
     }
 }
 
@@ -457,11 +816,11 @@ void BlogClient::on_addTagButton_clicked()
         // 更新当前文章
         if (m_currentPost) {
             m_currentPost->addTag(tag);
-            qDebug() << "已添加标签：" << tag;
+            qCDebug(lcUi) << "已添加标签：" << tag;
         }
         
-        // 立即保存以更新数据库
-        saveCurrentPost();
+        // 和其他修改一起自动保存
+        markDirty(Post::TermsField);
     } else {
         QMessageBox::information(this, tr("提示"), tr("请先在标签框中输入标签名称"));
     }
@@ -480,6 +839,7 @@ void BlogClient::on_removeTagButton_clicked()
         if (m_currentPost) {
             m_currentPost->removeTag(tag);
         }
+        markDirty(Post::TermsField);
     }
 }
 
@@ -490,10 +850,10 @@ void BlogClient::on_uploadImageButton_clicked()
         tr("图片文件 (*.png *.jpg *.jpeg *.gif)"));
         
     if (!filePath.isEmpty()) {
-        QSettings settings;
-        QString apiUrl = settings.value("api/url").toString();
-        QString username = settings.value("api/username").toString();
-        QString password = settings.value("api/password").toString();
+        SiteProfile site = SiteProfiles::current();
+        QString apiUrl = site.apiUrl;
+        QString username = site.username;
+        QString password = site.password;
         
         if (apiUrl.isEmpty() || username.isEmpty() || password.isEmpty()) {
             QMessageBox::warning(this, tr("API设置缺失"), 
@@ -524,24 +884,6 @@ void BlogClient::on_uploadImageButton_clicked()
         progressDialog->setValue(0);
         progressDialog->show();
         
-        // 连接上传进度信号
-        connect(&WordPressAPI::instance(), &WordPressAPI::uploadProgress, this, 
-            [progressDialog](qint64 bytesSent, qint64 bytesTotal) {
-                if (bytesTotal > 0 && progressDialog) {
-                    int percent = (int)((100.0 * bytesSent) / bytesTotal);
-                    progressDialog->setValue(percent);
-                }
-            });
-        
-        // 连接取消按钮
-        connect(progressDialog, &QProgressDialog::canceled, this, 
-            [this, progressDialog]() {
-                // 通知用户上传已取消
-                QMessageBox::information(this, tr("上传取消"), 
-                    tr("图片上传已取消"));
-                progressDialog->deleteLater();
-            });
-        
         // 设置API信息
         WordPressAPI::instance().setApiUrl(apiUrl);
         WordPressAPI::instance().setCredentials(username, password);
@@ -552,70 +894,280 @@ void BlogClient::on_uploadImageButton_clicked()
             title = fileInfo.baseName(); // 使用文件名作为标题
         }
         
-        // 在上传完成后自动关闭进度对话框
-        auto connectionSuccess = connect(&WordPressAPI::instance(), &WordPressAPI::mediaUploaded, this, 
-            [progressDialog]() {
-                if (progressDialog) {
-                    progressDialog->setValue(100);
-                    progressDialog->deleteLater();
-                }
-            }, Qt::SingleShotConnection);
+        // 记录发起上传时的本地文章ID，上传完成时只更新这篇文章
+        int localId = m_currentPost ? m_currentPost->id() : -1;
+        
+        ApiReply* reply = WordPressAPI::instance().uploadMedia(filePath, title);
         
-        auto connectionError = connect(&WordPressAPI::instance(), &WordPressAPI::error, this, 
-            [progressDialog, this](const QString &errorMsg) {
-                if (progressDialog) {
-                    progressDialog->deleteLater();
+        // 连接上传进度信号
+        connect(reply, &ApiReply::uploadProgress, progressDialog, 
+            [progressDialog](qint64 bytesSent, qint64 bytesTotal) {
+                if (bytesTotal > 0) {
+                    int percent = (int)((100.0 * bytesSent) / bytesTotal);
+                    progressDialog->setValue(percent);
                 }
-                // 错误消息已经由onApiError处理
-            }, Qt::SingleShotConnection);
+            });
         
-        // 上传图片
-        WordPressAPI::instance().uploadMedia(filePath, title);
+        // 连接取消按钮，取消时中止本次上传
+        connect(progressDialog, &QProgressDialog::canceled, reply, [reply]() {
+            reply->abort();
+        });
+        
+        // 上传完成（成功、失败或取消）后关闭进度对话框
+        connect(reply, &ApiReply::finished, this, [this, reply, progressDialog, localId]() {
+            bool canceled = progressDialog->wasCanceled();
+            progressDialog->setValue(100);
+            progressDialog->deleteLater();
+            
+            if (canceled) {
+                // 通知用户上传已取消
+                QMessageBox::information(this, tr("上传取消"), 
+                    tr("图片上传已取消"));
+            } else if (reply->hasError()) {
+                onApiError(reply->errorString());
+            } else {
+                onMediaUploaded(localId, reply->mediaUrl(), reply->mediaId());
+            }
+        });
     }
 }
 
 void BlogClient::onPostsReceived(const QList<Post>& posts)
 {
-    qDebug() << "从API接收到 " << posts.size() << " 篇文章，开始保存到数据库...";
+    TraceSpan span("ui.onPostsReceived");
+    span.addRows(posts.size());
+
+    qCDebug(lcUi) << "从API接收到 " << posts.size() << " 篇文章，开始保存到数据库...";
+    
+    // 两边都修改过的文章在后台合并，全部完成后一起报告冲突
+    struct MergeState
+    {
+        int pending = 0;
+        int merged = 0;
+        QStringList conflicts;
+    };
+    auto merges = std::make_shared<MergeState>();
+    auto reportMerges = [this, merges]() {
+        if (!merges->conflicts.isEmpty()) {
+            QMessageBox::warning(this, tr("同步冲突"),
+                tr("以下文章在本地和WordPress中都有修改，无法自动合并，保留了本地版本：\n\n%1\n\n"
+                   "同步这些文章时可以选择保留本地版本或使用远程版本。")
+                    .arg(merges->conflicts.join("\n")));
+        } else if (merges->merged > 0) {
+            statusBar()->showMessage(tr("已自动合并 %1 篇文章").arg(merges->merged), 5000);
+        }
+    };
+    auto addConflict = [this, merges](const SyncMerge::Result& result) {
+        merges->conflicts << tr("%1（%2）").arg(result.post.title(), fieldNames(result.conflicts));
+    };
     
-    // 保存文章到本地数据库
+    // 保存文章到本地数据库；与已有内容相同的文章不写入，也不刷新列表项
+    // 本地有未同步修改的文章不会被覆盖：远程没有修改时保留本地版本，远程也修改过时与本地修改合并
     int savedCount = 0;
+    int insertedCount = 0;
+    int keptCount = 0;
+    QList<Post> changedPosts;
     for (const Post& post : posts) {
-        Post localPost = post;
-        qDebug() << "处理文章: ID=" << post.id() << "标题=" << post.title() << "状态=" << post.status();
+        qCDebug(lcUi) << "处理文章: ID=" << post.id() << "标题=" << post.title() << "状态=" << post.status();
+        
+        SyncMerge::Result result = SyncMerge::saveRemote(post, this,
+            [this, merges, reportMerges, addConflict](const SyncMerge::Result& merged) {
+                if (merged.outcome == SyncMerge::Merged) {
+                    ++merges->merged;
+                    updatePostListItem(merged.post);
+                    // 编辑器中是这篇文章且没有未保存的修改时显示合并结果
+                    if (m_currentPost && m_currentPost->id() == merged.post.id() && !m_dirtyFields) {
+                        *m_currentPost = merged.post;
+                        populateEditor(merged.post);
+                    }
+                } else if (merged.outcome == SyncMerge::Conflict) {
+                    addConflict(merged);
+                }
+                if (--merges->pending == 0) {
+                    reportMerges();
+                }
+            });
         
-        if (DatabaseManager::instance().savePost(localPost)) {
+        switch (result.outcome) {
+        case SyncMerge::Inserted:
+            savedCount++;
+            insertedCount++;
+            break;
+        case SyncMerge::Updated:
             savedCount++;
+            changedPosts.append(result.post);
+            break;
+        case SyncMerge::Unchanged:
+            savedCount++;
+            break;
+        case SyncMerge::KeptLocal:
+            keptCount++;
+            break;
+        case SyncMerge::Pending:
+            merges->pending++;
+            break;
+        case SyncMerge::Conflict:
+            addConflict(result);
+            break;
+        default:
+            qCWarning(lcUi) << "保存文章失败: ID=" << post.id() << "标题=" << post.title();
+            break;
+        }
+    }
+    
+    qCDebug(lcUi) << "成功保存 " << savedCount << " 篇文章到数据库，新增" << insertedCount
+                  << "篇，更新" << changedPosts.size() << "篇，保留本地修改" << keptCount
+                  << "篇，合并" << merges->pending << "篇";
+    
+    // 有新文章时需要按日期重新排列，整体重新加载；否则只更新内容变化的列表项
+    if (insertedCount > 0) {
+        loadPostsList();
+        loadDraftsList();
+    } else {
+        for (const Post& post : changedPosts) {
+            updatePostListItem(post);
+        }
+    }
+    span.finish();
+    
+    QString message = tr("成功获取了 %1 篇文章，其中新增 %2 篇，更新 %3 篇。")
+                          .arg(savedCount).arg(insertedCount).arg(changedPosts.size());
+    if (keptCount > 0) {
+        message += tr("\n%1 篇文章在本地有未同步的修改，保留了本地版本。").arg(keptCount);
+    }
+    if (merges->pending > 0) {
+        message += tr("\n%1 篇文章在本地和远程都有修改，正在后台合并。").arg(merges->pending);
+    }
+    QMessageBox::information(this, tr("获取成功"), message);
+    
+    if (merges->pending == 0) {
+        reportMerges();
+    }
+}
+
+struct BlogClient::IndexState
+{
+    QList<PostIndex::Stamp> stamps;
+    int remoteTotal = -1;       // 第一页报告的远程文章总数，未知时为-1
+    int pending = 0;            // 进行中的索引请求
+    bool failed = false;
+    bool changed = false;       // 获取期间远程文章总数发生了变化
+    QString databasePath;       // 开始时的数据库，期间切换了站点时不处理结果
+};
+
+void BlogClient::reconcileDeletedPosts()
+{
+    auto state = std::make_shared<IndexState>();
+    state->databasePath = DatabaseManager::instance().databasePath();
+    requestIndexPage(1, state);
+}
+
+void BlogClient::requestIndexPage(int page, const std::shared_ptr<IndexState>& state)
+{
+    const int perPage = 100;
+    ++state->pending;
+    ApiReply* reply = WordPressAPI::instance().fetchPostIndex(page, perPage);
+    connect(reply, &ApiReply::finished, this, [this, reply, state, page, perPage]() {
+        --state->pending;
+        
+        if (reply->hasError()) {
+            qCWarning(lcUi) << "获取远程文章索引失败: 第" << page << "页" << reply->errorString();
+            state->failed = true;
         } else {
-            qDebug() << "保存文章失败: ID=" << post.id() << "标题=" << post.title();
+            QList<Post> posts = reply->posts();
+            // 按页码分页时，获取期间有文章新增或删除会使后面的页错位，可能漏掉文章
+            if (reply->totalItems() >= 0) {
+                if (state->remoteTotal >= 0 && reply->totalItems() != state->remoteTotal) {
+                    state->changed = true;
+                }
+                state->remoteTotal = reply->totalItems();
+            }
+            for (const Post& post : posts) {
+                PostIndex::Stamp stamp;
+                stamp.remoteId = post.remoteId();
+                stamp.modified = post.remoteModified();
+                state->stamps.append(stamp);
+            }
+            
+            // 第一页返回总页数后其余页一起请求；没有分页头时逐页请求，直到某页不满为止
+            if (page == 1 && reply->totalPages() >= 0) {
+                for (int next = 2; next <= reply->totalPages(); ++next) {
+                    requestIndexPage(next, state);
+                }
+            } else if (reply->totalPages() < 0 && posts.size() >= perPage) {
+                requestIndexPage(page + 1, state);
+            }
         }
+        
+        if (state->pending == 0) {
+            finishReconcile(*state);
+        }
+    });
+}
+
+void BlogClient::finishReconcile(const IndexState& state)
+{
+    if (DatabaseManager::instance().databasePath() != state.databasePath) {
+        return;
     }
     
-    qDebug() << "成功保存 " << savedCount << " 篇文章到数据库";
+    // 列表不完整时无法判断哪些文章在远程已经删除
+    bool complete = !state.failed && !state.changed
+                    && (state.remoteTotal < 0 || state.stamps.size() == state.remoteTotal);
+    if (!complete) {
+        statusBar()->showMessage(tr("未能获取完整的远程文章列表，没有删除本地文章"), 5000);
+        return;
+    }
     
-    // 更新列表
-    loadPostsList();
-    loadDraftsList();
+    PostIndex::Diff diff = PostIndex::compare(state.stamps, DatabaseManager::instance().getPostStamps());
+    if (diff.deleted.isEmpty()) {
+        return;
+    }
     
-    QMessageBox::information(this, tr("获取成功"), 
-        tr("成功获取并保存了 %1 篇文章。").arg(savedCount));
+    // 编辑器中的修改先写入，删除时按最新的本地版本判断有没有未同步的修改
+    flushAutosave();
+    SyncMerge::Removal removal = SyncMerge::removeDeleted(diff.deleted);
+    
+    if (!removal.deleted.isEmpty()) {
+        if (m_currentPost && removal.deleted.contains(m_currentPost->id())) {
+            clearEditor();
+        }
+        loadPostsList();
+        loadDraftsList();
+        statusBar()->showMessage(tr("已删除 %1 篇在远程已删除的文章").arg(removal.deleted.size()), 5000);
+    }
+    
+    if (!removal.conflicts.isEmpty() || !removal.failed.isEmpty()) {
+        QStringList messages;
+        if (!removal.conflicts.isEmpty()) {
+            QStringList titles;
+            for (int id : removal.conflicts) {
+                titles << DatabaseManager::instance().getPostById(id).title();
+            }
+            messages << tr("%1 篇文章在远程已删除，但本地有未同步的修改，已保留：\n%2")
+                            .arg(removal.conflicts.size()).arg(titles.mid(0, 10).join("\n"));
+        }
+        if (!removal.failed.isEmpty()) {
+            messages << tr("%1 篇远程已删除的文章从本地删除失败。").arg(removal.failed.size());
+        }
+        QMessageBox::warning(this, tr("远程已删除的文章"), messages.join("\n\n"));
+    }
 }
 
-void BlogClient::onPostCreated(const Post& post)
+void BlogClient::onPostCreated(int localId, const Post& post)
 {
-    // 保存到本地数据库并设置远程ID
+    // 保存到本地数据库并设置远程ID，使用发起请求时的本地ID
     Post localPost = post;
-    if (m_currentPost) {
-        // 如果有当前文章，使用其本地ID，并设置远程ID
-        localPost.setId(m_currentPost->id());
-        qDebug() << "为当前文章设置远程ID: " << post.remoteId();
-    }
+    localPost.setId(localId);
+    qCDebug(lcUi) << "为本地文章" << localId << "设置远程ID: " << post.remoteId();
     
-    // 保存到数据库
-    DatabaseManager::instance().savePost(localPost);
+    // 保存到数据库，并记录为已同步的状态
+    if (DatabaseManager::instance().savePost(localPost)) {
+        DatabaseManager::instance().markSynced(localPost);
+    }
     
-    // 更新当前文章
-    if (m_currentPost) {
+    // 如果编辑器中仍是这篇文章，同步更新
+    if (m_currentPost && m_currentPost->id() == localId) {
         m_currentPost->setRemoteId(post.remoteId());
     }
     
@@ -627,23 +1179,20 @@ void BlogClient::onPostCreated(const Post& post)
         tr("文章已成功发布到WordPress。\n远程ID: %1").arg(post.remoteId()));
 }
 
-void BlogClient::onPostUpdated(const Post& post)
+void BlogClient::onPostUpdated(int localId, const Post& post)
 {
-    // 保存到本地数据库
+    // 保存到本地数据库，保持本地ID，但更新远程ID和其他信息
     Post localPost = post;
+    localPost.setId(localId);
+    qCDebug(lcUi) << "更新文章: 本地ID=" << localId << "远程ID=" << post.remoteId();
     
-    if (m_currentPost) {
-        // 保持本地ID，但更新远程ID和其他信息
-        localPost.setId(m_currentPost->id());
-        qDebug() << "更新文章: 本地ID=" << m_currentPost->id() << "远程ID=" << post.remoteId();
+    // 保存到数据库，并记录为已同步的状态
+    if (DatabaseManager::instance().savePost(localPost)) {
+        DatabaseManager::instance().markSynced(localPost);
     }
     
-    // 保存到数据库
-    DatabaseManager::instance().savePost(localPost);
-    
-    // 更新当前文章
-    if (m_currentPost) {
-        m_currentPost->setRemoteId(post.remoteId());
+    // 如果编辑器中仍是这篇文章，同步更新
+    if (m_currentPost && m_currentPost->id() == localId) {
         *m_currentPost = localPost;
     }
     
@@ -655,28 +1204,12 @@ void BlogClient::onPostUpdated(const Post& post)
         tr("文章已成功更新到WordPress。\n远程ID: %1").arg(post.remoteId()));
 }
 
-void BlogClient::onPostDeleted(int postId)
-{
-    // 从本地数据库删除
-    DatabaseManager::instance().deletePost(postId);
-    
-    // 更新列表
-    loadPostsList();
-    loadDraftsList();
-    
-    // 清空编辑器
-    clearEditor();
-    
-    QMessageBox::information(this, tr("删除成功"), 
-        tr("文章已成功删除。"));
-}
-
 void BlogClient::onCategoriesReceived(const QList<Category>& categories)
 {
     // 保存分类到本地数据库
-    qDebug() << "接收到" << categories.size() << "个分类";
+    qCDebug(lcUi) << "接收到" << categories.size() << "个分类";
     for (const Category& category : categories) {
-        qDebug() << "保存分类: ID=" << category.id() << "名称=" << category.name();
+        qCDebug(lcUi) << "保存分类: ID=" << category.id() << "名称=" << category.name();
         Category localCategory = category;
         DatabaseManager::instance().saveCategory(localCategory);
     }
@@ -696,9 +1229,9 @@ void BlogClient::onCategoriesReceived(const QList<Category>& categories)
 void BlogClient::onTagsReceived(const QList<Tag>& tags)
 {
     // 保存标签到本地数据库
-    qDebug() << "接收到" << tags.size() << "个标签";
+    qCDebug(lcUi) << "接收到" << tags.size() << "个标签";
     for (const Tag& tag : tags) {
-        qDebug() << "保存标签: ID=" << tag.id() << "名称=" << tag.name();
+        qCDebug(lcUi) << "保存标签: ID=" << tag.id() << "名称=" << tag.name();
         Tag localTag = tag;
         DatabaseManager::instance().saveTag(localTag);
     }
@@ -715,7 +1248,7 @@ void BlogClient::onTagsReceived(const QList<Tag>& tags)
     }
 }
 
-void BlogClient::onMediaUploaded(const QString& url,int mediaId)
+void BlogClient::onMediaUploaded(int localId, const QString& url, int mediaId)
 {
     if (url.isEmpty()) {
         QMessageBox::warning(this, tr("上传错误"), 
@@ -723,6 +1256,14 @@ void BlogClient::onMediaUploaded(const QString& url,int mediaId)
         return;
     }
     
+    // 上传期间切换了文章时，不把图片写到新打开的文章上
+    if (m_currentPost && m_currentPost->id() != localId) {
+        qCWarning(lcUi) << "警告: 上传完成时编辑器中的文章已切换，特色图片URL将不会被保存";
+        QMessageBox::information(this, tr("上传成功"), 
+            tr("图片已成功上传，URL: %1").arg(url));
+        return;
+    }
+    
     // 设置特色图片URL
     ui.featuredImageUrlEdit->setText(url);
     
@@ -733,12 +1274,12 @@ void BlogClient::onMediaUploaded(const QString& url,int mediaId)
         
         // 立即保存更新
         if (DatabaseManager::instance().savePost(*m_currentPost)) {
-            qDebug() << "已更新文章的特色图片URL: " << url;
+            qCDebug(lcUi) << "已更新文章的特色图片URL: " << url;
         } else {
-            qDebug() << "保存特色图片URL失败";
+            qCWarning(lcUi) << "保存特色图片URL失败";
         }
     } else {
-        qDebug() << "警告: 当前没有正在编辑的文章，特色图片URL将不会被保存";
+        qCWarning(lcUi) << "警告: 当前没有正在编辑的文章，特色图片URL将不会被保存";
     }
     
     QMessageBox::information(this, tr("上传成功"), 
@@ -753,6 +1294,8 @@ void BlogClient::onApiError(const QString& errorMessage)
 
 void BlogClient::clearEditor()
 {
+    m_loadingEditor = true;
+    
     // 清空所有输入控件
     QLineEdit* titleEdit = findChild<QLineEdit*>("titleEdit");
     if (titleEdit) {
@@ -760,7 +1303,7 @@ void BlogClient::clearEditor()
         titleEdit->setEnabled(true);
         titleEdit->setPlaceholderText(tr("请在此输入文章标题"));
     } else {
-        qDebug() << "警告: 找不到标题输入控件";
+        qCWarning(lcUi) << "警告: 找不到标题输入控件";
     }
     
     ui.contentEdit->clear();
@@ -790,17 +1333,25 @@ void BlogClient::clearEditor()
     
     m_currentPost.reset();
     m_isEditing = false;
+    
+    // 编辑器中的内容已丢弃，未写入的修改也一并丢弃
+    m_autosaveTimer->stop();
+    m_dirtyFields = {};
+    m_dirtySince.invalidate();
+    m_loadingEditor = false;
 }
 
 void BlogClient::populateEditor(const Post& post)
 {
+    m_loadingEditor = true;
+    
     // 更新编辑器内容
     QLineEdit* titleEdit = findChild<QLineEdit*>("titleEdit");
     if (titleEdit) {
         titleEdit->setText(post.title());
         titleEdit->setEnabled(true);
     } else {
-        qDebug() << "警告: 找不到标题输入控件";
+        qCWarning(lcUi) << "警告: 找不到标题输入控件";
     }
     
     ui.contentEdit->setPlainText(post.content());
@@ -834,15 +1385,21 @@ void BlogClient::populateEditor(const Post& post)
     // 保存当前编辑的文章
     m_currentPost = std::make_unique<Post>(post);
     m_isEditing = true;
+    
+    m_autosaveTimer->stop();
+    m_dirtyFields = {};
+    m_dirtySince.invalidate();
+    m_loadingEditor = false;
 }
 
 void BlogClient::loadPostsList()
 {
+    TraceSpan span("ui.loadPostsList");
     ui.postsListWidget->clear();
     
     QList<Post> posts = DatabaseManager::instance().getAllPosts(true); // 只加载已发布的
     
-    qDebug() << "加载已发布文章：" << posts.size() << "篇";
+    qCDebug(lcUi) << "加载已发布文章：" << posts.size() << "篇";
     
     if (posts.isEmpty()) {
         // 添加提示项
@@ -852,19 +1409,15 @@ void BlogClient::loadPostsList()
         return;
     }
     
+    span.addRows(posts.size());
     for (const Post& post : posts) {
         // 创建更友好的显示格式：标题 (日期)
-        QString displayText = QString("%1 (%2)").arg(
-            post.title().length() > 30 ? post.title().left(30) + "..." : post.title(),
-            post.publishDate().toString("yyyy-MM-dd")
-        );
-        
-        QListWidgetItem* item = new QListWidgetItem(displayText);
+        QListWidgetItem* item = new QListWidgetItem(post.displayText());
         item->setData(Qt::UserRole, post.id());
         item->setToolTip(post.title()); // 当鼠标悬停时显示完整标题
         ui.postsListWidget->addItem(item);
         
-        qDebug() << "添加文章到列表：" << post.id() << post.title();
+        qCDebug(lcUi) << "添加文章到列表：" << post.id() << post.title();
     }
     
     // 确保文章列表有合适的大小
@@ -874,6 +1427,7 @@ void BlogClient::loadPostsList()
 
 void BlogClient::loadDraftsList()
 {
+    TraceSpan span("ui.loadDraftsList");
     ui.draftsListWidget->clear();
     
     QList<Post> posts = DatabaseManager::instance().getAllPosts();
@@ -884,21 +1438,17 @@ void BlogClient::loadDraftsList()
             draftCount++;
             
             // 创建更友好的显示格式：标题 (日期)
-            QString displayText = QString("%1 (%2)").arg(
-                post.title().length() > 30 ? post.title().left(30) + "..." : post.title(),
-                post.publishDate().toString("yyyy-MM-dd")
-            );
-            
-            QListWidgetItem* item = new QListWidgetItem(displayText);
+            QListWidgetItem* item = new QListWidgetItem(post.displayText());
             item->setData(Qt::UserRole, post.id());
             item->setToolTip(post.title()); // 当鼠标悬停时显示完整标题
             ui.draftsListWidget->addItem(item);
             
-            qDebug() << "添加草稿到列表：" << post.id() << post.title();
+            qCDebug(lcUi) << "添加草稿到列表：" << post.id() << post.title();
         }
     }
     
-    qDebug() << "加载草稿：" << draftCount << "篇";
+    qCDebug(lcUi) << "加载草稿：" << draftCount << "篇";
+    span.addRows(draftCount);
     
     if (draftCount == 0) {
         // 添加提示项
@@ -919,9 +1469,9 @@ void BlogClient::updateCategoriesList()
     
     QList<Category> categories = DatabaseManager::instance().getAllCategories();
     
-    qDebug() << "加载所有分类，共" << categories.size() << "个";
+    qCDebug(lcUi) << "加载所有分类，共" << categories.size() << "个";
     for (const Category& category : categories) {
-        qDebug() << "添加分类到下拉列表: ID=" << category.id() << "名称=" << category.name();
+        qCDebug(lcUi) << "添加分类到下拉列表: ID=" << category.id() << "名称=" << category.name();
         ui.categoryCombo->addItem(category.name(), category.id());
     }
     
@@ -937,9 +1487,9 @@ void BlogClient::updateTagsList()
     
     // 创建自动完成器
     QStringList tagNames;
-    qDebug() << "加载所有标签，共" << tags.size() << "个";
+    qCDebug(lcUi) << "加载所有标签，共" << tags.size() << "个";
     for (const Tag& tag : tags) {
-        qDebug() << "添加标签到自动完成列表: ID=" << tag.id() << "名称=" << tag.name();
+        qCDebug(lcUi) << "添加标签到自动完成列表: ID=" << tag.id() << "名称=" << tag.name();
         tagNames << tag.name();
     }
     
@@ -951,6 +1501,10 @@ void BlogClient::updateTagsList()
 
 bool BlogClient::saveCurrentPost()
 {
+    // 手动保存写入所有字段，等后台线程中排队的自动保存完成后再写，避免旧内容覆盖新内容
+    m_autosaveTimer->stop();
+    DatabaseWorker::instance().waitForIdle();
+    
     // 创建或更新文章
     if (!m_currentPost) {
         m_currentPost = std::make_unique<Post>();
@@ -984,6 +1538,9 @@ bool BlogClient::saveCurrentPost()
     // 保存到数据库
     if (DatabaseManager::instance().savePost(*m_currentPost)) {
         m_isEditing = true;
+        m_dirtyFields = {};
+        m_dirtySince.invalidate();
+        DatabaseManager::instance().saveRevision(*m_currentPost);
         
         // 更新列表
         loadPostsList();
@@ -1011,6 +1568,9 @@ bool BlogClient::publishCurrentPost()
     
     // 保存到数据库
     if (DatabaseManager::instance().savePost(*m_currentPost)) {
+        // 记录发布时的版本
+        DatabaseManager::instance().saveRevision(*m_currentPost);
+        
         // 更新列表
         loadPostsList();
         loadDraftsList();
@@ -1038,18 +1598,29 @@ void BlogClient::deleteCurrentPost()
         QMessageBox::Yes | QMessageBox::No);
         
     if (result == QMessageBox::Yes) {
+        // 后台线程中还没写完的自动保存不能在删除之后再写入
+        m_autosaveTimer->stop();
+        DatabaseWorker::instance().waitForIdle();
+        
         // 从数据库删除
         if (DatabaseManager::instance().deletePost(m_currentPost->id())) {
             // 尝试从WordPress删除
-            QSettings settings;
-            QString apiUrl = settings.value("api/url").toString();
-            QString username = settings.value("api/username").toString();
-            QString password = settings.value("api/password").toString();
+            SiteProfile site = SiteProfiles::current();
+            QString apiUrl = site.apiUrl;
+            QString username = site.username;
+            QString password = site.password;
             
-            if (!apiUrl.isEmpty() && !username.isEmpty() && !password.isEmpty()) {
+            // 只有已同步到WordPress的文章才需要删除远程副本（使用远程ID）
+            if (m_currentPost->hasRemoteId() &&
+                !apiUrl.isEmpty() && !username.isEmpty() && !password.isEmpty()) {
                 WordPressAPI::instance().setApiUrl(apiUrl);
                 WordPressAPI::instance().setCredentials(username, password);
-                WordPressAPI::instance().deletePost(m_currentPost->id());
+                ApiReply* reply = WordPressAPI::instance().deletePost(m_currentPost->remoteId());
+                connect(reply, &ApiReply::finished, this, [this, reply]() {
+                    if (reply->hasError()) {
+                        onApiError(reply->errorString());
+                    }
+                });
             }
             
             // 更新列表
@@ -1068,10 +1639,494 @@ void BlogClient::deleteCurrentPost()
     }
 }
 
+void BlogClient::showBulkMenu(QListWidget* list, const QPoint& pos)
+{
+    QList<int> postIds = selectedPostIds(list);
+    if (postIds.isEmpty()) {
+        return;
+    }
+    
+    QMenu menu(this);
+    QAction* publishAction = menu.addAction(tr("发布所选的 %1 篇文章").arg(postIds.size()));
+    QAction* categoriesAction = menu.addAction(tr("修改分类..."));
+    QAction* tagsAction = menu.addAction(tr("修改标签..."));
+    menu.addSeparator();
+    QAction* deleteAction = menu.addAction(tr("删除所选的 %1 篇文章").arg(postIds.size()));
+    
+    QAction* chosen = menu.exec(list->viewport()->mapToGlobal(pos));
+    if (chosen == publishAction) {
+        bulkPublish(postIds);
+    } else if (chosen == categoriesAction) {
+        bulkSetTerms(postIds, true);
+    } else if (chosen == tagsAction) {
+        bulkSetTerms(postIds, false);
+    } else if (chosen == deleteAction) {
+        bulkDelete(postIds);
+    }
+}
+
+QList<int> BlogClient::selectedPostIds(QListWidget* list) const
+{
+    QList<int> postIds;
+    const QList<QListWidgetItem*> items = list->selectedItems();
+    for (QListWidgetItem* item : items) {
+        // "暂无文章"之类的提示项没有文章ID
+        if (item->data(Qt::UserRole).isValid()) {
+            postIds.append(item->data(Qt::UserRole).toInt());
+        }
+    }
+    return postIds;
+}
+
+void BlogClient::prepareBulkEdit()
+{
+    // 编辑器中的修改先写入；后台线程写完之后才能在主连接上开始事务
+    flushAutosave();
+    m_autosaveTimer->stop();
+}
+
+bool BlogClient::applyApiSettings()
+{
+    SiteProfile site = SiteProfiles::current();
+    QString apiUrl = site.apiUrl;
+    QString username = site.username;
+    QString password = site.password;
+    if (apiUrl.isEmpty() || username.isEmpty() || password.isEmpty()) {
+        return false;
+    }
+    
+    WordPressAPI::instance().setApiUrl(apiUrl);
+    WordPressAPI::instance().setCredentials(username, password);
+    return true;
+}
+
+void BlogClient::bulkPublish(const QList<int>& postIds)
+{
+    prepareBulkEdit();
+    
+    // 本地状态在一个事务中改为已发布，任何一篇保存失败时全部回滚
+    QList<Post> posts;
+    QList<Post> changedPosts;
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    for (int postId : postIds) {
+        Post post = DatabaseManager::instance().getPostById(postId);
+        if (post.id() <= 0) {
+            continue;
+        }
+        if (post.status() != Post::Published) {
+            post.setStatus(Post::Published);
+            if (!DatabaseManager::instance().savePost(post)) {
+                db.rollback();
+                QMessageBox::warning(this, tr("发布失败"),
+                    tr("无法保存文章“%1”，所选文章均未修改。").arg(post.title()));
+                return;
+            }
+            changedPosts.append(post);
+        }
+        posts.append(post);
+    }
+    db.commit();
+    if (posts.isEmpty()) {
+        return;
+    }
+    
+    // 记录发布时的版本（事务提交之后，回滚时不会留下修订）
+    for (const Post& post : std::as_const(changedPosts)) {
+        DatabaseManager::instance().saveRevision(post);
+    }
+    
+    loadPostsList();
+    loadDraftsList();
+    if (m_currentPost && postIds.contains(m_currentPost->id())) {
+        populateEditor(DatabaseManager::instance().getPostById(m_currentPost->id()));
+    }
+    
+    if (!applyApiSettings()) {
+        QMessageBox::warning(this, tr("API设置缺失"),
+            tr("%1 篇文章已在本地标记为已发布，请先在设置中配置WordPress API信息再同步。").arg(posts.size()));
+        return;
+    }
+    
+    pushBulkPosts(tr("发布文章"), posts);
+}
+
+void BlogClient::bulkDelete(const QList<int>& postIds)
+{
+    QMessageBox::StandardButton result = QMessageBox::question(this, tr("确认删除"),
+        tr("您确定要删除所选的 %1 篇文章吗？此操作无法撤销。").arg(postIds.size()),
+        QMessageBox::Yes | QMessageBox::No);
+    if (result != QMessageBox::Yes) {
+        return;
+    }
+    
+    // 后台线程中还没写完的自动保存不能在删除之后再写入
+    prepareBulkEdit();
+    
+    QList<QPair<int, int>> remotePosts;
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    for (int postId : postIds) {
+        Post post = DatabaseManager::instance().getPostById(postId);
+        if (!DatabaseManager::instance().deletePost(postId)) {
+            db.rollback();
+            QMessageBox::warning(this, tr("删除失败"),
+                tr("无法删除文章“%1”，所选文章均未删除。").arg(post.title()));
+            return;
+        }
+        if (post.hasRemoteId()) {
+            remotePosts.append(qMakePair(postId, post.remoteId()));
+        }
+    }
+    db.commit();
+    
+    if (m_currentPost && postIds.contains(m_currentPost->id())) {
+        clearEditor();
+    }
+    loadPostsList();
+    loadDraftsList();
+    
+    // 只有已同步到WordPress的文章才需要删除远程副本
+    if (remotePosts.isEmpty() || !applyApiSettings()) {
+        QMessageBox::information(this, tr("删除成功"),
+            tr("已删除 %1 篇文章。").arg(postIds.size()));
+        return;
+    }
+    
+    QList<QPair<int, ApiReply*>> replies;
+    for (const auto& remotePost : std::as_const(remotePosts)) {
+        replies.append(qMakePair(remotePost.first, WordPressAPI::instance().deletePost(remotePost.second)));
+    }
+    trackBulkReplies(tr("删除文章"), replies);
+}
+
+void BlogClient::bulkSetTerms(const QList<int>& postIds, bool categories)
+{
+    prepareBulkEdit();
+    
+    QList<Post> posts;
+    for (int postId : postIds) {
+        Post post = DatabaseManager::instance().getPostById(postId);
+        if (post.id() > 0) {
+            posts.append(post);
+        }
+    }
+    if (posts.isEmpty()) {
+        return;
+    }
+    
+    // 输入框中预先填入所选文章共有的分类/标签
+    QStringList common = categories ? posts.first().categories() : posts.first().tags();
+    for (const Post& post : std::as_const(posts)) {
+        const QStringList names = categories ? post.categories() : post.tags();
+        for (int i = common.size() - 1; i >= 0; --i) {
+            if (!names.contains(common.at(i))) {
+                common.removeAt(i);
+            }
+        }
+    }
+    
+    bool ok = false;
+    QString text = QInputDialog::getText(this, categories ? tr("修改分类") : tr("修改标签"),
+        (categories ? tr("所选 %1 篇文章的分类（以逗号分隔，替换原有的分类）：")
+                    : tr("所选 %1 篇文章的标签（以逗号分隔，替换原有的标签）：")).arg(posts.size()),
+        QLineEdit::Normal, common.join(", "), &ok);
+    if (!ok) {
+        return;
+    }
+    
+    QStringList names;
+    const QStringList parts = text.split(QRegularExpression("[,，]"));
+    for (const QString& part : parts) {
+        QString name = part.trimmed();
+        if (!name.isEmpty() && !names.contains(name)) {
+            names.append(name);
+        }
+    }
+    
+    // 新的分类/标签在保存第一篇文章时创建，与文章的修改在同一个事务中
+    QList<Post> changedPosts;
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    for (Post& post : posts) {
+        if (categories) {
+            post.setCategories(names);
+        } else {
+            post.setTags(names);
+        }
+        DatabaseManager::SaveOutcome outcome = DatabaseManager::Unchanged;
+        if (!DatabaseManager::instance().savePost(post, &outcome)) {
+            db.rollback();
+            QMessageBox::warning(this, tr("修改失败"),
+                tr("无法保存文章“%1”，所选文章均未修改。").arg(post.title()));
+            return;
+        }
+        if (outcome != DatabaseManager::Unchanged) {
+            changedPosts.append(post);
+        }
+    }
+    db.commit();
+    
+    for (const Post& post : std::as_const(changedPosts)) {
+        DatabaseManager::instance().saveRevision(post);
+    }
+    
+    updateCategoriesList();
+    updateTagsList();
+    if (m_currentPost && postIds.contains(m_currentPost->id())) {
+        populateEditor(DatabaseManager::instance().getPostById(m_currentPost->id()));
+    }
+    
+    // 已同步到WordPress的文章只发送分类/标签（updatePost只发送修改过的字段）
+    QList<Post> remotePosts;
+    for (const Post& post : std::as_const(changedPosts)) {
+        if (post.hasRemoteId()) {
+            remotePosts.append(post);
+        }
+    }
+    if (remotePosts.isEmpty() || !applyApiSettings()) {
+        QMessageBox::information(this, tr("修改成功"),
+            tr("已修改 %1 篇文章。").arg(changedPosts.size()));
+        return;
+    }
+    
+    pushBulkPosts(tr("更新文章"), remotePosts);
+}
+
+void BlogClient::pushBulkPosts(const QString& title, const QList<Post>& posts)
+{
+    struct Prepared
+    {
+        int pending = 1;    // 未完成的获取和合并，加上准备阶段本身
+        QList<Post> ready;
+        QStringList skipped;
+    };
+    auto prepared = std::make_shared<Prepared>();
+    
+    // 同一轮事件循环中发出的写操作由WordPressAPI合并为batch/v1请求
+    auto sendReady = [this, title, prepared]() {
+        statusBar()->clearMessage();
+        QList<QPair<int, ApiReply*>> replies;
+        for (const Post& post : std::as_const(prepared->ready)) {
+            ApiReply* reply = post.hasRemoteId()
+                ? WordPressAPI::instance().updatePost(post, DatabaseManager::instance().unsyncedFields(post))
+                : WordPressAPI::instance().createPost(post);
+            replies.append(qMakePair(post.id(), reply));
+        }
+        trackBulkReplies(title, replies, prepared->skipped);
+    };
+    auto finishOne = [prepared, sendReady]() {
+        if (--prepared->pending == 0) {
+            sendReady();
+        }
+    };
+    auto addResult = [this, prepared](const SyncMerge::Result& result) {
+        switch (result.outcome) {
+        case SyncMerge::KeptLocal:
+            prepared->ready.append(result.post);
+            break;
+        case SyncMerge::Merged:
+            // 合并结果已保存到本地，只推送本地修改的部分
+            prepared->ready.append(result.post);
+            updatePostListItem(result.post);
+            if (m_currentPost && m_currentPost->id() == result.post.id() && !m_dirtyFields) {
+                *m_currentPost = result.post;
+                populateEditor(result.post);
+            }
+            break;
+        case SyncMerge::Conflict:
+            prepared->skipped.append(tr("“%1”在WordPress中也被修改过，无法自动合并：%2")
+                .arg(result.post.title(), fieldNames(result.conflicts)));
+            break;
+        default:
+            prepared->skipped.append(tr("“%1”保存合并结果失败").arg(result.post.title()));
+            break;
+        }
+    };
+    
+    // 新文章、从未同步过的和自上次同步后没有修改的直接发出，其余的先检查远程版本
+    QList<Post> toCheck;
+    for (const Post& post : posts) {
+        PostSchema::FieldHashes synced = post.hasRemoteId()
+            ? DatabaseManager::instance().syncedHashes(post.id()) : PostSchema::FieldHashes();
+        if (synced.isEmpty() || !PostSchema::changedSince(synced, post)) {
+            prepared->ready.append(post);
+        } else {
+            toCheck.append(post);
+        }
+    }
+    if (!toCheck.isEmpty()) {
+        statusBar()->showMessage(tr("正在检查 %1 篇文章的远程版本...").arg(toCheck.size()));
+    }
+    
+    // 每次最多获取一页（100篇）
+    for (int i = 0; i < toCheck.size(); i += 100) {
+        QList<Post> chunk = toCheck.mid(i, 100);
+        QList<int> remoteIds;
+        for (const Post& post : std::as_const(chunk)) {
+            remoteIds.append(post.remoteId());
+        }
+        
+        ++prepared->pending;
+        ApiReply* reply = WordPressAPI::instance().fetchPostsById(remoteIds);
+        connect(reply, &ApiReply::finished, this, [this, reply, chunk, prepared, addResult, finishOne]() {
+            QHash<int, Post> remotePosts;
+            if (!reply->hasError()) {
+                for (const Post& remote : reply->posts()) {
+                    remotePosts.insert(remote.remoteId(), remote);
+                }
+            }
+            
+            for (const Post& post : chunk) {
+                if (reply->hasError()) {
+                    prepared->skipped.append(tr("“%1”：%2").arg(post.title(), reply->errorString()));
+                    continue;
+                }
+                auto remote = remotePosts.constFind(post.remoteId());
+                if (remote == remotePosts.constEnd()) {
+                    prepared->skipped.append(tr("“%1”：远程文章已不存在").arg(post.title()));
+                    continue;
+                }
+                
+                ++prepared->pending;
+                SyncMerge::Result result = SyncMerge::prepareUpdate(post, remote.value(), this,
+                    [addResult, finishOne](const SyncMerge::Result& merged) {
+                        addResult(merged);
+                        finishOne();
+                    });
+                if (result.outcome != SyncMerge::Pending) {
+                    addResult(result);
+                    finishOne();
+                }
+            }
+            finishOne();
+        });
+    }
+    finishOne();
+}
+
+void BlogClient::trackBulkReplies(const QString& title, const QList<QPair<int, ApiReply*>>& replies,
+                                  const QStringList& skipped)
+{
+    // 没有请求时不会有finished，进度对话框也就不会关闭
+    if (replies.isEmpty()) {
+        if (!skipped.isEmpty()) {
+            QMessageBox::warning(this, tr("部分操作失败"),
+                tr("%1完成：成功 0 篇，失败 %2 篇。").arg(title).arg(skipped.size())
+                    + "\n\n" + skipped.mid(0, 5).join("\n"));
+        }
+        return;
+    }
+    
+    // 所有请求共用一个进度对话框，按完成的请求数显示进度
+    QProgressDialog* progressDialog = new QProgressDialog(tr("正在%1...").arg(title), tr("取消"), 0, replies.size(), this);
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+    progressDialog->setValue(0);
+    progressDialog->show();
+    
+    struct BulkResult
+    {
+        int remaining = 0;
+        int unchanged = 0;
+        QList<QPair<int, Post>> syncedPosts;
+        QStringList errors;
+    };
+    auto result = std::make_shared<BulkResult>();
+    result->remaining = replies.size();
+    
+    // 取消时只中止还没有发出的写操作；已经发出的服务器会执行，仍然等待结果并保存（例如新文章的远程ID），
+    // 否则下次发布或同步时会在站点上重复创建
+    QList<QPointer<ApiReply>> pending;
+    for (const auto& entry : replies) {
+        pending.append(entry.second);
+    }
+    connect(progressDialog, &QProgressDialog::canceled, this, [this, pending]() {
+        int waiting = 0;
+        for (const QPointer<ApiReply>& reply : pending) {
+            if (!reply || reply->isFinished()) {
+                continue;
+            }
+            if (reply->isSent()) {
+                ++waiting;
+            } else {
+                reply->abort();
+            }
+        }
+        if (waiting > 0) {
+            statusBar()->showMessage(tr("已取消未发送的操作，正在等待已发出的 %1 个请求完成").arg(waiting));
+        }
+    });
+    
+    for (const auto& entry : replies) {
+        int localId = entry.first;
+        ApiReply* reply = entry.second;
+        
+        connect(reply, &ApiReply::finished, this, [this, reply, localId, result, progressDialog, title, skipped]() {
+            if (reply->hasError()) {
+                result->errors.append(reply->errorString());
+            } else if (reply->isUnchanged()) {
+                ++result->unchanged;
+            } else if (reply->post().hasRemoteId()) {
+                result->syncedPosts.append(qMakePair(localId, reply->post()));
+            }
+            
+            --result->remaining;
+            progressDialog->setValue(progressDialog->maximum() - result->remaining);
+            if (result->remaining > 0) {
+                return;
+            }
+            
+            // 全部完成后在一个事务中保存服务器返回的文章，并记录为已同步的状态
+            QSqlDatabase db = QSqlDatabase::database();
+            db.transaction();
+            for (auto& synced : result->syncedPosts) {
+                Post& localPost = synced.second;
+                localPost.setId(synced.first);
+                if (DatabaseManager::instance().savePost(localPost)) {
+                    DatabaseManager::instance().markSynced(localPost);
+                }
+                if (m_currentPost && m_currentPost->id() == synced.first) {
+                    m_currentPost->setRemoteId(localPost.remoteId());
+                }
+            }
+            db.commit();
+            
+            bool canceled = progressDialog->wasCanceled();
+            if (canceled) {
+                statusBar()->clearMessage();
+            }
+            int succeeded = progressDialog->maximum() - result->errors.size();
+            progressDialog->deleteLater();
+            if (!result->syncedPosts.isEmpty()) {
+                loadPostsList();
+                loadDraftsList();
+            }
+            
+            QString summary = tr("%1完成：成功 %2 篇，失败 %3 篇。")
+                .arg(title).arg(succeeded).arg(result->errors.size() + skipped.size());
+            if (result->unchanged > 0) {
+                summary += tr("\n其中 %1 篇自上次同步后没有修改，未发送更新。").arg(result->unchanged);
+            }
+            if (result->errors.isEmpty() && skipped.isEmpty()) {
+                QMessageBox::information(this, tr("操作完成"), summary);
+            } else {
+                // 同样的错误只显示一次
+                QStringList errors = skipped + result->errors;
+                errors.removeDuplicates();
+                summary += "\n\n" + errors.mid(0, 5).join("\n");
+                QMessageBox::warning(this, canceled ? tr("操作已取消") : tr("部分操作失败"), summary);
+            }
+        });
+    }
+}
+
 void BlogClient::closeEvent(QCloseEvent* event)
 {
-    // 如果有未保存的更改，提示保存
-    if (m_currentPost && !m_isEditing) {
+    // 先写入待自动保存的修改，仍未保存的提示保存
+    flushAutosave();
+    if (m_currentPost && m_dirtyFields) {
         QMessageBox::StandardButton result = QMessageBox::question(this, tr("保存更改"),
             tr("您有未保存的更改。是否保存？"),
             QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
@@ -1127,7 +2182,7 @@ void BlogClient::setupAddButtons()
         addCategoryButton->setText(tr("添加分类"));
         addCategoryButton->setMinimumWidth(80);
     } else {
-        qDebug() << "警告：找不到分类添加按钮或分类组合框";
+        qCWarning(lcUi) << "警告：找不到分类添加按钮或分类组合框";
     }
     
     // 查找标签添加按钮和标签输入框
@@ -1143,8 +2198,172 @@ void BlogClient::setupAddButtons()
         addTagButton->setText(tr("添加标签"));
         addTagButton->setMinimumWidth(80);
     } else {
-        qDebug() << "警告：找不到标签添加按钮或标签输入框";
+        qCWarning(lcUi) << "警告：找不到标签添加按钮或标签输入框";
     }
 }
 
 
+
+void BlogClient::updatePostListItem(const Post& post)
+{
+    // 只更新这一篇文章对应的列表项，不重新加载整个列表
+    QListWidget* target = post.status() == Post::Draft ? ui.draftsListWidget : ui.postsListWidget;
+    QListWidget* other = target == ui.draftsListWidget ? ui.postsListWidget : ui.draftsListWidget;
+    
+    for (int i = 0; i < other->count(); ++i) {
+        if (other->item(i)->data(Qt::UserRole).toInt() == post.id()) {
+            delete other->takeItem(i);
+            break;
+        }
+    }
+    
+    QListWidgetItem* item = nullptr;
+    for (int i = 0; i < target->count(); ++i) {
+        QListWidgetItem* candidate = target->item(i);
+        if (candidate->data(Qt::UserRole).toInt() == post.id()) {
+            item = candidate;
+            break;
+        }
+    }
+    
+    if (!item) {
+        // 去掉"暂无文章"之类的提示项
+        if (target->count() == 1 && !target->item(0)->data(Qt::UserRole).isValid()) {
+            delete target->takeItem(0);
+        }
+        item = new QListWidgetItem;
+        item->setData(Qt::UserRole, post.id());
+        target->insertItem(0, item);
+    }
+    
+    item->setText(post.displayText());
+    item->setToolTip(post.title());
+}
+
+void BlogClient::markDirty(Post::Fields fields)
+{
+    if (m_loadingEditor) {
+        return;
+    }
+    
+    // 在空白编辑器中直接输入时也开始一篇新文章
+    if (!m_currentPost) {
+        m_currentPost = std::make_unique<Post>();
+        m_isEditing = false;
+    }
+    
+    m_dirtyFields |= fields;
+    if (!m_dirtySince.isValid()) {
+        m_dirtySince.start();
+    }
+    
+    // 每次输入都推迟保存，但不晚于第一次修改之后AutosaveMaxDelayMs
+    qint64 remaining = AutosaveMaxDelayMs - m_dirtySince.elapsed();
+    m_autosaveTimer->start(int(qBound<qint64>(0, remaining, AutosaveDelayMs)));
+}
+
+void BlogClient::autosave()
+{
+    m_autosaveTimer->stop();
+    if (!m_currentPost || !m_dirtyFields) {
+        return;
+    }
+    
+    // 没有标题的文章不自动保存，修改保持未保存状态，手动保存时再提示
+    QString title = ui.titleEdit->text().trimmed();
+    if (title.isEmpty()) {
+        return;
+    }
+    
+    // 新文章还没有数据库记录，所有字段都要写入
+    bool isNew = m_currentPost->id() <= 0;
+    Post::Fields fields = isNew ? Post::Fields(Post::AllFields) : m_dirtyFields;
+    
+    // 只从修改过的控件取值，未修改的大字段（例如正文）不会被重新读取和写入
+    readEditorFields(*m_currentPost, fields);
+    
+    m_dirtyFields = {};
+    m_dirtySince.invalidate();
+    
+    if (isNew) {
+        // 插入一次取得本地ID，之后的修改都由后台线程按字段更新
+        if (!DatabaseManager::instance().savePost(*m_currentPost)) {
+            m_dirtyFields |= fields;
+            statusBar()->showMessage(tr("自动保存失败"), 5000);
+            return;
+        }
+        m_isEditing = true;
+        updatePostListItem(*m_currentPost);
+        statusBar()->showMessage(tr("已自动保存 %1").arg(QTime::currentTime().toString("HH:mm:ss")), 3000);
+        return;
+    }
+    
+    DatabaseWorker::instance().savePostFields(*m_currentPost, fields);
+}
+
+void BlogClient::readEditorFields(Post& post, Post::Fields fields) const
+{
+    if (fields & Post::TitleField) {
+        post.setTitle(ui.titleEdit->text().trimmed());
+    }
+    if (fields & Post::ContentField) {
+        post.setContent(ui.contentEdit->toPlainText());
+    }
+    if (fields & Post::ExcerptField) {
+        post.setExcerpt(ui.excerptEdit->text());
+    }
+    if (fields & Post::PublishDateField) {
+        post.setPublishDate(ui.publishDateEdit->dateTime());
+    }
+    if (fields & Post::AuthorField) {
+        post.setAuthor(ui.authorEdit->text());
+    }
+    if (fields & Post::FeaturedImageField) {
+        post.setFeaturedImageUrl(ui.featuredImageUrlEdit->text());
+    }
+    if (fields & Post::StatusField) {
+        post.setStatus(ui.isDraftCheckBox->isChecked() ? Post::Draft : Post::Published);
+    }
+    if (fields & Post::TermsField) {
+        QStringList categories;
+        for (int i = 0; i < ui.categoriesList->count(); ++i) {
+            categories << ui.categoriesList->item(i)->text();
+        }
+        QStringList tags;
+        for (int i = 0; i < ui.tagsList->count(); ++i) {
+            tags << ui.tagsList->item(i)->text();
+        }
+        post.setCategories(categories);
+        post.setTags(tags);
+    }
+}
+
+void BlogClient::flushAutosave()
+{
+    if (m_dirtyFields) {
+        autosave();
+    }
+    DatabaseWorker::instance().waitForIdle();
+}
+
+void BlogClient::onAutosaved(int postId, int fields, bool ok)
+{
+    bool isCurrent = m_currentPost && m_currentPost->id() == postId;
+    
+    if (!ok) {
+        // 重新标记为未保存，下次编辑或手动保存时再写入；不立即重试，避免持续失败时反复写入
+        if (isCurrent) {
+            m_dirtyFields |= Post::Fields(fields);
+        }
+        statusBar()->showMessage(tr("自动保存失败"), 5000);
+        return;
+    }
+    
+    // 列表只显示标题和日期，状态决定文章在哪个列表中
+    Post::Fields listFields = Post::TitleField | Post::PublishDateField | Post::StatusField;
+    if (isCurrent && (Post::Fields(fields) & listFields)) {
+        updatePostListItem(*m_currentPost);
+    }
+    
+    statusBar()->showMessage(tr("已自动保存 %1").arg(QTime::currentTime().toString("HH:mm:ss")), 3000);
+}
@@ -7,6 +7,8 @@
 #include <QCloseEvent>
 #include <QResizeEvent>
 #include <QScrollArea>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <memory>
 #include "ui_BlogClient.h"
 #include "models/Post.h"
@@ -14,6 +16,8 @@
 #include "models/Tag.h"
 #include "api/WordPressAPI.h"
 #include "database/DatabaseManager.h"
+#include "database/SyncMerge.h"
+#include "database/SiteProfiles.h"
 
 class BlogClient : public QMainWindow
 {
@@ -34,11 +38,15 @@ private slots:
     void on_actionFetch_triggered();
     void on_actionSync_triggered();
     void on_actionSettings_triggered();
+    void on_actionStats_triggered();
+    void on_actionRevisions_triggered();
     void on_actionAbout_triggered();
     
     // UI事件
     void on_postsListWidget_itemClicked(QListWidgetItem *item);
     void on_draftsListWidget_itemClicked(QListWidgetItem *item);
+    void on_postsListWidget_customContextMenuRequested(const QPoint& pos);
+    void on_draftsListWidget_customContextMenuRequested(const QPoint& pos);
     void on_saveButton_clicked();
     void on_deleteButton_clicked();
     void on_publishButton_clicked();
@@ -49,17 +57,28 @@ private slots:
     void on_removeTagButton_clicked();
     void on_uploadImageButton_clicked();
     
-    // API回调
+private:
+    // API回调（由各请求句柄的finished()触发）
     void onPostsReceived(const QList<Post>& posts);
-    void onPostCreated(const Post& post);
-    void onPostUpdated(const Post& post);
-    void onPostDeleted(int postId);
+    // 获取文章之后对比远程文章索引（只有ID和修改时间），删除远程已删除的文章，规则与命令行的reconcile相同：
+    // 列表不完整时不删除，本地有未同步修改的保留并提示
+    struct IndexState;
+    void reconcileDeletedPosts();
+    void requestIndexPage(int page, const std::shared_ptr<IndexState>& state);
+    void finishReconcile(const IndexState& state);
+    void onPostCreated(int localId, const Post& post);
+    void onPostUpdated(int localId, const Post& post);
+    // 更新远程文章：updatePost()及其结果处理
+    void pushUpdate(int localId, const Post& post);
+    // 推送前的合并检查完成（local是发起同步时的本地版本）
+    void onUpdatePrepared(const Post& local, const SyncMerge::Result& result);
+    // 合并期间编辑器中又有未保存的修改：把这些修改合并到合并结果上再推送
+    void mergeEditorChanges(const Post& local, const Post& merged);
     void onCategoriesReceived(const QList<Category>& categories);
     void onTagsReceived(const QList<Tag>& tags);
-    void onMediaUploaded(const QString& url,int mediaId);
+    void onMediaUploaded(int localId, const QString& url, int mediaId);
     void onApiError(const QString& errorMessage);
-
-private:
+    
     // UI辅助方法
     void clearEditor();
     void populateEditor(const Post& post);
@@ -68,12 +87,42 @@ private:
     void updateCategoriesList();
     void updateTagsList();
     void setupAddButtons();  // 添加此方法用于设置添加按钮
+    void updatePostListItem(const Post& post);
+    
+    // 自动保存：编辑时记录修改过的字段，停止输入一段时间后只把这些字段交给后台线程写入
+    void markDirty(Post::Fields fields);
+    void autosave();
+    void flushAutosave();
+    // 把编辑器中fields对应控件的值写入post
+    void readEditorFields(Post& post, Post::Fields fields) const;
+    void onAutosaved(int postId, int fields, bool ok);
     
     // 数据操作
     bool saveCurrentPost();
     bool publishCurrentPost();
     void deleteCurrentPost();
     
+    // 批量操作：文章列表中选中的多篇文章在一个事务中修改，远程请求一起发出（由WordPressAPI合并为batch/v1），
+    // 全部完成后在一个事务中保存结果，只显示一个进度对话框和一个汇总提示
+    void showBulkMenu(QListWidget* list, const QPoint& pos);
+    QList<int> selectedPostIds(QListWidget* list) const;
+    void prepareBulkEdit();
+    bool applyApiSettings();
+    void bulkPublish(const QList<int>& postIds);
+    void bulkDelete(const QList<int>& postIds);
+    void bulkSetTerms(const QList<int>& postIds, bool categories);
+    // 已同步的文章先一次获取远程的当前版本，远程也修改过的与本地修改合并（SyncMerge::prepareUpdate()），
+    // 无法合并的不推送；全部准备好之后与新建的文章在同一轮事件循环中发出
+    void pushBulkPosts(const QString& title, const QList<Post>& posts);
+    // skipped：没有发出请求的文章的错误信息，计入失败并显示在汇总中
+    void trackBulkReplies(const QString& title, const QList<QPair<int, ApiReply*>>& replies,
+                          const QStringList& skipped = QStringList());
+    
+    // 多站点：工具栏上的站点列表，切换时打开另一个站点的数据库并使用它的API会话
+    void setupSiteSelector();
+    void reloadSiteSelector();
+    void switchSite(const QString& siteId);
+    
     // 窗口事件
     void closeEvent(QCloseEvent* event) override;
     void resizeEvent(QResizeEvent* event) override;
@@ -82,4 +131,10 @@ private:
     std::unique_ptr<Post> m_currentPost;
     bool m_isEditing;
     QScrollArea* m_scrollArea; // 滚动区域引用
+    
+    Post::Fields m_dirtyFields;     // 尚未写入数据库的字段
+    QTimer* m_autosaveTimer;
+    QElapsedTimer m_dirtySince;     // 第一次未保存修改的时间，连续输入时也不会无限推迟保存
+    bool m_loadingEditor;           // 程序填充编辑器时不记录修改
+    QComboBox* m_siteCombo;
 };
@@ -0,0 +1,209 @@
+#include "BenchData.h"
+#include <QDateTime>
+#include <QStringList>
+
+#include "database/DatabaseManager.h"
+#include "models/Category.h"
+#include "models/Tag.h"
+
+namespace {
+
+// 中英文混合的词表，使标题和正文的字符分布接近实际文章
+const char* const Words[] = {
+    "Qt", "WordPress", "SQLite", "REST", "API", "JSON", "HTTP/2", "TLS", "C++17", "CMake",
+    "缓存", "性能", "同步", "草稿", "发布", "分类", "标签", "数据库", "网络", "界面",
+    "插件", "主题", "服务器", "客户端", "编辑器", "索引", "事务", "线程", "内存", "延迟",
+    "the", "request", "response", "update", "query", "latency", "throughput", "layout",
+    "我们", "可以", "需要", "通过", "使用", "这个", "问题", "方法", "结果", "最后"
+};
+const int WordCount = sizeof(Words) / sizeof(Words[0]);
+
+}
+
+BenchData::BenchData(quint32 seed)
+    : m_seed(seed)
+{
+}
+
+QString BenchData::categoryName(int id)
+{
+    return QString("分类-%1").arg(id);
+}
+
+QString BenchData::tagName(int id)
+{
+    return QString("tag-%1").arg(id);
+}
+
+QString BenchData::authorName(int id)
+{
+    return QString("作者-%1").arg(id);
+}
+
+bool BenchData::seedTerms()
+{
+    for (int id = 1; id <= CategoryCount; ++id) {
+        Category category(-1, categoryName(id));
+        if (!DatabaseManager::instance().saveCategory(category)) {
+            return false;
+        }
+    }
+
+    for (int id = 1; id <= TagCount; ++id) {
+        Tag tag(-1, tagName(id));
+        if (!DatabaseManager::instance().saveTag(tag)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Post BenchData::makePost(int index) const
+{
+    PostShape shape = makeShape(index);
+
+    Post post(-1, shape.title, shape.content, shape.excerpt,
+              QDateTime::fromString(shape.date, Qt::ISODate), authorName(shape.authorId),
+              shape.published ? Post::Published : Post::Draft);
+    post.setRemoteId(index + 1);
+
+    for (int id : shape.categoryIds) {
+        post.addCategory(categoryName(id));
+    }
+    for (int id : shape.tagIds) {
+        post.addTag(tagName(id));
+    }
+
+    return post;
+}
+
+QJsonObject BenchData::makePostJson(int index) const
+{
+    PostShape shape = makeShape(index);
+
+    QJsonArray categories;
+    for (int id : shape.categoryIds) {
+        categories.append(id);
+    }
+    QJsonArray tags;
+    for (int id : shape.tagIds) {
+        tags.append(id);
+    }
+
+    QJsonObject post;
+    post["id"] = index + 1;
+    post["date"] = shape.date;
+    post["date_gmt"] = shape.date;
+    post["modified"] = shape.date;
+    post["modified_gmt"] = shape.date;
+    post["slug"] = QString("post-%1").arg(index + 1);
+    post["status"] = shape.published ? "publish" : "draft";
+    post["type"] = "post";
+    post["link"] = QString("https://example.com/?p=%1").arg(index + 1);
+    post["title"] = QJsonObject{{"rendered", shape.title}};
+    post["content"] = QJsonObject{{"rendered", shape.content}, {"protected", false}};
+    post["excerpt"] = QJsonObject{{"rendered", shape.excerpt}, {"protected", false}};
+    post["author"] = shape.authorId;
+    post["featured_media"] = 0;
+    post["comment_status"] = "open";
+    post["categories"] = categories;
+    post["tags"] = tags;
+    return post;
+}
+
+QJsonArray BenchData::makePostsJson(int count) const
+{
+    QJsonArray posts;
+    for (int i = 0; i < count; ++i) {
+        posts.append(makePostJson(i));
+    }
+    return posts;
+}
+
+BenchData::PostShape BenchData::makeShape(int index) const
+{
+    QRandomGenerator random(m_seed + static_cast<quint32>(index));
+
+    PostShape shape;
+    shape.title = makeSentence(random);
+    shape.content = makeHtmlBody(random);
+    shape.excerpt = "<p>" + makeSentence(random) + makeSentence(random) + "</p>\n";
+
+    // 发布时间分布在最近几年内
+    QDateTime date = QDateTime(QDate(2019, 1, 1), QTime(8, 0)).addSecs(random.bounded(6 * 365 * 24 * 3600));
+    shape.date = date.toString(Qt::ISODate);
+
+    shape.published = random.bounded(10) < 8;
+    shape.categoryIds = pickIds(random, 1 + random.bounded(3), CategoryCount);
+    shape.tagIds = pickIds(random, 4 + random.bounded(14), TagCount);
+    shape.authorId = 1 + random.bounded(AuthorCount);
+    return shape;
+}
+
+QString BenchData::makeSentence(QRandomGenerator& random)
+{
+    int length = 6 + random.bounded(14);
+    QStringList words;
+    for (int i = 0; i < length; ++i) {
+        words << QString::fromUtf8(Words[random.bounded(WordCount)]);
+    }
+    return words.join(' ') + "。";
+}
+
+QString BenchData::makeHtmlBody(QRandomGenerator& random)
+{
+    QString html;
+    int blocks = 6 + random.bounded(20);
+
+    for (int block = 0; block < blocks; ++block) {
+        int kind = random.bounded(10);
+
+        if (kind == 0) {
+            html += "<h2 class=\"wp-block-heading\">" + makeSentence(random) + "</h2>\n";
+        } else if (kind == 1) {
+            html += "<ul>\n";
+            for (int i = 0, items = 2 + random.bounded(5); i < items; ++i) {
+                html += "<li>" + makeSentence(random) + "</li>\n";
+            }
+            html += "</ul>\n";
+        } else if (kind == 2) {
+            html += "<pre class=\"wp-block-code\"><code>for (int i = 0; i &lt; count; ++i) {\n"
+                    "    total += values[i];\n}\n</code></pre>\n";
+        } else if (kind == 3) {
+            int imageId = 1000 + random.bounded(9000);
+            html += QString("<figure class=\"wp-block-image size-large\"><img src=\"https://example.com/wp-content/uploads/2024/05/image-%1.jpg\" "
+                            "alt=\"\" class=\"wp-image-%1\"/><figcaption>%2</figcaption></figure>\n")
+                        .arg(imageId).arg(makeSentence(random));
+        } else {
+            html += "<p>";
+            for (int i = 0, sentences = 2 + random.bounded(6); i < sentences; ++i) {
+                QString sentence = makeSentence(random);
+                int decoration = random.bounded(8);
+                if (decoration == 0) {
+                    sentence = "<a href=\"https://example.com/docs/" + QString::number(random.bounded(500)) + "\">" + sentence + "</a>";
+                } else if (decoration == 1) {
+                    sentence = "<strong>" + sentence + "</strong>";
+                } else if (decoration == 2) {
+                    sentence = "<code>" + sentence + "</code>";
+                }
+                html += sentence;
+            }
+            html += "</p>\n";
+        }
+    }
+
+    return html;
+}
+
+QList<int> BenchData::pickIds(QRandomGenerator& random, int count, int max)
+{
+    QList<int> ids;
+    while (ids.size() < count) {
+        int id = 1 + random.bounded(max);
+        if (!ids.contains(id)) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
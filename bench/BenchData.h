@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QList>
+#include <QString>
+
+#include "models/Post.h"
+
+// 基准测试用的合成数据
+// 文章内容是结构接近真实博客的HTML（段落、标题、列表、代码块、图片和链接），
+// 每篇文章带1-3个分类和4-17个标签（合计5-20个），作者在少数几个人中选择。
+// 同一个index总是生成同样的文章，makePost()和makePostJson()的结果互相对应。
+class BenchData
+{
+public:
+    static const int CategoryCount = 40;
+    static const int TagCount = 400;
+    static const int AuthorCount = 8;
+
+    explicit BenchData(quint32 seed = 20240601);
+
+    // 分类和标签的名称，ID从1开始，与seedTerms()写入的顺序一致
+    static QString categoryName(int id);
+    static QString tagName(int id);
+    static QString authorName(int id);
+
+    // 在当前（空）数据库中按顺序创建全部分类和标签，使其ID分别为1..CategoryCount和1..TagCount
+    static bool seedTerms();
+
+    // 本地文章（id为-1，远程ID为index+1）
+    Post makePost(int index) const;
+
+    // 与/wp/v2/posts响应中单个元素结构相同的JSON对象
+    QJsonObject makePostJson(int index) const;
+    QJsonArray makePostsJson(int count) const;
+
+private:
+    struct PostShape
+    {
+        QString title;
+        QString content;
+        QString excerpt;
+        QString date;
+        bool published;
+        int authorId;
+        QList<int> categoryIds;
+        QList<int> tagIds;
+    };
+
+    PostShape makeShape(int index) const;
+
+    static QString makeSentence(QRandomGenerator& random);
+    static QString makeHtmlBody(QRandomGenerator& random);
+    static QList<int> pickIds(QRandomGenerator& random, int count, int max);
+
+    quint32 m_seed;
+};
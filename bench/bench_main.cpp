@@ -0,0 +1,531 @@
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <functional>
+#include <utility>
+#include <QHash>
+#include <QJsonDocument>
+#include <QListWidget>
+#include <QListWidgetItem>
+#include <QRandomGenerator>
+#include <QSqlDatabase>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "BenchData.h"
+#include "database/DatabaseManager.h"
+#include "database/BinaryDelta.h"
+#include "api/WordPressAPI.h"
+#include "api/ApiReply.h"
+#include "api/PostStreamParser.h"
+#include "models/StringPool.h"
+#include "FakeWordPressServer.h"
+
+namespace {
+
+// 数据集大小：1k、10k和100k篇文章
+void datasets(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->Arg(1000)->Arg(10000)->Arg(100000);
+}
+
+QTemporaryDir& datasetDir()
+{
+    static QTemporaryDir dir;
+    return dir;
+}
+
+// 切换到包含count篇文章的数据库，第一次使用时生成（同样的大小和正文格式只生成一次）
+// compressed为false时正文以未压缩的文本保存，用于对比压缩前后的数据库大小和加载时间
+bool useDataset(int count, bool compressed = true)
+{
+    static QHash<QString, QString> paths;
+
+    DatabaseManager::instance().setContentCompression(compressed);
+
+    QString name = QString("posts-%1%2.db").arg(count).arg(compressed ? "" : "-raw");
+    if (paths.contains(name)) {
+        return DatabaseManager::instance().initialize(paths.value(name));
+    }
+
+    QString path = datasetDir().filePath(name);
+    if (!DatabaseManager::instance().initialize(path) || !BenchData::seedTerms()) {
+        return false;
+    }
+
+    BenchData data;
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    for (int i = 0; i < count; ++i) {
+        Post post = data.makePost(i);
+        if (!DatabaseManager::instance().savePost(post)) {
+            db.rollback();
+            return false;
+        }
+    }
+    db.commit();
+
+    paths.insert(name, path);
+    return true;
+}
+
+const QJsonArray& postsJson(int count)
+{
+    static QHash<int, QJsonArray> cache;
+    if (!cache.contains(count)) {
+        cache.insert(count, BenchData().makePostsJson(count));
+    }
+    return cache[count];
+}
+
+}
+
+// 向已有count篇文章的库中保存一篇新文章（包含分类和标签关联）
+// 在事务中执行并在结束时回滚，数据集大小保持不变
+static void BM_SavePost(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    // 预先生成待保存的文章，避免把生成HTML的时间计入
+    BenchData data;
+    QList<Post> pending;
+    for (int i = 0; i < 1000; ++i) {
+        pending.append(data.makePost(count + i));
+    }
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+
+    int next = 0;
+    for (auto _ : state) {
+        Post post = pending[next++ % pending.size()];
+        if (!DatabaseManager::instance().savePost(post)) {
+            state.SkipWithError("保存文章失败");
+            break;
+        }
+    }
+
+    db.rollback();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SavePost)->Apply(datasets)->Unit(benchmark::kMicrosecond);
+
+// 加载全部文章（文章列表刷新时的查询）
+static void BM_GetAllPosts(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    for (auto _ : state) {
+        QList<Post> posts = DatabaseManager::instance().getAllPosts();
+        benchmark::DoNotOptimize(posts);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_GetAllPosts)->Apply(datasets)->Unit(benchmark::kMillisecond);
+
+// 加载10k篇文章时的内存报告（每次迭代加载一次全部文章）
+// internBytesSaved：作者和词条名称经字符串池共享后少分配的字符字节数
+// termNameBytes/termIdBytes：分类和标签按每篇文章一份名称列表保存与按ID集合保存的字节数
+static void BM_PostsMemory(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    StringPool::instance().resetStats();
+    qint64 termNameBytes = 0;
+    qint64 termIdBytes = 0;
+
+    for (auto _ : state) {
+        QList<Post> posts = DatabaseManager::instance().getAllPosts();
+
+        state.PauseTiming();
+        termNameBytes = 0;
+        termIdBytes = 0;
+        for (const Post& post : posts) {
+            for (const QString& name : post.categories() + post.tags()) {
+                termNameBytes += qint64(name.size()) * qint64(sizeof(QChar));
+            }
+            termIdBytes += qint64(post.categoryIds().size() + post.tagIds().size()) * qint64(sizeof(int));
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(posts);
+    }
+
+    StringPool::Stats stats = StringPool::instance().stats();
+    double iterations = static_cast<double>(state.iterations());
+    state.counters["internHits"] = stats.hits / iterations;
+    state.counters["internBytesSaved"] = stats.bytesSaved / iterations;
+    state.counters["poolStrings"] = stats.strings;
+    state.counters["termNameBytes"] = static_cast<double>(termNameBytes);
+    state.counters["termIdBytes"] = static_cast<double>(termIdBytes);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PostsMemory)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// 正文压缩对比：参数为文章数和是否压缩正文
+// 计时部分是文章列表的加载（getAllPosts），dbBytes是数据库文件大小，
+// openPostUs是打开一篇文章（getPostById，压缩时包括解压）的平均耗时
+static void BM_ContentStorage(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    bool compressed = state.range(1) != 0;
+    if (!useDataset(count, compressed)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    for (auto _ : state) {
+        QList<Post> posts = DatabaseManager::instance().getAllPosts();
+        benchmark::DoNotOptimize(posts);
+    }
+
+    QRandomGenerator random(42);
+    QElapsedTimer timer;
+    timer.start();
+    const int opens = 200;
+    for (int i = 0; i < opens; ++i) {
+        Post post = DatabaseManager::instance().getPostById(1 + random.bounded(count));
+        benchmark::DoNotOptimize(post);
+    }
+
+    state.counters["dbBytes"] = static_cast<double>(QFileInfo(QSqlDatabase::database().databaseName()).size());
+    state.counters["openPostUs"] = timer.nsecsElapsed() / 1000.0 / opens;
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ContentStorage)->Args({10000, 0})->Args({10000, 1})->Unit(benchmark::kMillisecond);
+
+// 按ID随机读取单篇文章（打开文章时的查询）
+static void BM_GetPostById(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    QRandomGenerator random(42);
+    for (auto _ : state) {
+        Post post = DatabaseManager::instance().getPostById(1 + random.bounded(count));
+        benchmark::DoNotOptimize(post);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetPostById)->Apply(datasets)->Unit(benchmark::kMicrosecond);
+
+// 把响应体解码为JSON文档（onPostsReceived中parsePosts之前的一步）
+static void BM_DecodePostsJson(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    QByteArray body = QJsonDocument(postsJson(count)).toJson(QJsonDocument::Compact);
+
+    for (auto _ : state) {
+        QJsonDocument document = QJsonDocument::fromJson(body);
+        benchmark::DoNotOptimize(document);
+    }
+
+    state.SetBytesProcessed(state.iterations() * body.size());
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DecodePostsJson)->Apply(datasets)->Unit(benchmark::kMillisecond);
+
+// 把文章数组解析为Post列表，分类和标签名称在本地库中查找
+static void BM_ParsePosts(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    const QJsonArray& posts = postsJson(count);
+    for (auto _ : state) {
+        QList<Post> parsed = WordPressAPI::instance().parsePosts(posts);
+        benchmark::DoNotOptimize(parsed);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_ParsePosts)->Apply(datasets)->Unit(benchmark::kMillisecond);
+
+// 一页100篇长HTML文章的解析：参数为0时先解码整个JSON文档再parsePosts()，
+// 为1时按16KB一段送入PostStreamParser（模拟readyRead），直接得到Post
+// bufferBytes是解析过程中保留的原始响应字节数的峰值（整体解码时为整个响应，另有DOM的开销）
+static void BM_ParsePostsPage(benchmark::State& state)
+{
+    bool streaming = state.range(0) != 0;
+    if (!useDataset(1000)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    const int pageSize = 100;
+    const int chunkSize = 16 * 1024;
+    QByteArray body = QJsonDocument(postsJson(pageSize)).toJson(QJsonDocument::Compact);
+    qint64 bufferBytes = 0;
+
+    for (auto _ : state) {
+        QList<Post> parsed;
+        if (streaming) {
+            PostStreamParser parser;
+            for (int offset = 0; offset < body.size(); offset += chunkSize) {
+                parser.feed(body.mid(offset, chunkSize));
+            }
+            parser.finish();
+            parsed = parser.takePosts();
+            bufferBytes = parser.peakBufferSize();
+        } else {
+            QJsonDocument document = QJsonDocument::fromJson(body);
+            parsed = WordPressAPI::instance().parsePosts(document.array());
+            bufferBytes = body.size();
+        }
+        if (parsed.size() != pageSize) {
+            state.SkipWithError("解析结果数量不正确");
+            return;
+        }
+        benchmark::DoNotOptimize(parsed);
+    }
+
+    state.counters["bufferBytes"] = static_cast<double>(bufferBytes);
+    state.SetBytesProcessed(state.iterations() * body.size());
+    state.SetItemsProcessed(state.iterations() * pageSize);
+}
+BENCHMARK(BM_ParsePostsPage)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// 填充文章列表控件（与BlogClient::loadPostsList相同的条目构造方式）
+static void BM_PopulatePostsList(benchmark::State& state)
+{
+    int count = static_cast<int>(state.range(0));
+    if (!useDataset(count)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    QList<Post> posts = DatabaseManager::instance().getAllPosts(true);
+    QListWidget list;
+
+    for (auto _ : state) {
+        list.clear();
+        for (const Post& post : posts) {
+            QListWidgetItem* item = new QListWidgetItem(post.displayText());
+            item->setData(Qt::UserRole, post.id());
+            item->setToolTip(post.title());
+            list.addItem(item);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * posts.size());
+}
+BENCHMARK(BM_PopulatePostsList)->Apply(datasets)->Unit(benchmark::kMillisecond);
+
+// 通过本地模拟服务器分页获取全部文章，参数为同时进行的请求数
+// 服务器每个响应延迟20ms，每个连接限速4MB/s，结果只取决于客户端的并发和解析开销
+static void BM_FetchAllPages(benchmark::State& state)
+{
+    int concurrency = static_cast<int>(state.range(0));
+    if (!useDataset(1000)) {
+        state.SkipWithError("数据集初始化失败");
+        return;
+    }
+
+    FakeWordPressServer::Options options;
+    options.posts = 2000;
+    options.latencyMs = 20;
+    options.bandwidthBytesPerSecond = 4 * 1024 * 1024;
+    FakeWordPressServer server(options);
+    if (!server.listen()) {
+        state.SkipWithError("模拟服务器监听失败");
+        return;
+    }
+
+    WordPressAPI& api = WordPressAPI::instance();
+    api.setApiUrl(server.apiUrl());
+    api.setCredentials("bench", "bench");
+
+    // 第一页只用于得到总页数
+    int totalPages = 0;
+    {
+        QEventLoop loop;
+        ApiReply* reply = api.fetchPosts(1, 100);
+        QObject::connect(reply, &ApiReply::finished, &loop, [&]() {
+            totalPages = reply->totalPages();
+            loop.quit();
+        });
+        loop.exec();
+    }
+    if (totalPages <= 0) {
+        state.SkipWithError("获取总页数失败");
+        return;
+    }
+
+    int failed = 0;
+    for (auto _ : state) {
+        QEventLoop loop;
+        int nextPage = 1;
+        int inFlight = 0;
+
+        std::function<void()> requestMore = [&]() {
+            while (inFlight < concurrency && nextPage <= totalPages) {
+                ApiReply* reply = api.fetchPosts(nextPage++, 100);
+                ++inFlight;
+                QObject::connect(reply, &ApiReply::finished, &loop, [&, reply]() {
+                    --inFlight;
+                    if (reply->hasError()) {
+                        ++failed;
+                    }
+                    requestMore();
+                    if (inFlight == 0) {
+                        loop.quit();
+                    }
+                });
+            }
+        };
+
+        requestMore();
+        loop.exec();
+    }
+
+    FakeWordPressServer::Stats stats = server.stats();
+    state.counters["pages"] = totalPages;
+    state.counters["failed"] = failed;
+    state.counters["connections"] = stats.peakConnections;
+    state.SetBytesProcessed(stats.bytesSent);
+}
+BENCHMARK(BM_FetchAllPages)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 一次发布100篇新文章，参数0为逐个发送，1为通过batch/v1合并发送
+// 服务器每个响应延迟20ms，requests是每轮发出的HTTP请求数
+static void BM_PublishPosts(benchmark::State& state)
+{
+    const int count = 100;
+    bool batching = state.range(0) != 0;
+
+    FakeWordPressServer::Options options;
+    options.posts = 0;
+    options.latencyMs = 20;
+    FakeWordPressServer server(options);
+    if (!server.listen()) {
+        state.SkipWithError("模拟服务器监听失败");
+        return;
+    }
+
+    WordPressAPI& api = WordPressAPI::instance();
+    api.setApiUrl(server.apiUrl());
+    api.setCredentials("bench", "bench");
+    api.setBatchingEnabled(batching);
+
+    BenchData data;
+    QList<Post> posts;
+    for (int i = 0; i < count; ++i) {
+        Post post = data.makePost(i);
+        post.setRemoteId(-1);
+        posts.append(post);
+    }
+
+    int failed = 0;
+    for (auto _ : state) {
+        QEventLoop loop;
+        int remaining = count;
+        for (const Post& post : std::as_const(posts)) {
+            ApiReply* reply = api.createPost(post);
+            QObject::connect(reply, &ApiReply::finished, &loop, [&, reply]() {
+                if (reply->hasError()) {
+                    ++failed;
+                }
+                if (--remaining == 0) {
+                    loop.quit();
+                }
+            });
+        }
+        loop.exec();
+    }
+    api.setBatchingEnabled(true);
+
+    FakeWordPressServer::Stats stats = server.stats();
+    state.counters["requests"] = benchmark::Counter(stats.requests, benchmark::Counter::kAvgIterations);
+    state.counters["failed"] = failed;
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PublishPosts)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 修订历史的差异编码：对随机修改的正文编码再还原，只测量耗时和差异大小（正确性见tests/BinaryDeltaTest.cpp）
+static void BM_RevisionDelta(benchmark::State& state)
+{
+    BenchData data;
+    QRandomGenerator random(42);
+    QList<QPair<QByteArray, QByteArray>> edits;
+    for (int i = 0; i < 200; ++i) {
+        QByteArray base = data.makePost(i).content().toUtf8();
+        QByteArray target = base;
+        // 1-5处插入、删除或替换
+        int changes = 1 + random.bounded(5);
+        for (int c = 0; c < changes; ++c) {
+            int pos = random.bounded(int(target.size()) + 1);
+            int length = qMin(random.bounded(200), int(target.size()) - pos);
+            QByteArray text = data.makePost(1000 + random.bounded(1000)).title().toUtf8();
+            switch (random.bounded(3)) {
+            case 0:
+                target.insert(pos, text);
+                break;
+            case 1:
+                target.remove(pos, length);
+                break;
+            default:
+                target.replace(pos, length, text);
+                break;
+            }
+        }
+        edits.append(qMakePair(base, target));
+    }
+
+    qint64 targetBytes = 0;
+    qint64 deltaBytes = 0;
+    for (auto _ : state) {
+        for (const auto& edit : std::as_const(edits)) {
+            QByteArray delta = BinaryDelta::encode(edit.first, edit.second);
+            QByteArray restored;
+            BinaryDelta::apply(edit.first, delta, &restored);
+            benchmark::DoNotOptimize(restored.constData());
+            targetBytes += edit.second.size();
+            deltaBytes += delta.size();
+        }
+    }
+
+    state.counters["deltaRatio"] = targetBytes > 0 ? double(deltaBytes) / double(targetBytes) : 0.0;
+    state.SetItemsProcessed(state.iterations() * int64_t(edits.size()));
+}
+BENCHMARK(BM_RevisionDelta)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+    // 列表控件需要QApplication，在没有显示器的机器上使用offscreen平台
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    DatabaseManager::instance().close();
+    return 0;
+}
@@ -0,0 +1,1031 @@
+#include "CliRunner.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSqlDatabase>
+#include <QTimeZone>
+#include <cstdio>
+
+#include "api/WordPressAPI.h"
+#include "api/ApiReply.h"
+#include "database/DatabaseManager.h"
+#include "database/SyncMerge.h"
+#include "diagnostics/Tracing.h"
+#include "SyncScheduler.h"
+
+namespace {
+
+void writeLine(FILE* stream, const QByteArray& line)
+{
+    std::fwrite(line.constData(), 1, static_cast<size_t>(line.size()), stream);
+    std::fputc('\n', stream);
+    std::fflush(stream);
+}
+
+const int MaxConcurrency = 16;
+const int MaxParallelSites = 16;
+
+}
+
+CliRunner::CliRunner(QObject* parent)
+    : QObject(parent),
+      m_allSites(false),
+      m_parallelSites(3),
+      m_concurrency(4),
+      m_perPage(100),
+      m_deltaSync(true),
+      m_publishedOnly(false),
+      m_dryRun(false),
+      m_quiet(false),
+      m_trace(false),
+      m_eventsToStderr(false),
+      m_exitCode(Success),
+      m_done(false),
+      m_pendingTermRequests(0),
+      m_nextPage(1),
+      m_totalPages(-1),
+      m_pagesInFlight(0),
+      m_pagesDone(0),
+      m_saved(0),
+      m_unchanged(0),
+      m_failed(0),
+      m_keptLocal(0),
+      m_merged(0),
+      m_mergesPending(0),
+      m_remoteTotal(-1),
+      m_indexChanged(false),
+      m_scheduler(nullptr),
+      m_publishInFlight(0),
+      m_publishTotal(0)
+{
+}
+
+bool CliRunner::parseArguments(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("个人博客客户端命令行工具。进度以JSON Lines输出到标准输出。");
+    QCommandLineOption helpOption = parser.addHelpOption();
+    parser.addPositionalArgument("command", "sync | reconcile | publish | export | import | stats | sites");
+    parser.addPositionalArgument("arguments", "publish：本地文章ID；import：导入文件", "[arguments...]");
+
+    QCommandLineOption fullOption("full", "sync：获取全部文章");
+    QCommandLineOption deltaOption("delta", "sync：只获取上次同步之后修改过的文章（默认）");
+    QCommandLineOption sinceOption("since", "sync：增量同步的起始时间（ISO 8601），覆盖上次同步时间", "time");
+    QCommandLineOption perPageOption("per-page", "sync、reconcile：每页文章数（1-100，默认100）", "n");
+    QCommandLineOption dryRunOption("dry-run", "reconcile：只报告差异，不删除本地文章");
+    QCommandLineOption concurrencyOption("concurrency", "同时进行的请求数（1-16，默认4）", "n");
+    QCommandLineOption siteOption("site", "站点标识，默认为图形界面当前的站点（站点列表见sites命令）", "id");
+    QCommandLineOption allSitesOption("all-sites", "sync：同步所有已配置的站点，每个站点在单独的进程中运行");
+    QCommandLineOption parallelSitesOption("parallel-sites", "sync --all-sites：同时同步的站点数（1-16，默认3）", "n");
+    QCommandLineOption databaseOption("db", "数据库文件，默认为站点的数据库", "path");
+    QCommandLineOption urlOption("url", "WordPress REST API地址，默认读取设置", "url");
+    QCommandLineOption userOption("user", "用户名，默认读取设置", "name");
+    QCommandLineOption passwordOption("password", "应用程序密码（配合--url使用），默认读取BLOGCLIENT_PASSWORD环境变量", "password");
+    QCommandLineOption outputOption(QStringList() << "o" << "output", "export：输出文件，默认为标准输出", "file");
+    QCommandLineOption publishedOnlyOption("published-only", "export：只导出已发布文章");
+    QCommandLineOption quietOption(QStringList() << "q" << "quiet", "不输出progress事件");
+    QCommandLineOption traceOption("trace", "在done事件中附带耗时统计");
+
+    parser.addOptions({fullOption, deltaOption, sinceOption, perPageOption, concurrencyOption,
+                       siteOption, allSitesOption, parallelSitesOption,
+                       databaseOption, urlOption, userOption, passwordOption, outputOption,
+                       publishedOnlyOption, dryRunOption, quietOption, traceOption});
+
+    if (!parser.parse(arguments)) {
+        writeLine(stderr, parser.errorText().toUtf8());
+        m_exitCode = UsageError;
+        return false;
+    }
+
+    if (parser.isSet(helpOption)) {
+        writeLine(stdout, parser.helpText().toUtf8());
+        m_exitCode = Success;
+        return false;
+    }
+
+    QStringList positional = parser.positionalArguments();
+    if (positional.isEmpty()) {
+        writeLine(stderr, parser.helpText().toUtf8());
+        m_exitCode = UsageError;
+        return false;
+    }
+
+    m_command = positional.takeFirst();
+    m_positional = positional;
+    m_databasePath = parser.value(databaseOption);
+    m_apiUrl = parser.value(urlOption);
+    m_username = parser.value(userOption);
+    m_password = parser.isSet(passwordOption) ? parser.value(passwordOption)
+                                              : qEnvironmentVariable("BLOGCLIENT_PASSWORD");
+    m_outputPath = parser.value(outputOption);
+    m_publishedOnly = parser.isSet(publishedOnlyOption);
+    m_dryRun = parser.isSet(dryRunOption);
+    m_quiet = parser.isSet(quietOption);
+    m_trace = parser.isSet(traceOption);
+
+    QString error;
+    if (parser.isSet(siteOption)) {
+        m_site = SiteProfiles::find(parser.value(siteOption));
+        if (!m_site.isValid()) {
+            error = QString("未知站点: %1").arg(parser.value(siteOption));
+        }
+    } else {
+        m_site = SiteProfiles::current();
+    }
+    m_allSites = parser.isSet(allSitesOption);
+    if (m_allSites) {
+        if (m_command != "sync") {
+            error = "--all-sites 只能用于 sync";
+        } else if (parser.isSet(siteOption) || parser.isSet(databaseOption) || parser.isSet(urlOption)
+                   || parser.isSet(userOption) || parser.isSet(passwordOption)) {
+            error = "--all-sites 不能与 --site、--db、--url、--user 或 --password 同时使用";
+        }
+        // 各站点子进程沿用同步方式和并发设置
+        for (const QCommandLineOption& option : {fullOption, deltaOption, quietOption, traceOption}) {
+            if (parser.isSet(option)) {
+                m_siteArguments << "--" + option.names().last();
+            }
+        }
+        for (const QCommandLineOption& option : {sinceOption, perPageOption, concurrencyOption}) {
+            if (parser.isSet(option)) {
+                m_siteArguments << "--" + option.names().last() << parser.value(option);
+            }
+        }
+    }
+    if (parser.isSet(parallelSitesOption)) {
+        bool ok = false;
+        m_parallelSites = parser.value(parallelSitesOption).toInt(&ok);
+        if (!ok || m_parallelSites < 1 || m_parallelSites > MaxParallelSites) {
+            error = "--parallel-sites 必须在1到16之间";
+        }
+    }
+    if (parser.isSet(concurrencyOption)) {
+        bool ok = false;
+        m_concurrency = parser.value(concurrencyOption).toInt(&ok);
+        if (!ok || m_concurrency < 1 || m_concurrency > MaxConcurrency) {
+            error = "--concurrency 必须在1到16之间";
+        }
+    }
+    if (parser.isSet(perPageOption)) {
+        bool ok = false;
+        m_perPage = parser.value(perPageOption).toInt(&ok);
+        if (!ok || m_perPage < 1 || m_perPage > 100) {
+            error = "--per-page 必须在1到100之间";
+        }
+    }
+    if (parser.isSet(fullOption) && (parser.isSet(deltaOption) || parser.isSet(sinceOption))) {
+        error = "--full 不能与 --delta 或 --since 同时使用";
+    }
+    m_deltaSync = !parser.isSet(fullOption);
+    if (parser.isSet(sinceOption)) {
+        m_since = QDateTime::fromString(parser.value(sinceOption), Qt::ISODate);
+        if (!m_since.isValid()) {
+            error = "--since 不是有效的ISO 8601时间";
+        }
+    }
+
+    if (m_command == "publish") {
+        if (m_positional.isEmpty()) {
+            error = "publish 需要至少一个本地文章ID";
+        }
+        for (const QString& value : m_positional) {
+            bool ok = false;
+            int id = value.toInt(&ok);
+            if (!ok || id <= 0) {
+                error = QString("无效的文章ID: %1").arg(value);
+                break;
+            }
+            m_publishQueue.append(id);
+        }
+    } else if (m_command == "import") {
+        if (m_positional.size() != 1) {
+            error = "import 需要一个导入文件";
+        }
+    } else if (m_command == "export") {
+        // 导出到标准输出时，事件改为写到标准错误，避免混入导出内容
+        m_eventsToStderr = m_outputPath.isEmpty() || m_outputPath == "-";
+    } else if (m_command != "sync" && m_command != "reconcile" && m_command != "stats" && m_command != "sites") {
+        error = QString("未知命令: %1").arg(m_command);
+    }
+
+    if (!error.isEmpty()) {
+        writeLine(stderr, error.toUtf8());
+        m_exitCode = UsageError;
+        return false;
+    }
+
+    return true;
+}
+
+int CliRunner::exitCode() const
+{
+    return m_exitCode;
+}
+
+void CliRunner::start()
+{
+    m_elapsed.start();
+
+    if (m_command == "sync") {
+        if (m_allSites) {
+            runAllSites();
+        } else {
+            runSync();
+        }
+    } else if (m_command == "sites") {
+        runSites();
+    } else if (m_command == "reconcile") {
+        runReconcile();
+    } else if (m_command == "publish") {
+        runPublish();
+    } else if (m_command == "export") {
+        runExport();
+    } else if (m_command == "import") {
+        runImport();
+    } else {
+        runStats();
+    }
+}
+
+void CliRunner::runSync()
+{
+    if (!openDatabase() || !configureApi()) {
+        return;
+    }
+
+    m_latestModified = QDateTime();
+
+    if (m_deltaSync) {
+        m_modifiedAfter = m_since.isValid() ? m_since : SiteProfiles::lastSyncTime(m_site.id);
+        // 从未同步过时退化为全量同步
+        m_deltaSync = m_modifiedAfter.isValid();
+    }
+
+    QJsonObject fields;
+    fields["site"] = m_site.id;
+    fields["mode"] = m_deltaSync ? "delta" : "full";
+    if (m_deltaSync) {
+        fields["since"] = m_modifiedAfter.toUTC().toString(Qt::ISODate);
+    }
+    fields["concurrency"] = m_concurrency;
+    emitEvent("start", fields);
+
+    // 文章解析时按ID查找分类和标签名称，先把它们保存到本地
+    m_pendingTermRequests = 2;
+
+    ApiReply* categoriesReply = WordPressAPI::instance().fetchCategories();
+    connect(categoriesReply, &ApiReply::finished, this, [this, categoriesReply]() {
+        if (categoriesReply->hasError()) {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"phase", "categories"}, {"message", categoriesReply->errorString()}});
+        } else {
+            for (const Category& category : categoriesReply->categories()) {
+                Category localCategory = category;
+                DatabaseManager::instance().saveCategory(localCategory);
+            }
+            emitEvent("progress", QJsonObject{{"phase", "categories"}, {"count", categoriesReply->categories().size()}});
+        }
+        onTermsFetched();
+    });
+
+    ApiReply* tagsReply = WordPressAPI::instance().fetchTags();
+    connect(tagsReply, &ApiReply::finished, this, [this, tagsReply]() {
+        if (tagsReply->hasError()) {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"phase", "tags"}, {"message", tagsReply->errorString()}});
+        } else {
+            for (const Tag& tag : tagsReply->tags()) {
+                Tag localTag = tag;
+                DatabaseManager::instance().saveTag(localTag);
+            }
+            emitEvent("progress", QJsonObject{{"phase", "tags"}, {"count", tagsReply->tags().size()}});
+        }
+        onTermsFetched();
+    });
+}
+
+void CliRunner::onTermsFetched()
+{
+    if (--m_pendingTermRequests > 0) {
+        return;
+    }
+
+    m_nextPage = 1;
+    m_totalPages = -1;
+    requestNextPages();
+}
+
+void CliRunner::requestNextPages()
+{
+    // 总页数要等第一页返回后才知道，在此之前只请求第一页
+    while (m_pagesInFlight < m_concurrency
+           && (m_totalPages < 0 ? m_nextPage == 1 : m_nextPage <= m_totalPages)) {
+        if (m_command == "reconcile") {
+            ApiReply* reply = WordPressAPI::instance().fetchPostIndex(m_nextPage++, m_perPage);
+            connect(reply, &ApiReply::finished, this, [this, reply]() {
+                onIndexPageFetched(reply);
+            });
+        } else {
+            ApiReply* reply = WordPressAPI::instance().fetchPosts(m_nextPage++, m_perPage,
+                                                                  m_deltaSync ? m_modifiedAfter : QDateTime());
+            connect(reply, &ApiReply::finished, this, [this, reply]() {
+                onPageFetched(reply);
+            });
+        }
+        ++m_pagesInFlight;
+    }
+
+    // 还有文章在后台合并时等合并完成
+    if (m_pagesInFlight == 0 && m_mergesPending == 0) {
+        if (m_command == "reconcile") {
+            finishReconcile();
+        } else {
+            finishSync();
+        }
+    }
+}
+
+void CliRunner::onPageFetched(ApiReply* reply)
+{
+    --m_pagesInFlight;
+    ++m_pagesDone;
+
+    if (reply->hasError()) {
+        ++m_failed;
+        emitEvent("error", QJsonObject{{"phase", "posts"}, {"page", reply->page()}, {"message", reply->errorString()}});
+
+        // 第一页失败时无法得知总页数，不再继续
+        if (m_totalPages < 0) {
+            m_totalPages = 0;
+        }
+    } else {
+        QList<Post> posts = reply->posts();
+        updateTotalPages(reply, posts.size());
+
+        // 每页在一个事务中保存；本地有未同步修改的文章不覆盖，两边都修改过的在后台合并
+        QSqlDatabase db = QSqlDatabase::database();
+        db.transaction();
+        for (const Post& post : posts) {
+            // modified_gmt没有时区后缀，按UTC解析
+            QDateTime modified = QDateTime::fromString(post.remoteModified(), Qt::ISODate);
+            if (modified.isValid()) {
+                modified.setTimeZone(QTimeZone::utc());
+                if (!m_latestModified.isValid() || modified > m_latestModified) {
+                    m_latestModified = modified;
+                }
+            }
+
+            SyncMerge::Result result = SyncMerge::saveRemote(post, this, [this](const SyncMerge::Result& merged) {
+                --m_mergesPending;
+                onPostMerged(merged);
+                requestNextPages();
+            });
+            switch (result.outcome) {
+            case SyncMerge::Inserted:
+            case SyncMerge::Updated:
+                ++m_saved;
+                break;
+            case SyncMerge::Unchanged:
+                ++m_saved;
+                ++m_unchanged;
+                break;
+            case SyncMerge::KeptLocal:
+                ++m_keptLocal;
+                break;
+            case SyncMerge::Pending:
+                ++m_mergesPending;
+                break;
+            case SyncMerge::Conflict:
+                onPostMerged(result);
+                break;
+            default:
+                ++m_failed;
+                emitEvent("error", QJsonObject{{"phase", "posts"}, {"remoteId", post.remoteId()}, {"message", "保存文章失败"}});
+                break;
+            }
+        }
+        db.commit();
+
+        QJsonObject fields;
+        fields["phase"] = "posts";
+        fields["page"] = reply->page();
+        fields["pagesDone"] = m_pagesDone;
+        fields["totalPages"] = m_totalPages;
+        if (reply->totalItems() >= 0) {
+            fields["totalPosts"] = reply->totalItems();
+        }
+        fields["saved"] = m_saved;
+        fields["unchanged"] = m_unchanged;
+        fields["keptLocal"] = m_keptLocal;
+        emitEvent("progress", fields);
+    }
+
+    requestNextPages();
+}
+
+void CliRunner::onPostMerged(const SyncMerge::Result& result)
+{
+    // 合并期间本地又保存过时会按最新的本地版本重新处理，结果可能是任何一种
+    QJsonObject fields{{"phase", "merge"}, {"id", result.post.id()}, {"remoteId", result.post.remoteId()}};
+    switch (result.outcome) {
+    case SyncMerge::Inserted:
+    case SyncMerge::Updated:
+        ++m_saved;
+        fields["outcome"] = "saved";
+        break;
+    case SyncMerge::Unchanged:
+        ++m_saved;
+        ++m_unchanged;
+        fields["outcome"] = "unchanged";
+        break;
+    case SyncMerge::KeptLocal:
+        ++m_keptLocal;
+        fields["outcome"] = "keptLocal";
+        break;
+    case SyncMerge::Pending:
+        // saveRemote()重新处理仍在合并时不会调用回调，合并完成后才调用；这里只为保持计数一致
+        ++m_mergesPending;
+        return;
+    case SyncMerge::Merged:
+        ++m_merged;
+        fields["outcome"] = "merged";
+        break;
+    case SyncMerge::Conflict:
+        m_conflicts.append(result.post.id());
+        fields["outcome"] = "conflict";
+        fields["fields"] = int(result.conflicts);
+        break;
+    case SyncMerge::Failed:
+        ++m_failed;
+        emitEvent("error", QJsonObject{{"phase", "merge"}, {"id", result.post.id()}, {"message", "保存合并结果失败"}});
+        return;
+    }
+    emitEvent("progress", fields);
+}
+
+void CliRunner::updateTotalPages(const ApiReply* reply, int received)
+{
+    if (reply->totalPages() >= 0) {
+        m_totalPages = reply->totalPages();
+    } else {
+        // 服务器没有返回分页头时逐页探测，直到某页不满为止
+        m_totalPages = qMax(m_totalPages, received >= m_perPage ? reply->page() + 1 : reply->page());
+    }
+}
+
+void CliRunner::finishSync()
+{
+    // 只有完全成功时才推进同步时间，失败的部分下次增量同步时会重新获取
+    // 同步时间取服务器返回的最晚修改时间，不用本机时钟：两边时钟有偏差时会漏掉或重复获取文章
+    // 没有获取到文章时保持原来的时间；--since指定了更早的时间时也不后退
+    QDateTime previous = SiteProfiles::lastSyncTime(m_site.id);
+    if (m_failed == 0 && m_latestModified.isValid() && (!previous.isValid() || m_latestModified > previous)) {
+        SiteProfiles::setLastSyncTime(m_site.id, m_latestModified);
+    }
+
+    QJsonArray conflicts;
+    for (int id : m_conflicts) {
+        conflicts.append(id);
+    }
+    emitEvent("result", QJsonObject{{"saved", m_saved}, {"unchanged", m_unchanged}, {"keptLocal", m_keptLocal},
+                                    {"merged", m_merged}, {"conflicts", conflicts}, {"failed", m_failed},
+                                    {"pages", m_pagesDone}});
+    finish(m_failed == 0 ? Success : RemoteError);
+}
+
+void CliRunner::runReconcile()
+{
+    if (!openDatabase() || !configureApi()) {
+        return;
+    }
+
+    emitEvent("start", QJsonObject{{"mode", "reconcile"}, {"dryRun", m_dryRun}, {"concurrency", m_concurrency}});
+
+    m_nextPage = 1;
+    m_totalPages = -1;
+    requestNextPages();
+}
+
+void CliRunner::onIndexPageFetched(ApiReply* reply)
+{
+    --m_pagesInFlight;
+    ++m_pagesDone;
+
+    if (reply->hasError()) {
+        ++m_failed;
+        emitEvent("error", QJsonObject{{"phase", "index"}, {"page", reply->page()}, {"message", reply->errorString()}});
+
+        if (m_totalPages < 0) {
+            m_totalPages = 0;
+        }
+    } else {
+        QList<Post> posts = reply->posts();
+        updateTotalPages(reply, posts.size());
+
+        // 按页码分页时，获取期间有文章新增或删除会使后面的页错位，可能漏掉文章
+        if (reply->totalItems() >= 0) {
+            if (m_remoteTotal >= 0 && reply->totalItems() != m_remoteTotal) {
+                m_indexChanged = true;
+            }
+            m_remoteTotal = reply->totalItems();
+        }
+
+        for (const Post& post : posts) {
+            PostIndex::Stamp stamp;
+            stamp.remoteId = post.remoteId();
+            stamp.modified = post.remoteModified();
+            m_remoteStamps.append(stamp);
+        }
+
+        emitEvent("progress", QJsonObject{{"phase", "index"}, {"page", reply->page()}, {"pagesDone", m_pagesDone},
+                                          {"totalPages", m_totalPages}, {"posts", m_remoteStamps.size()}});
+    }
+
+    requestNextPages();
+}
+
+void CliRunner::finishReconcile()
+{
+    // 列表不完整时无法判断哪些文章在远程已经删除
+    if (m_failed > 0) {
+        emitEvent("result", QJsonObject{{"failed", m_failed}, {"pages", m_pagesDone}});
+        finish(RemoteError);
+        return;
+    }
+
+    PostIndex::Diff diff = PostIndex::compare(m_remoteStamps, DatabaseManager::instance().getPostStamps());
+
+    QJsonArray addedIds;
+    for (int remoteId : diff.added) {
+        addedIds.append(remoteId);
+    }
+    QJsonArray changedIds;
+    for (int remoteId : diff.changed) {
+        changedIds.append(remoteId);
+    }
+
+    QJsonArray deletedIds;
+    QJsonArray conflictIds;
+    bool complete = !m_indexChanged && (m_remoteTotal < 0 || m_remoteStamps.size() == m_remoteTotal);
+    if (complete) {
+        SyncMerge::Removal removal = SyncMerge::removeDeleted(diff.deleted, m_dryRun);
+        for (int id : removal.deleted) {
+            deletedIds.append(id);
+        }
+        for (int id : removal.conflicts) {
+            conflictIds.append(id);
+        }
+        for (int id : removal.failed) {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"id", id}, {"message", "删除本地文章失败"}});
+        }
+    } else {
+        ++m_failed;
+        emitEvent("error", QJsonObject{{"phase", "index"}, {"message", "获取期间远程文章数量发生了变化，没有删除本地文章"}});
+    }
+
+    // added和changed只报告远程ID，由sync获取正文
+    emitEvent("result", QJsonObject{{"remotePosts", m_remoteStamps.size()}, {"unchanged", diff.unchanged},
+                                    {"added", addedIds}, {"changed", changedIds},
+                                    {"deleted", deletedIds}, {"conflicts", conflictIds},
+                                    {"dryRun", m_dryRun}, {"failed", m_failed}, {"pages", m_pagesDone}});
+    finish(m_failed == 0 ? Success : RemoteError);
+}
+
+void CliRunner::runPublish()
+{
+    if (!openDatabase() || !configureApi()) {
+        return;
+    }
+
+    m_publishTotal = m_publishQueue.size();
+    emitEvent("start", QJsonObject{{"posts", m_publishTotal}, {"concurrency", m_concurrency}});
+    publishNextPosts();
+}
+
+void CliRunner::publishNextPosts()
+{
+    while (m_publishInFlight < m_concurrency && !m_publishQueue.isEmpty()) {
+        int localId = m_publishQueue.takeFirst();
+        Post post = DatabaseManager::instance().getPostById(localId);
+        if (post.id() != localId) {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"id", localId}, {"message", "本地文章不存在"}});
+            continue;
+        }
+
+        // 与图形界面的同步操作一致：本地有修改时先检查远程是否也被修改过
+        ++m_publishInFlight;
+        Post published = post;
+        published.setStatus(Post::Published);
+        PostSchema::FieldHashes synced = post.hasRemoteId() ? DatabaseManager::instance().syncedHashes(localId)
+                                                            : PostSchema::FieldHashes();
+        if (synced.isEmpty() || !PostSchema::changedSince(synced, published)) {
+            sendPublish(published);
+            continue;
+        }
+
+        ApiReply* remoteReply = WordPressAPI::instance().fetchPost(post.remoteId());
+        connect(remoteReply, &ApiReply::finished, this, [this, remoteReply, post]() {
+            if (remoteReply->hasError() || remoteReply->posts().isEmpty()) {
+                --m_publishInFlight;
+                ++m_failed;
+                emitEvent("error", QJsonObject{{"id", post.id()},
+                                               {"message", remoteReply->hasError() ? remoteReply->errorString()
+                                                                                   : QString("远程文章已不存在")}});
+                publishNextPosts();
+                return;
+            }
+
+            // 以数据库中的版本合并，已发布状态在发送时再设置
+            SyncMerge::Result result = SyncMerge::prepareUpdate(post, remoteReply->posts().first(), this,
+                [this](const SyncMerge::Result& merged) {
+                    onPublishPrepared(merged);
+                });
+            if (result.outcome != SyncMerge::Pending) {
+                onPublishPrepared(result);
+            }
+        });
+    }
+
+    if (m_publishInFlight == 0 && m_publishQueue.isEmpty()) {
+        emitEvent("result", QJsonObject{{"published", m_saved}, {"failed", m_failed}});
+        finish(m_failed == 0 ? Success : RemoteError);
+    }
+}
+
+void CliRunner::onPublishPrepared(const SyncMerge::Result& result)
+{
+    switch (result.outcome) {
+    case SyncMerge::KeptLocal:
+    case SyncMerge::Merged:
+        // Merged时合并结果已经保存，只发送本地修改的部分
+        sendPublish(result.post);
+        return;
+    case SyncMerge::Conflict:
+        emitEvent("error", QJsonObject{{"id", result.post.id()}, {"fields", int(result.conflicts)},
+                                       {"message", "远程文章在上次同步后也被修改过，无法自动合并，没有发布"}});
+        break;
+    default:
+        emitEvent("error", QJsonObject{{"id", result.post.id()}, {"message", "保存合并结果失败"}});
+        break;
+    }
+
+    --m_publishInFlight;
+    ++m_failed;
+    publishNextPosts();
+}
+
+void CliRunner::sendPublish(Post post)
+{
+    // 有远程ID时更新，否则作为已发布文章创建
+    int localId = post.id();
+    post.setStatus(Post::Published);
+    ApiReply* reply = post.hasRemoteId()
+        ? WordPressAPI::instance().updatePost(post, DatabaseManager::instance().unsyncedFields(post))
+        : WordPressAPI::instance().createPost(post);
+    connect(reply, &ApiReply::finished, this, [this, reply, localId]() {
+        onPostPublished(reply, localId);
+    });
+}
+
+void CliRunner::onPostPublished(ApiReply* reply, int localId)
+{
+    --m_publishInFlight;
+
+    if (reply->hasError()) {
+        ++m_failed;
+        emitEvent("error", QJsonObject{{"id", localId}, {"message", reply->errorString()}});
+    } else {
+        Post post = reply->post();
+        post.setId(localId);
+        if (reply->isUnchanged()) {
+            // 没有修改，没有发送请求
+            ++m_saved;
+        } else if (DatabaseManager::instance().savePost(post)) {
+            DatabaseManager::instance().markSynced(post);
+            ++m_saved;
+        } else {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"id", localId}, {"message", "已发布，但保存远程ID失败"}});
+        }
+
+        emitEvent("progress", QJsonObject{{"id", localId}, {"remoteId", post.remoteId()},
+                                          {"done", m_saved + m_failed}, {"total", m_publishTotal}});
+    }
+
+    publishNextPosts();
+}
+
+void CliRunner::runExport()
+{
+    if (!openDatabase()) {
+        return;
+    }
+
+    // 文章列表不带正文，逐篇读取正文后写出
+    QList<Post> posts = DatabaseManager::instance().getAllPosts(m_publishedOnly);
+    QJsonArray array;
+    for (Post& post : posts) {
+        if (!DatabaseManager::instance().loadPostContent(post)) {
+            fail(IoError, QString("无法读取文章 %1 的正文").arg(post.id()));
+            return;
+        }
+        array.append(postToJson(post));
+        post.setContentLoaded(false);
+    }
+    QByteArray data = QJsonDocument(array).toJson(QJsonDocument::Indented);
+
+    if (m_eventsToStderr) {
+        std::fwrite(data.constData(), 1, static_cast<size_t>(data.size()), stdout);
+        std::fflush(stdout);
+    } else {
+        QFile file(m_outputPath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(data) != data.size()) {
+            fail(IoError, QString("无法写入文件 %1: %2").arg(m_outputPath, file.errorString()));
+            return;
+        }
+    }
+
+    emitEvent("result", QJsonObject{{"posts", posts.size()}, {"bytes", data.size()}});
+    finish(Success);
+}
+
+void CliRunner::runImport()
+{
+    if (!openDatabase()) {
+        return;
+    }
+
+    QString path = m_positional.first();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        fail(IoError, QString("无法读取文件 %1: %2").arg(path, file.errorString()));
+        return;
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isArray()) {
+        fail(IoError, QString("导入文件格式无效: %1").arg(parseError.errorString()));
+        return;
+    }
+
+    QJsonArray array = document.array();
+    emitEvent("start", QJsonObject{{"posts", array.size()}});
+
+    QSqlDatabase db = QSqlDatabase::database();
+    db.transaction();
+    for (int i = 0; i < array.size(); ++i) {
+        Post post = postFromJson(array.at(i).toObject());
+        if (DatabaseManager::instance().savePost(post)) {
+            ++m_saved;
+        } else {
+            ++m_failed;
+            emitEvent("error", QJsonObject{{"index", i}, {"message", "保存文章失败"}});
+        }
+
+        if ((i + 1) % 100 == 0) {
+            emitEvent("progress", QJsonObject{{"done", i + 1}, {"total", array.size()}});
+        }
+    }
+    db.commit();
+
+    emitEvent("result", QJsonObject{{"imported", m_saved}, {"failed", m_failed}});
+    finish(m_failed == 0 ? Success : IoError);
+}
+
+void CliRunner::runStats()
+{
+    if (!openDatabase()) {
+        return;
+    }
+
+    DatabaseManager& db = DatabaseManager::instance();
+    int total = db.postCount();
+    int published = db.postCount(true);
+    QString databaseName = QSqlDatabase::database().databaseName();
+
+    QJsonObject fields;
+    fields["site"] = m_site.id;
+    fields["database"] = databaseName;
+    fields["databaseBytes"] = QFileInfo(databaseName).size();
+    fields["posts"] = total;
+    fields["published"] = published;
+    fields["drafts"] = total - published;
+    fields["categories"] = db.getAllCategories().size();
+    fields["tags"] = db.getAllTags().size();
+
+    QDateTime lastSync = SiteProfiles::lastSyncTime(m_site.id);
+    if (lastSync.isValid()) {
+        fields["lastSyncTime"] = lastSync.toUTC().toString(Qt::ISODate);
+    }
+
+    emitEvent("result", fields);
+    finish(Success);
+}
+
+void CliRunner::runSites()
+{
+    QString currentId = SiteProfiles::current().id;
+    QJsonArray sites;
+    for (const SiteProfile& site : SiteProfiles::all()) {
+        QJsonObject object;
+        object["id"] = site.id;
+        object["name"] = site.displayName();
+        object["url"] = site.apiUrl;
+        object["configured"] = site.isConfigured();
+        object["current"] = site.id == currentId;
+        object["database"] = site.databasePath();
+        QDateTime lastSync = SiteProfiles::lastSyncTime(site.id);
+        if (lastSync.isValid()) {
+            object["lastSyncTime"] = lastSync.toUTC().toString(Qt::ISODate);
+        }
+        sites.append(object);
+    }
+
+    emitEvent("result", QJsonObject{{"sites", sites}});
+    finish(Success);
+}
+
+void CliRunner::runAllSites()
+{
+    QStringList siteIds;
+    QJsonArray skipped;
+    for (const SiteProfile& site : SiteProfiles::all()) {
+        if (site.isConfigured()) {
+            siteIds.append(site.id);
+        } else {
+            skipped.append(site.id);
+        }
+    }
+    if (siteIds.isEmpty()) {
+        fail(ConfigError, "没有已配置API信息的站点，请在图形界面的设置中填写");
+        return;
+    }
+
+    emitEvent("start", QJsonObject{{"mode", "all-sites"}, {"sites", QJsonArray::fromStringList(siteIds)},
+                                   {"skipped", skipped}, {"parallelSites", m_parallelSites}});
+
+    m_scheduler = new SyncScheduler(m_siteArguments, m_parallelSites, this);
+    connect(m_scheduler, &SyncScheduler::siteEvent, this, &CliRunner::onSiteEvent);
+    connect(m_scheduler, &SyncScheduler::siteFinished, this, &CliRunner::onSiteFinished);
+    connect(m_scheduler, &SyncScheduler::finished, this, [this]() {
+        emitEvent("result", QJsonObject{{"sites", m_sitesDone},
+                                        {"failedSites", QJsonArray::fromStringList(m_failedSites)}});
+        finish(m_failedSites.isEmpty() ? Success : RemoteError);
+    });
+    m_scheduler->start(siteIds);
+}
+
+void CliRunner::onSiteEvent(const QString& siteId, QJsonObject event)
+{
+    // 子进程的done只表示它自己结束，汇总在onSiteFinished中进行
+    QString name = event.take("event").toString();
+    if (name == "done") {
+        return;
+    }
+    if (name == "result") {
+        m_siteResults.insert(siteId, event);
+    }
+
+    event["site"] = siteId;
+    emitEvent(name, event);
+}
+
+void CliRunner::onSiteFinished(const QString& siteId, int exitCode)
+{
+    QJsonObject summary = m_siteResults.take(siteId);
+    summary.remove("command");
+    summary["site"] = siteId;
+    summary["exitCode"] = exitCode;
+    m_sitesDone.append(summary);
+    if (exitCode != Success) {
+        m_failedSites.append(siteId);
+    }
+
+    emitEvent("progress", QJsonObject{{"phase", "sites"}, {"site", siteId}, {"exitCode", exitCode},
+                                      {"done", m_sitesDone.size()}, {"running", m_scheduler->runningCount()}});
+}
+
+bool CliRunner::configureApi()
+{
+    QString url = m_apiUrl.isEmpty() ? m_site.apiUrl : m_apiUrl;
+    QString username = m_username.isEmpty() ? m_site.username : m_username;
+    // 使用已保存的站点地址时只用该站点保存的密码，--password和BLOGCLIENT_PASSWORD只在指定--url
+    // 或站点没有保存地址时生效，避免把一个站点的密码发给另一个站点的服务器
+    bool storedProfile = m_apiUrl.isEmpty() && !m_site.apiUrl.isEmpty();
+    QString password = storedProfile || m_password.isEmpty() ? m_site.password : m_password;
+
+    if (url.isEmpty() || username.isEmpty() || password.isEmpty()) {
+        fail(ConfigError, QString("缺少站点 %1 的WordPress API配置，请在图形界面的设置中填写，或使用 --url/--user/--password")
+                              .arg(m_site.id));
+        return false;
+    }
+
+    WordPressAPI::setCurrentSession(m_site.id);
+    WordPressAPI::instance().setApiUrl(url);
+    WordPressAPI::instance().setCredentials(username, password);
+    WordPressAPI::instance().warmUp();
+    return true;
+}
+
+bool CliRunner::openDatabase()
+{
+    bool ok = DatabaseManager::instance().initialize(m_databasePath.isEmpty() ? m_site.databasePath()
+                                                                              : m_databasePath);
+    if (!ok) {
+        fail(ConfigError, "数据库初始化失败");
+    }
+    return ok;
+}
+
+QJsonObject CliRunner::postToJson(const Post& post)
+{
+    QJsonObject object;
+    object["id"] = post.id();
+    if (post.hasRemoteId()) {
+        object["remoteId"] = post.remoteId();
+    }
+    object["title"] = post.title();
+    object["content"] = post.content();
+    object["excerpt"] = post.excerpt();
+    object["publishDate"] = post.publishDate().toString(Qt::ISODate);
+    object["author"] = post.author();
+    object["status"] = post.status() == Post::Published ? "publish" : "draft";
+    object["featuredImageUrl"] = post.featuredImageUrl();
+    object["categories"] = QJsonArray::fromStringList(post.categories());
+    object["tags"] = QJsonArray::fromStringList(post.tags());
+    return object;
+}
+
+Post CliRunner::postFromJson(const QJsonObject& object)
+{
+    // 本地ID不导入，由目标数据库分配；带远程ID的文章会与已有记录合并
+    Post post(-1, object["title"].toString(), object["content"].toString(), object["excerpt"].toString(),
+              QDateTime::fromString(object["publishDate"].toString(), Qt::ISODate),
+              object["author"].toString(),
+              object["status"].toString() == "publish" ? Post::Published : Post::Draft);
+    post.setRemoteId(object["remoteId"].toInt(-1));
+    post.setFeaturedImageUrl(object["featuredImageUrl"].toString());
+
+    for (const QJsonValue& value : object["categories"].toArray()) {
+        post.addCategory(value.toString());
+    }
+    for (const QJsonValue& value : object["tags"].toArray()) {
+        post.addTag(value.toString());
+    }
+    return post;
+}
+
+void CliRunner::emitEvent(const QString& event, QJsonObject fields)
+{
+    if (m_quiet && event == "progress") {
+        return;
+    }
+
+    fields["event"] = event;
+    fields["command"] = m_command;
+    writeLine(m_eventsToStderr ? stderr : stdout, QJsonDocument(fields).toJson(QJsonDocument::Compact));
+}
+
+void CliRunner::fail(int exitCode, const QString& message)
+{
+    emitEvent("error", QJsonObject{{"message", message}});
+    finish(exitCode);
+}
+
+void CliRunner::finish(int exitCode)
+{
+    if (m_done) {
+        return;
+    }
+    m_done = true;
+    m_exitCode = exitCode;
+
+    QJsonObject fields;
+    fields["exitCode"] = exitCode;
+    fields["elapsedMs"] = m_elapsed.elapsed();
+
+    if (m_trace) {
+        QJsonArray spans;
+        for (const SpanSummary& summary : TraceStats::instance().spans()) {
+            spans.append(QJsonObject{
+                {"name", summary.name},
+                {"count", summary.count},
+                {"p50Ms", summary.p50Ms},
+                {"p95Ms", summary.p95Ms},
+                {"totalMs", summary.totalMs},
+                {"bytes", summary.bytes},
+                {"rows", summary.rows}
+            });
+        }
+        fields["spans"] = spans;
+    }
+
+    emitEvent("done", fields);
+    emit finished(exitCode);
+}
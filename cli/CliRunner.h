@@ -0,0 +1,153 @@
+#pragma once
+
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "models/Post.h"
+#include "models/PostIndex.h"
+#include "database/SyncMerge.h"
+#include "database/SiteProfiles.h"
+
+class ApiReply;
+class SyncScheduler;
+
+// 命令行工具的执行器
+// 所有命令都由事件循环驱动：网络请求并发发出，结果在回复完成时依次写入数据库。
+// 进度以JSON Lines输出（每行一个事件对象），结束时发出finished(退出码)。
+class CliRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum ExitCode {
+        Success = 0,
+        UsageError = 1,     // 命令行参数错误
+        ConfigError = 2,    // 数据库或API配置不可用
+        RemoteError = 3,    // 部分或全部远程请求失败
+        IoError = 4         // 读写导入导出文件失败
+    };
+
+    explicit CliRunner(QObject* parent = nullptr);
+
+    // 解析命令行参数；返回false时应以exitCode()退出
+    bool parseArguments(const QStringList& arguments);
+    int exitCode() const;
+
+    // 开始执行解析到的命令
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private:
+    // 各个命令
+    void runSync();
+    void runReconcile();
+    void runPublish();
+    void runExport();
+    void runImport();
+    void runStats();
+    void runSites();
+    // sync --all-sites：由SyncScheduler在子进程中同时同步多个站点
+    void runAllSites();
+    void onSiteEvent(const QString& siteId, QJsonObject event);
+    void onSiteFinished(const QString& siteId, int exitCode);
+
+    // 同步：先获取分类和标签，再按页并发获取文章
+    void onTermsFetched();
+    void requestNextPages();
+    void onPageFetched(ApiReply* reply);
+    void updateTotalPages(const ApiReply* reply, int received);
+    // 后台合并的结果，以及没有同步基线、直接判定为冲突的文章
+    void onPostMerged(const SyncMerge::Result& result);
+    void finishSync();
+
+    // 对比：只获取远程文章的ID和修改时间，与本地文章归并对比
+    void onIndexPageFetched(ApiReply* reply);
+    void finishReconcile();
+
+    // 发布：按队列并发创建或更新远程文章
+    // 有未同步修改的已同步文章先获取远程版本，远程也修改过时与本地修改合并（SyncMerge::prepareUpdate()），
+    // 无法合并的不发布，按失败报告
+    void publishNextPosts();
+    void onPublishPrepared(const SyncMerge::Result& result);
+    void sendPublish(Post post);
+    void onPostPublished(ApiReply* reply, int localId);
+
+    bool configureApi();
+    bool openDatabase();
+
+    // 文章与导出格式之间的转换
+    static QJsonObject postToJson(const Post& post);
+    static Post postFromJson(const QJsonObject& object);
+
+    // 输出一行事件
+    void emitEvent(const QString& event, QJsonObject fields = QJsonObject());
+    void fail(int exitCode, const QString& message);
+    void finish(int exitCode);
+
+    // 命令行参数
+    QString m_command;
+    QStringList m_positional;
+    SiteProfile m_site;
+    bool m_allSites;
+    int m_parallelSites;
+    QStringList m_siteArguments;    // --all-sites时传给每个站点子进程的参数
+    QString m_databasePath;
+    QString m_apiUrl;
+    QString m_username;
+    QString m_password;
+    QString m_outputPath;
+    int m_concurrency;
+    int m_perPage;
+    bool m_deltaSync;
+    QDateTime m_since;
+    bool m_publishedOnly;
+    bool m_dryRun;
+    bool m_quiet;
+    bool m_trace;
+    bool m_eventsToStderr;
+
+    int m_exitCode;
+    bool m_done;
+    QElapsedTimer m_elapsed;
+
+    // 同步状态
+    QDateTime m_latestModified;     // 获取到的文章中最晚的modified_gmt（服务器时钟），作为下次增量同步的起点
+    QDateTime m_modifiedAfter;
+    int m_pendingTermRequests;
+    int m_nextPage;
+    int m_totalPages;
+    int m_pagesInFlight;
+    int m_pagesDone;
+    int m_saved;
+    int m_unchanged;    // 与本地已有内容相同、没有写入的文章
+    int m_failed;
+    int m_keptLocal;        // 本地有未同步的修改、远程没有修改，保留本地版本的文章
+    int m_merged;           // 两边都修改过、已自动合并的文章
+    int m_mergesPending;    // 正在后台合并的文章
+    QList<int> m_conflicts; // 无法自动合并的文章（本地ID）
+
+    // 对比状态
+    QList<PostIndex::Stamp> m_remoteStamps;
+    int m_remoteTotal;      // 第一页报告的远程文章总数，未知时为-1
+    bool m_indexChanged;    // 获取期间总数发生了变化
+
+    // 多站点同步状态
+    SyncScheduler* m_scheduler;
+    QHash<QString, QJsonObject> m_siteResults;  // 各站点子进程的result事件
+    QJsonArray m_sitesDone;
+    QStringList m_failedSites;
+
+    // 发布状态
+    QList<int> m_publishQueue;
+    int m_publishInFlight;
+    int m_publishTotal;
+};
@@ -0,0 +1,91 @@
+#include "SyncScheduler.h"
+#include <QCoreApplication>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QProcessEnvironment>
+
+SyncScheduler::SyncScheduler(const QStringList& arguments, int parallelism, QObject* parent)
+    : QObject(parent),
+      m_arguments(arguments),
+      m_parallelism(parallelism)
+{
+}
+
+void SyncScheduler::start(const QStringList& siteIds)
+{
+    m_queue = siteIds;
+    startNext();
+}
+
+int SyncScheduler::runningCount() const
+{
+    return m_running.size();
+}
+
+void SyncScheduler::startNext()
+{
+    while (m_running.size() < m_parallelism && !m_queue.isEmpty()) {
+        QString siteId = m_queue.takeFirst();
+
+        QProcess* process = new QProcess(this);
+        // 子进程的标准错误（日志）直接输出，标准输出是需要转发的事件
+        process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        // 子进程使用各自站点保存的密码，不继承为单个站点准备的BLOGCLIENT_PASSWORD
+        QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+        environment.remove("BLOGCLIENT_PASSWORD");
+        process->setProcessEnvironment(environment);
+        connect(process, &QProcess::readyReadStandardOutput, this, [this, siteId, process]() {
+            readEvents(siteId, process);
+        });
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+                [this, siteId, process](int exitCode, QProcess::ExitStatus status) {
+            onProcessFinished(siteId, process, status == QProcess::NormalExit ? exitCode : -1);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, siteId, process](QProcess::ProcessError error) {
+            // 启动失败时不会再发出finished
+            if (error == QProcess::FailedToStart) {
+                onProcessFinished(siteId, process, -1);
+            }
+        });
+
+        m_running.insert(siteId, process);
+        process->start(QCoreApplication::applicationFilePath(),
+                       QStringList() << "sync" << "--site" << siteId << m_arguments);
+    }
+
+    if (m_running.isEmpty() && m_queue.isEmpty()) {
+        emit finished();
+    }
+}
+
+void SyncScheduler::readEvents(const QString& siteId, QProcess* process)
+{
+    while (process->canReadLine()) {
+        QByteArray line = process->readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        QJsonParseError error;
+        QJsonDocument document = QJsonDocument::fromJson(line, &error);
+        if (error.error != QJsonParseError::NoError || !document.isObject()) {
+            continue;
+        }
+        emit siteEvent(siteId, document.object());
+    }
+}
+
+void SyncScheduler::onProcessFinished(const QString& siteId, QProcess* process, int exitCode)
+{
+    if (m_running.value(siteId) != process) {
+        return;
+    }
+
+    // 最后一行可能没有在readyRead中读完
+    readEvents(siteId, process);
+    m_running.remove(siteId);
+    process->deleteLater();
+
+    emit siteFinished(siteId, exitCode);
+    startNext();
+}
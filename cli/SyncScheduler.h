@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QHash>
+#include <QJsonObject>
+#include <QObject>
+#include <QProcess>
+#include <QStringList>
+
+// 多个站点的同步调度
+// 每个站点的同步在自己的子进程中运行（blogclient-cli sync --site <id>），各自打开站点的数据库和API会话，
+// 互不影响；调度器限制同时运行的站点数，子进程输出的JSON Lines事件逐行转发。
+class SyncScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // arguments：传给每个子进程的其余参数（--full、--concurrency等）
+    SyncScheduler(const QStringList& arguments, int parallelism, QObject* parent = nullptr);
+
+    void start(const QStringList& siteIds);
+    int runningCount() const;
+
+signals:
+    // 子进程输出的一个事件
+    void siteEvent(const QString& siteId, const QJsonObject& event);
+    // exitCode为-1表示子进程无法启动或异常退出
+    void siteFinished(const QString& siteId, int exitCode);
+    void finished();
+
+private:
+    void startNext();
+    void readEvents(const QString& siteId, QProcess* process);
+    void onProcessFinished(const QString& siteId, QProcess* process, int exitCode);
+
+    QStringList m_arguments;
+    int m_parallelism;
+    QStringList m_queue;
+    QHash<QString, QProcess*> m_running;
+};
@@ -0,0 +1,23 @@
+#include <QCoreApplication>
+#include <QTimer>
+
+#include "CliRunner.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    // 与图形界面共用设置和数据库位置
+    QCoreApplication::setOrganizationName("PersonalBlog");
+    QCoreApplication::setApplicationName("BlogClient");
+    
+    CliRunner runner;
+    if (!runner.parseArguments(app.arguments())) {
+        return runner.exitCode();
+    }
+    
+    QObject::connect(&runner, &CliRunner::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+    QTimer::singleShot(0, &runner, &CliRunner::start);
+    
+    return app.exec();
+}
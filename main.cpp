@@ -2,6 +2,8 @@
 #include <QtWidgets/QApplication>
 #include <QSettings>
 #include "src/database/DatabaseManager.h"
+#include "src/database/SiteProfiles.h"
+#include "src/api/WordPressAPI.h"
 #include <QDebug>
 
 int main(int argc, char *argv[])
@@ -12,8 +14,10 @@ int main(int argc, char *argv[])
     QCoreApplication::setOrganizationName("PersonalBlog");
     QCoreApplication::setApplicationName("BlogClient");
     
-    // 初始化数据库
-    if (!DatabaseManager::instance().initialize()) {
+    // 打开当前站点的数据库，并使用这个站点的API会话
+    SiteProfile site = SiteProfiles::current();
+    WordPressAPI::setCurrentSession(site.id);
+    if (!DatabaseManager::instance().initialize(site.databasePath())) {
         qDebug() << "数据库初始化失败，应用程序可能无法正常工作";
     } else {
         qDebug() << "数据库初始化成功";
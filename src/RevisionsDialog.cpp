@@ -0,0 +1,116 @@
+#include "RevisionsDialog.h"
+#include "database/DatabaseManager.h"
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QDialogButtonBox>
+#include <QSplitter>
+
+RevisionsDialog::RevisionsDialog(int postId, QWidget *parent)
+    : QDialog(parent), m_postId(postId)
+{
+    setWindowTitle(tr("修订历史"));
+    resize(800, 560);
+    
+    // 修订列表
+    m_revisionsTable = new QTableWidget(this);
+    m_revisionsTable->setColumnCount(4);
+    m_revisionsTable->setHorizontalHeaderLabels({
+        tr("修订"), tr("时间"), tr("类型"), tr("大小 / 占用 (字节)")
+    });
+    m_revisionsTable->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    m_revisionsTable->verticalHeader()->setVisible(false);
+    m_revisionsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_revisionsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_revisionsTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    
+    // 所选修订的内容
+    m_preview = new QPlainTextEdit(this);
+    m_preview->setReadOnly(true);
+    
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(m_revisionsTable);
+    splitter->addWidget(m_preview);
+    splitter->setStretchFactor(1, 1);
+    
+    m_summaryLabel = new QLabel(this);
+    
+    // 创建按钮
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    m_restoreButton = buttonBox->addButton(tr("恢复此版本"), QDialogButtonBox::AcceptRole);
+    m_restoreButton->setEnabled(false);
+    
+    // 连接信号和槽
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &RevisionsDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &RevisionsDialog::reject);
+    connect(m_revisionsTable, &QTableWidget::itemSelectionChanged, this, &RevisionsDialog::onSelectionChanged);
+    
+    // 创建主布局
+    QVBoxLayout *mainLayout = new QVBoxLayout;
+    mainLayout->addWidget(splitter);
+    mainLayout->addWidget(m_summaryLabel);
+    mainLayout->addWidget(buttonBox);
+    setLayout(mainLayout);
+    
+    loadRevisions();
+}
+
+RevisionsDialog::~RevisionsDialog()
+{
+}
+
+int RevisionsDialog::selectedRevision() const
+{
+    int row = m_revisionsTable->currentRow();
+    if (row < 0) {
+        return 0;
+    }
+    return m_revisionsTable->item(row, 0)->data(Qt::UserRole).toInt();
+}
+
+void RevisionsDialog::loadRevisions()
+{
+    QList<DatabaseManager::RevisionInfo> revisions = DatabaseManager::instance().getRevisions(m_postId);
+    
+    m_revisionsTable->setRowCount(revisions.size());
+    qint64 fullBytes = 0;
+    qint64 storedBytes = 0;
+    
+    for (int row = 0; row < revisions.size(); ++row) {
+        const DatabaseManager::RevisionInfo &info = revisions.at(row);
+        
+        QTableWidgetItem *revisionItem = new QTableWidgetItem(QString::number(info.revision));
+        revisionItem->setData(Qt::UserRole, info.revision);
+        m_revisionsTable->setItem(row, 0, revisionItem);
+        m_revisionsTable->setItem(row, 1, new QTableWidgetItem(info.createdAt.toString("yyyy-MM-dd HH:mm:ss")));
+        m_revisionsTable->setItem(row, 2, new QTableWidgetItem(info.snapshot ? tr("快照") : tr("差异")));
+        m_revisionsTable->setItem(row, 3, new QTableWidgetItem(QString("%1 / %2").arg(info.fullSize).arg(info.storedSize)));
+        
+        fullBytes += info.fullSize;
+        storedBytes += info.storedSize;
+    }
+    
+    m_revisionsTable->resizeColumnsToContents();
+    m_summaryLabel->setText(tr("共 %1 个修订，完整保存需要 %2 字节，实际占用 %3 字节")
+        .arg(revisions.size())
+        .arg(fullBytes)
+        .arg(storedBytes));
+}
+
+void RevisionsDialog::onSelectionChanged()
+{
+    int revision = selectedRevision();
+    m_restoreButton->setEnabled(revision > 0);
+    if (revision <= 0) {
+        m_preview->clear();
+        return;
+    }
+    
+    Post post = DatabaseManager::instance().getRevision(m_postId, revision);
+    if (post.id() <= 0) {
+        m_preview->setPlainText(tr("无法还原这个修订。"));
+        m_restoreButton->setEnabled(false);
+        return;
+    }
+    
+    m_preview->setPlainText(post.title() + "\n\n" + post.content());
+}
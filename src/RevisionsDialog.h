@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QPlainTextEdit>
+#include <QLabel>
+#include <QPushButton>
+
+// 修订历史对话框：列出文章的本地修订，预览所选修订的内容，可以选择一个修订恢复到编辑器
+class RevisionsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    RevisionsDialog(int postId, QWidget *parent = nullptr);
+    ~RevisionsDialog();
+
+    // 接受对话框时选中的修订号
+    int selectedRevision() const;
+
+private slots:
+    void onSelectionChanged();
+
+private:
+    void loadRevisions();
+
+    int m_postId;
+    QTableWidget *m_revisionsTable;
+    QPlainTextEdit *m_preview;
+    QLabel *m_summaryLabel;
+    QPushButton *m_restoreButton;
+};
@@ -3,9 +3,11 @@
 #include <QVBoxLayout>
 #include <QGroupBox>
 #include <QMessageBox>
+#include <QHBoxLayout>
+#include <QInputDialog>
 
 SettingsDialog::SettingsDialog(QWidget *parent)
-    : QDialog(parent)
+    : QDialog(parent), m_siteIndex(-1)
 {
     setWindowTitle(tr("博客API设置"));
     setMinimumWidth(400);
@@ -13,6 +15,19 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     // 创建表单布局
     QFormLayout *formLayout = new QFormLayout;
     
+    // 站点：每个站点有自己的API信息和本地数据库
+    m_siteCombo = new QComboBox(this);
+    m_addSiteButton = new QPushButton(tr("新建站点"), this);
+    m_removeSiteButton = new QPushButton(tr("删除站点"), this);
+    QHBoxLayout *siteLayout = new QHBoxLayout;
+    siteLayout->addWidget(m_siteCombo, 1);
+    siteLayout->addWidget(m_addSiteButton);
+    siteLayout->addWidget(m_removeSiteButton);
+    formLayout->addRow(tr("站点:"), siteLayout);
+    
+    m_siteNameEdit = new QLineEdit(this);
+    formLayout->addRow(tr("站点名称:"), m_siteNameEdit);
+    
     // API URL
     m_apiUrlEdit = new QLineEdit(this);
     formLayout->addRow(tr("WordPress API URL:"), m_apiUrlEdit);
@@ -43,10 +58,20 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     connect(buttonBox, &QDialogButtonBox::accepted, this, &SettingsDialog::saveSettings);
     connect(buttonBox, &QDialogButtonBox::rejected, this, &SettingsDialog::reject);
     connect(m_testButton, &QPushButton::clicked, this, &SettingsDialog::testConnection);
+    connect(m_siteCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsDialog::onSiteChanged);
+    connect(m_addSiteButton, &QPushButton::clicked, this, &SettingsDialog::addSite);
+    connect(m_removeSiteButton, &QPushButton::clicked, this, &SettingsDialog::removeSite);
+    
+    // 连接测试结果（延迟信息）
+    m_latencyLabel = new QLabel(this);
+    m_latencyLabel->setWordWrap(true);
+    m_latencyLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    m_latencyLabel->hide();
     
     // 创建主布局
     QVBoxLayout *mainLayout = new QVBoxLayout;
     mainLayout->addWidget(apiGroupBox);
+    mainLayout->addWidget(m_latencyLabel);
     mainLayout->addWidget(buttonBox);
     
     setLayout(mainLayout);
@@ -63,26 +88,123 @@ void SettingsDialog::loadSettings()
 {
     QSettings settings;
     
-    // 加载API设置
-    m_apiUrlEdit->setText(settings.value("api/url").toString());
-    m_usernameEdit->setText(settings.value("api/username").toString());
-    m_passwordEdit->setText(settings.value("api/password").toString());
+    // 加载站点列表，默认显示当前站点
+    m_sites = SiteProfiles::all();
+    QString currentId = SiteProfiles::current().id;
+    for (const SiteProfile& site : m_sites) {
+        m_siteCombo->addItem(site.displayName(), site.id);
+    }
+    m_siteCombo->setCurrentIndex(m_siteCombo->findData(currentId));
+    
     m_userNameEdit->setText(settings.value("user/name").toString());
 }
 
+void SettingsDialog::storeSiteFields()
+{
+    if (m_siteIndex < 0 || m_siteIndex >= m_sites.size()) {
+        return;
+    }
+    
+    SiteProfile& site = m_sites[m_siteIndex];
+    site.name = m_siteNameEdit->text();
+    site.apiUrl = m_apiUrlEdit->text();
+    site.username = m_usernameEdit->text();
+    site.password = m_passwordEdit->text();
+    m_siteCombo->setItemText(m_siteIndex, site.displayName());
+}
+
+void SettingsDialog::showSiteFields()
+{
+    SiteProfile site = m_siteIndex >= 0 && m_siteIndex < m_sites.size() ? m_sites[m_siteIndex] : SiteProfile();
+    m_siteNameEdit->setText(site.name);
+    m_apiUrlEdit->setText(site.apiUrl);
+    m_usernameEdit->setText(site.username);
+    m_passwordEdit->setText(site.password);
+    m_removeSiteButton->setEnabled(m_sites.size() > 1);
+    m_latencyLabel->hide();
+}
+
+void SettingsDialog::onSiteChanged(int index)
+{
+    storeSiteFields();
+    m_siteIndex = index;
+    showSiteFields();
+}
+
+void SettingsDialog::addSite()
+{
+    bool ok = false;
+    QString id = QInputDialog::getText(this, tr("新建站点"),
+        tr("站点标识（字母、数字、-和_，用于数据库文件名和命令行的--site）:"),
+        QLineEdit::Normal, QString(), &ok).trimmed();
+    if (!ok || id.isEmpty()) {
+        return;
+    }
+    
+    if (!SiteProfiles::isValidId(id) || m_siteCombo->findData(id) >= 0) {
+        QMessageBox::warning(this, tr("输入错误"),
+            tr("站点标识 %1 无效或已存在。").arg(id),
+            QMessageBox::Ok);
+        return;
+    }
+    
+    SiteProfile site;
+    site.id = id;
+    m_sites.append(site);
+    m_removedSites.removeAll(id);
+    m_siteCombo->addItem(site.displayName(), site.id);
+    m_siteCombo->setCurrentIndex(m_siteCombo->count() - 1);
+}
+
+void SettingsDialog::removeSite()
+{
+    if (m_siteIndex < 0 || m_sites.size() <= 1) {
+        return;
+    }
+    
+    SiteProfile site = m_sites[m_siteIndex];
+    QMessageBox::StandardButton result = QMessageBox::question(this, tr("删除站点"),
+        tr("确定删除站点 %1 吗？\n本地数据库文件不会删除：%2").arg(site.displayName(), site.databasePath()),
+        QMessageBox::Yes | QMessageBox::No);
+    if (result != QMessageBox::Yes) {
+        return;
+    }
+    
+    // 先取消当前站点，删除列表项时不再把编辑框的内容写回被删除的站点
+    int index = m_siteIndex;
+    m_siteIndex = -1;
+    m_sites.removeAt(index);
+    m_removedSites.append(site.id);
+    m_siteCombo->removeItem(index);
+    m_siteIndex = m_siteCombo->currentIndex();
+    showSiteFields();
+}
+
 void SettingsDialog::saveSettings()
 {
     QSettings settings;
+    storeSiteFields();
     
-    // 保存API设置
-    settings.setValue("api/url", m_apiUrlEdit->text());
-    settings.setValue("api/username", m_usernameEdit->text());
-    settings.setValue("api/password", m_passwordEdit->text());
+    // 保存站点和用户设置
+    for (const QString& id : m_removedSites) {
+        SiteProfiles::remove(id);
+    }
+    for (const SiteProfile& site : m_sites) {
+        SiteProfiles::save(site);
+    }
     settings.setValue("user/name", m_userNameEdit->text());
     
     // 确保立即保存设置到磁盘
     settings.sync();
     
+    // 设置变更后立即预热到正在编辑的站点的连接
+    if (!m_apiUrlEdit->text().isEmpty()) {
+        WordPressAPI& api = WordPressAPI::session(m_sites[m_siteIndex].id);
+        api.setApiUrl(m_apiUrlEdit->text());
+        api.setCredentials(m_usernameEdit->text(), m_passwordEdit->text());
+        api.warmUp();
+    }
+    
     // 显示保存成功提示
     QMessageBox::information(this, tr("设置已保存"), 
         tr("API设置已成功保存。现在可以使用远程功能了。"),
@@ -110,32 +232,57 @@ void SettingsDialog::testConnection()
         return;
     }
     
-    // 设置API信息
-    WordPressAPI::instance().setApiUrl(apiUrl);
-    WordPressAPI::instance().setCredentials(username, password);
+    // 设置API信息（使用正在编辑的站点自己的会话）
+    WordPressAPI& api = WordPressAPI::session(m_sites[m_siteIndex].id);
+    api.setApiUrl(apiUrl);
+    api.setCredentials(username, password);
     
-    // 连接API错误信号
-    connect(&WordPressAPI::instance(), &WordPressAPI::error, this, [this](const QString& error) {
-        QMessageBox::critical(this, tr("连接失败"), 
-            tr("API连接测试失败：%1").arg(error),
-            QMessageBox::Ok);
+    // 测试连接 - 只请求当前用户的id和名称，不下载文章
+    // 结果只通过本次请求的句柄返回，不会触发主窗口保存文章
+    m_latencyLabel->setText(tr("正在测试连接..."));
+    m_latencyLabel->show();
+    
+    ApiReply* reply = api.probeConnection();
+    connect(reply, &ApiReply::finished, this, [this, reply, session = &api]() {
         m_testButton->setEnabled(true);
         
-        // 断开连接，避免多次触发
-        disconnect(&WordPressAPI::instance(), &WordPressAPI::error, this, nullptr);
-    });
-    
-    // 连接成功信号
-    connect(&WordPressAPI::instance(), &WordPressAPI::postsReceived, this, [this](const QList<Post>&) {
+        if (reply->hasError()) {
+            m_latencyLabel->setText(tr("连接失败"));
+            QMessageBox::critical(this, tr("连接失败"), 
+                tr("API连接测试失败：%1").arg(reply->errorString()),
+                QMessageBox::Ok);
+            return;
+        }
+        
+        // 显示各阶段耗时，复用已有连接时没有握手耗时
+        RequestTiming timing = reply->timing();
+        auto formatMs = [this](qint64 ms) {
+            return ms < 0 ? tr("无") : tr("%1 ms").arg(ms);
+        };
+        QString serverTime = timing.serverMs < 0
+            ? tr("服务器未提供")
+            : tr("%1 ms").arg(timing.serverMs, 0, 'f', 1);
+        WordPressAPI::ConnectionStats stats = session->connectionStats();
+        m_latencyLabel->setText(tr("往返时间(RTT): %1\nTLS握手: %2\n服务器处理: %3\n总耗时: %4\n"
+                                   "连接: 请求 %5 / TLS握手 %6（携带会话票据 %7）/ 复用连接 %8\n"
+                                   "协议: %9（HTTP/2 %10 / HTTP/1.1 %11，最大并发流 %12）")
+            .arg(formatMs(timing.roundTripMs()))
+            .arg(formatMs(timing.tlsHandshakeMs()))
+            .arg(serverTime)
+            .arg(formatMs(timing.totalMs))
+            .arg(stats.requests)
+            .arg(stats.tlsHandshakes)
+            .arg(stats.ticketHandshakes)
+            .arg(stats.reusedConnections)
+            .arg(reply->protocol())
+            .arg(stats.http2Requests)
+            .arg(stats.http1Requests)
+            .arg(stats.peakHttp2Streams));
+        
         QMessageBox::information(this, tr("连接成功"), 
-            tr("WordPress API连接测试成功！\n\n请点击\"确定\"按钮保存这些设置。"),
+            tr("WordPress API连接测试成功！\n当前用户: %1 (ID: %2)\n\n请点击\"确定\"按钮保存这些设置。")
+                .arg(reply->userName())
+                .arg(reply->userId()),
             QMessageBox::Ok);
-        m_testButton->setEnabled(true);
-        
-        // 断开连接，避免多次触发
-        disconnect(&WordPressAPI::instance(), &WordPressAPI::postsReceived, this, nullptr);
     });
-    
-    // 测试连接 - 尝试获取文章列表
-    WordPressAPI::instance().fetchPosts();
-} 
\ No newline at end of file
+}
@@ -7,6 +7,9 @@
 #include <QSettings>
 #include <QPushButton>
 #include <QLabel>
+#include <QComboBox>
+#include <QStringList>
+#include "database/SiteProfiles.h"
 
 class SettingsDialog : public QDialog
 {
@@ -19,13 +22,29 @@ public:
 private slots:
     void saveSettings();
     void testConnection();
+    void onSiteChanged(int index);
+    void addSite();
+    void removeSite();
 
 private:
     void loadSettings();
+    // 编辑框和m_sites中当前站点之间的同步
+    void storeSiteFields();
+    void showSiteFields();
 
+    // 各站点的修改在点击"确定"后才保存
+    QList<SiteProfile> m_sites;
+    QStringList m_removedSites;
+    int m_siteIndex;
+
+    QComboBox *m_siteCombo;
+    QPushButton *m_addSiteButton;
+    QPushButton *m_removeSiteButton;
+    QLineEdit *m_siteNameEdit;
     QLineEdit *m_apiUrlEdit;
     QLineEdit *m_usernameEdit;
     QLineEdit *m_passwordEdit;
     QLineEdit *m_userNameEdit;
     QPushButton *m_testButton;
+    QLabel *m_latencyLabel;
 }; 
\ No newline at end of file
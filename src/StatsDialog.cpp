@@ -0,0 +1,125 @@
+#include "StatsDialog.h"
+#include "api/WordPressAPI.h"
+#include "diagnostics/Tracing.h"
+#include "models/StringPool.h"
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QDialogButtonBox>
+#include <cmath>
+
+StatsDialog::StatsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("性能统计"));
+    resize(760, 480);
+    
+    // 耗时统计表
+    m_spansTable = new QTableWidget(this);
+    m_spansTable->setColumnCount(7);
+    m_spansTable->setHorizontalHeaderLabels({
+        tr("名称"), tr("次数"), tr("p50 (ms)"), tr("p95 (ms)"),
+        tr("累计 (ms)"), tr("字节"), tr("行/秒")
+    });
+    m_spansTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_spansTable->verticalHeader()->setVisible(false);
+    m_spansTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_spansTable->setSortingEnabled(true);
+    
+    // 连接和计数器汇总
+    m_summaryLabel = new QLabel(this);
+    m_summaryLabel->setWordWrap(true);
+    m_summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    
+    // 创建按钮
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *refreshButton = buttonBox->addButton(tr("刷新"), QDialogButtonBox::ActionRole);
+    QPushButton *resetButton = buttonBox->addButton(tr("重置"), QDialogButtonBox::ResetRole);
+    
+    // 连接信号和槽
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &StatsDialog::reject);
+    connect(refreshButton, &QPushButton::clicked, this, &StatsDialog::refresh);
+    connect(resetButton, &QPushButton::clicked, this, &StatsDialog::resetStats);
+    
+    // 创建主布局
+    QVBoxLayout *mainLayout = new QVBoxLayout;
+    mainLayout->addWidget(m_spansTable);
+    mainLayout->addWidget(m_summaryLabel);
+    mainLayout->addWidget(buttonBox);
+    setLayout(mainLayout);
+    
+    refresh();
+}
+
+StatsDialog::~StatsDialog()
+{
+}
+
+void StatsDialog::refresh()
+{
+    const QList<SpanSummary> spans = TraceStats::instance().spans();
+    
+    // 填充表格时先关闭排序，避免行在插入过程中移动
+    m_spansTable->setSortingEnabled(false);
+    m_spansTable->setRowCount(spans.size());
+    
+    // 以数值形式存入单元格，排序时按数值而不是字符串比较
+    auto numberItem = [](double value, int precision) {
+        double factor = std::pow(10.0, precision);
+        QTableWidgetItem *item = new QTableWidgetItem;
+        item->setData(Qt::DisplayRole, std::round(value * factor) / factor);
+        item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        return item;
+    };
+    
+    for (int row = 0; row < spans.size(); ++row) {
+        const SpanSummary &span = spans.at(row);
+        m_spansTable->setItem(row, 0, new QTableWidgetItem(span.name));
+        m_spansTable->setItem(row, 1, numberItem(span.count, 0));
+        m_spansTable->setItem(row, 2, numberItem(span.p50Ms, 2));
+        m_spansTable->setItem(row, 3, numberItem(span.p95Ms, 2));
+        m_spansTable->setItem(row, 4, numberItem(span.totalMs, 1));
+        m_spansTable->setItem(row, 5, numberItem(span.bytes, 0));
+        m_spansTable->setItem(row, 6, numberItem(span.rowsPerSecond(), 1));
+    }
+    
+    m_spansTable->setSortingEnabled(true);
+    m_spansTable->resizeColumnsToContents();
+    
+    // 连接统计
+    WordPressAPI::ConnectionStats stats = WordPressAPI::instance().connectionStats();
+    QString summary = tr("连接: 请求 %1 / TLS握手 %2（携带会话票据 %3）/ 复用连接 %4 / HTTP/2 %5 / HTTP/1.1 %6 / 最大并发流 %7")
+        .arg(stats.requests)
+        .arg(stats.tlsHandshakes)
+        .arg(stats.ticketHandshakes)
+        .arg(stats.reusedConnections)
+        .arg(stats.http2Requests)
+        .arg(stats.http1Requests)
+        .arg(stats.peakHttp2Streams);
+    summary += tr(" / batch请求 %1（合并写操作 %2）")
+        .arg(stats.batchRequests)
+        .arg(stats.batchedWrites);
+    
+    // 字符串池
+    StringPool::Stats pool = StringPool::instance().stats();
+    summary += tr("\n字符串池: %1 个字符串 / 查找 %2 次，命中 %3 次 / 节省 %4 字节")
+        .arg(pool.strings)
+        .arg(pool.lookups)
+        .arg(pool.hits)
+        .arg(pool.bytesSaved);
+    
+    // 计数器
+    const QHash<QString, qint64> counters = TraceStats::instance().counters();
+    QStringList names = counters.keys();
+    names.sort();
+    for (const QString &name : names) {
+        summary += QString("\n%1: %2").arg(name).arg(counters.value(name));
+    }
+    
+    m_summaryLabel->setText(summary);
+}
+
+void StatsDialog::resetStats()
+{
+    TraceStats::instance().reset();
+    refresh();
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QDialog>
+#include <QTableWidget>
+#include <QLabel>
+#include <QPushButton>
+
+// 性能统计对话框：显示网络请求、解析和SQL语句的耗时分位数、字节数和吞吐量
+class StatsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    StatsDialog(QWidget *parent = nullptr);
+    ~StatsDialog();
+
+private slots:
+    void refresh();
+    void resetStats();
+
+private:
+    QTableWidget *m_spansTable;
+    QLabel *m_summaryLabel;
+};
@@ -0,0 +1,237 @@
+#include "ApiReply.h"
+#include "PostStreamParser.h"
+#include "diagnostics/Tracing.h"
+#include <QTimer>
+#include <QtGlobal>
+
+qint64 RequestTiming::tlsHandshakeMs() const
+{
+    if (encryptedMs < 0) {
+        return -1;
+    }
+    return connectStartMs >= 0 ? encryptedMs - connectStartMs : encryptedMs;
+}
+
+qint64 RequestTiming::roundTripMs() const
+{
+    if (firstByteMs < 0) {
+        return -1;
+    }
+    
+    qint64 start = requestSentMs >= 0 ? requestSentMs : qMax<qint64>(encryptedMs, 0);
+    qint64 rtt = firstByteMs - start;
+    if (serverMs > 0) {
+        rtt -= qRound64(serverMs);
+    }
+    return qMax<qint64>(rtt, 0);
+}
+
+ApiReply::ApiReply(QObject* parent)
+    : QObject(parent), m_finished(false), m_sent(false), m_mediaId(-1), m_deletedId(-1), m_unchanged(false), m_userId(-1),
+      m_page(-1), m_totalItems(-1), m_totalPages(-1)
+{
+    m_elapsed.start();
+}
+
+ApiReply::~ApiReply()
+{
+}
+
+bool ApiReply::isFinished() const
+{
+    return m_finished;
+}
+
+bool ApiReply::isSent() const
+{
+    return m_sent;
+}
+
+bool ApiReply::hasError() const
+{
+    return !m_errorString.isEmpty();
+}
+
+QString ApiReply::errorString() const
+{
+    return m_errorString;
+}
+
+QList<Post> ApiReply::posts() const
+{
+    return m_posts;
+}
+
+Post ApiReply::post() const
+{
+    return m_post;
+}
+
+QList<Category> ApiReply::categories() const
+{
+    return m_categories;
+}
+
+QList<Tag> ApiReply::tags() const
+{
+    return m_tags;
+}
+
+QString ApiReply::mediaUrl() const
+{
+    return m_mediaUrl;
+}
+
+int ApiReply::mediaId() const
+{
+    return m_mediaId;
+}
+
+int ApiReply::deletedId() const
+{
+    return m_deletedId;
+}
+
+bool ApiReply::isUnchanged() const
+{
+    return m_unchanged;
+}
+
+int ApiReply::userId() const
+{
+    return m_userId;
+}
+
+QString ApiReply::userName() const
+{
+    return m_userName;
+}
+
+int ApiReply::page() const
+{
+    return m_page;
+}
+
+int ApiReply::totalItems() const
+{
+    return m_totalItems;
+}
+
+int ApiReply::totalPages() const
+{
+    return m_totalPages;
+}
+
+RequestTiming ApiReply::timing() const
+{
+    return m_timing;
+}
+
+QString ApiReply::protocol() const
+{
+    return m_protocol;
+}
+
+qint64 ApiReply::elapsedMs() const
+{
+    return m_elapsed.elapsed();
+}
+
+void ApiReply::abort()
+{
+    if (m_finished) {
+        return;
+    }
+
+    if (m_batchReply) {
+        // 中止整个batch/v1也无法撤回服务器已经执行的操作，这一项的结果（例如新文章的远程ID）仍要交给调用方
+        qCDebug(lcNetwork) << "写操作已随batch/v1发出，不能取消，等待结果";
+        return;
+    }
+
+    if (m_reply) {
+        // 网络回复的finished会在随后触发，并以取消错误结束本请求
+        m_reply->abort();
+    } else {
+        finishWithError(tr("请求已取消"));
+    }
+}
+
+void ApiReply::setNetworkReply(QNetworkReply* reply)
+{
+    m_reply = reply;
+    if (!reply) {
+        return;
+    }
+    m_sent = true;
+    
+    connect(reply, &QNetworkReply::uploadProgress, this, &ApiReply::uploadProgress);
+    
+    // 记录各阶段耗时，复用连接时不会收到建连和握手信号
+#if QT_VERSION >= QT_VERSION_CHECK(6, 3, 0)
+    connect(reply, &QNetworkReply::socketStartedConnecting, this, [this]() {
+        m_timing.connectStartMs = elapsedMs();
+    });
+    connect(reply, &QNetworkReply::requestSent, this, [this]() {
+        m_timing.requestSentMs = elapsedMs();
+    });
+#endif
+    connect(reply, &QNetworkReply::encrypted, this, [this]() {
+        m_timing.encryptedMs = elapsedMs();
+    });
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this]() {
+        if (m_timing.firstByteMs < 0) {
+            m_timing.firstByteMs = elapsedMs();
+        }
+    });
+}
+
+void ApiReply::finish()
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    m_timing.totalMs = elapsedMs();
+    
+    // Server-Timing: app;dur=47.2, db;dur=12 —— 优先取total，否则取最大的一项
+    if (m_reply && m_reply->hasRawHeader("Server-Timing")) {
+        bool hasTotal = false;
+        const QList<QByteArray> metrics = m_reply->rawHeader("Server-Timing").split(',');
+        for (const QByteArray& metric : metrics) {
+            const QList<QByteArray> params = metric.trimmed().split(';');
+            bool isTotal = params.first().trimmed() == "total";
+            for (const QByteArray& param : params) {
+                QByteArray trimmed = param.trimmed();
+                bool ok = false;
+                double duration = trimmed.startsWith("dur=") ? trimmed.mid(4).toDouble(&ok) : 0;
+                if (!ok || (hasTotal && !isTotal)) {
+                    continue;
+                }
+                m_timing.serverMs = isTotal ? duration : qMax(m_timing.serverMs, duration);
+                hasTotal = hasTotal || isTotal;
+            }
+        }
+    }
+    
+    emit finished();
+    deleteLater();
+}
+
+void ApiReply::finishWithError(const QString& errorMessage)
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_errorString = errorMessage.isEmpty() ? tr("未知错误") : errorMessage;
+
+    // 请求可能在调用方连接finished之前就失败（例如参数校验），因此延迟到事件循环中结束
+    if (!m_reply) {
+        QTimer::singleShot(0, this, &ApiReply::finish);
+        return;
+    }
+
+    finish();
+}
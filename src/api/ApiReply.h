@@ -0,0 +1,116 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+#include <QString>
+#include <QList>
+#include <memory>
+
+#include "models/Post.h"
+#include "models/Category.h"
+#include "models/Tag.h"
+
+class PostStreamParser;
+
+// 单个请求各阶段的耗时（相对请求开始，单位毫秒，-1表示未测得）
+// 复用已有连接时不会重新建立连接和握手，对应字段保持-1
+struct RequestTiming
+{
+    qint64 connectStartMs = -1;   // 开始建立TCP连接
+    qint64 encryptedMs = -1;      // TLS握手完成
+    qint64 requestSentMs = -1;    // 请求发送完毕
+    qint64 firstByteMs = -1;      // 收到响应头
+    qint64 totalMs = -1;          // 请求结束
+    double serverMs = -1;         // 服务器通过Server-Timing报告的处理时间
+
+    // TLS握手耗时（包含TCP建连）
+    qint64 tlsHandshakeMs() const;
+    // 网络往返时间：等待响应头的时间扣除服务器处理时间
+    qint64 roundTripMs() const;
+};
+
+// 单个API请求的句柄
+// 每次调用WordPressAPI都会返回一个独立的ApiReply，结果和错误只属于这一次请求，
+// 并发的操作之间不会再通过全局信号互相串扰。
+// finished()只发出一次，之后句柄会通过deleteLater()自动释放。
+class ApiReply : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~ApiReply();
+
+    bool isFinished() const;
+    // 请求已经发给服务器（单独发送或随batch/v1发送）；写操作在此之前还在等待合并，取消后不会发送
+    bool isSent() const;
+    bool hasError() const;
+    QString errorString() const;
+
+    // 请求结果（只有与请求类型对应的字段有效）
+    QList<Post> posts() const;
+    Post post() const;
+    QList<Category> categories() const;
+    QList<Tag> tags() const;
+    QString mediaUrl() const;
+    int mediaId() const;
+    int deletedId() const;
+    // updatePost()没有需要发送的字段（文章自上次同步后没有修改），没有发送请求（post()是传入的文章）
+    bool isUnchanged() const;
+    int userId() const;
+    QString userName() const;
+    
+    // 分页信息（来自X-WP-Total和X-WP-TotalPages响应头，未知时为-1）
+    int page() const;
+    int totalItems() const;
+    int totalPages() const;
+    
+    // 请求耗时和协商的HTTP协议（"h2"或"http/1.1"，未完成时为空）
+    RequestTiming timing() const;
+    QString protocol() const;
+
+    // 取消请求，finished()仍会发出，并携带取消错误
+    // 已经随batch/v1发出的写操作无法单独取消（服务器会执行这一项），调用后没有效果，结果照常返回
+    void abort();
+
+signals:
+    void finished();
+    void uploadProgress(qint64 bytesSent, qint64 bytesTotal);
+
+private:
+    friend class WordPressAPI;
+
+    explicit ApiReply(QObject* parent = nullptr);
+
+    void setNetworkReply(QNetworkReply* reply);
+    void finish();
+    void finishWithError(const QString& errorMessage);
+    qint64 elapsedMs() const;
+
+    QPointer<QNetworkReply> m_reply;
+    QPointer<QNetworkReply> m_batchReply;   // 包含这个写操作的、已发出的batch/v1请求
+    bool m_finished;
+    bool m_sent;
+    QString m_errorString;
+    QElapsedTimer m_elapsed;
+    RequestTiming m_timing;
+    QString m_protocol;
+
+    QList<Post> m_posts;
+    Post m_post;
+    QList<Category> m_categories;
+    QList<Tag> m_tags;
+    QString m_mediaUrl;
+    int m_mediaId;
+    int m_deletedId;
+    bool m_unchanged;
+    int m_userId;
+    QString m_userName;
+    int m_page;
+    int m_totalItems;
+    int m_totalPages;
+    
+    // 获取文章列表时，响应数据在到达的同时被解析
+    std::unique_ptr<PostStreamParser> m_postParser;
+};
@@ -0,0 +1,712 @@
+#include "PostStreamParser.h"
+#include "models/PostSchema.h"
+#include "models/TermTable.h"
+#include <QElapsedTimer>
+#include <QJsonValue>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace {
+
+bool isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isNumberChar(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// 对象的键（未解码，只用于和ASCII名称比较）
+struct JsonKey
+{
+    const char* data = nullptr;
+    int size = 0;
+
+    bool is(const char* name) const
+    {
+        return size == int(std::strlen(name)) && std::memcmp(data, name, size) == 0;
+    }
+};
+
+// 在一段完整的JSON文本上顺序读取，只解码需要的值，其余的值只扫描跳过
+class JsonReader
+{
+public:
+    JsonReader(const char* begin, const char* end)
+        : m_p(begin), m_end(end), m_ok(true)
+    {
+    }
+
+    bool ok() const
+    {
+        return m_ok;
+    }
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return m_p == m_end;
+    }
+
+    bool beginObject()
+    {
+        return consume('{');
+    }
+
+    bool beginArray()
+    {
+        return consume('[');
+    }
+
+    // 读取下一个成员的键和冒号，对象结束或出错时返回false（first由调用方为每个对象保存）
+    bool nextMember(bool& first, JsonKey* key)
+    {
+        if (!m_ok) {
+            return false;
+        }
+        skipWhitespace();
+        if (m_p < m_end && *m_p == '}') {
+            ++m_p;
+            return false;
+        }
+        if (!first && !consume(',')) {
+            return false;
+        }
+        first = false;
+
+        skipWhitespace();
+        const char* keyEnd = nullptr;
+        if (m_p == m_end || *m_p != '"' || !(keyEnd = stringEnd(m_p + 1))) {
+            return fail();
+        }
+        key->data = m_p + 1;
+        key->size = int(keyEnd - key->data);
+        m_p = keyEnd + 1;
+        return consume(':');
+    }
+
+    // 数组的下一个元素，数组结束或出错时返回false
+    bool nextElement(bool& first)
+    {
+        if (!m_ok) {
+            return false;
+        }
+        skipWhitespace();
+        if (m_p < m_end && *m_p == ']') {
+            ++m_p;
+            return false;
+        }
+        if (!first && !consume(',')) {
+            return false;
+        }
+        first = false;
+        return true;
+    }
+
+    bool peek(char c)
+    {
+        skipWhitespace();
+        return m_p < m_end && *m_p == c;
+    }
+
+    // 字符串值；不是字符串时跳过并返回空字符串（与QJsonValue::toString()一致）
+    QString readString()
+    {
+        if (!peek('"')) {
+            skipValue();
+            return QString();
+        }
+
+        const char* begin = m_p + 1;
+        const char* end = stringEnd(begin);
+        if (!end) {
+            fail();
+            return QString();
+        }
+        m_p = end + 1;
+
+        // 大多数字符串（包括HTML正文中的非ASCII字符）没有转义，直接从UTF-8转换
+        if (!std::memchr(begin, '\\', size_t(end - begin))) {
+            return QString::fromUtf8(begin, int(end - begin));
+        }
+        return QString::fromUtf8(unescape(begin, end));
+    }
+
+    // 数值；不是数值时跳过并返回0（与QJsonValue::toInt()一致）
+    qint64 readInt()
+    {
+        skipWhitespace();
+        if (m_p == m_end || !(*m_p == '-' || (*m_p >= '0' && *m_p <= '9'))) {
+            skipValue();
+            return 0;
+        }
+
+        const char* begin = m_p;
+        bool integral = true;
+        while (m_p < m_end && isNumberChar(*m_p)) {
+            integral = integral && (*m_p == '-' || (*m_p >= '0' && *m_p <= '9'));
+            ++m_p;
+        }
+
+        if (!integral) {
+            return qint64(QByteArray(begin, int(m_p - begin)).toDouble());
+        }
+        return QByteArray(begin, int(m_p - begin)).toLongLong();
+    }
+
+    // {"rendered": "..."}形式的对象中的rendered
+    QString readRendered()
+    {
+        if (!peek('{')) {
+            skipValue();
+            return QString();
+        }
+
+        beginObject();
+        QString rendered;
+        bool first = true;
+        JsonKey key;
+        while (nextMember(first, &key)) {
+            if (key.is("rendered")) {
+                rendered = readString();
+            } else {
+                skipValue();
+            }
+        }
+        return rendered;
+    }
+
+    // 正整数ID数组，其他元素忽略
+    void readIds(TermIds* ids)
+    {
+        if (!peek('[')) {
+            skipValue();
+            return;
+        }
+
+        ++m_p;
+        bool first = true;
+        while (nextElement(first)) {
+            qint64 id = readInt();
+            if (id > 0) {
+                ids->append(int(id));
+            }
+        }
+    }
+
+    // 跳过一个任意类型的值，对象和数组只数括号，不解码内容
+    void skipValue()
+    {
+        skipWhitespace();
+        if (m_p == m_end) {
+            fail();
+            return;
+        }
+
+        char c = *m_p;
+        if (c == '"') {
+            const char* end = stringEnd(m_p + 1);
+            if (!end) {
+                fail();
+                return;
+            }
+            m_p = end + 1;
+        } else if (c == '{' || c == '[') {
+            int depth = 0;
+            while (m_p < m_end) {
+                char d = *m_p;
+                if (d == '"') {
+                    const char* end = stringEnd(m_p + 1);
+                    if (!end) {
+                        break;
+                    }
+                    m_p = end;
+                } else if (d == '{' || d == '[') {
+                    ++depth;
+                } else if (d == '}' || d == ']') {
+                    if (--depth == 0) {
+                        ++m_p;
+                        return;
+                    }
+                }
+                ++m_p;
+            }
+            fail();
+        } else {
+            // 数值、true、false、null
+            const char* begin = m_p;
+            while (m_p < m_end && *m_p != ',' && *m_p != '}' && *m_p != ']' && !isWhitespace(*m_p)) {
+                ++m_p;
+            }
+            if (m_p == begin) {
+                fail();
+            }
+        }
+    }
+
+private:
+    void skipWhitespace()
+    {
+        while (m_p < m_end && isWhitespace(*m_p)) {
+            ++m_p;
+        }
+    }
+
+    bool consume(char c)
+    {
+        if (!peek(c)) {
+            return fail();
+        }
+        ++m_p;
+        return true;
+    }
+
+    bool fail()
+    {
+        m_ok = false;
+        m_p = m_end;
+        return false;
+    }
+
+    // 从字符串内容的第一个字节开始，找到结束的引号
+    const char* stringEnd(const char* p) const
+    {
+        while (p < m_end) {
+            const char* quote = static_cast<const char*>(std::memchr(p, '"', size_t(m_end - p)));
+            if (!quote) {
+                return nullptr;
+            }
+
+            // 引号前面连续的反斜杠为奇数个时，引号是被转义的
+            const char* q = quote;
+            while (q > p && q[-1] == '\\') {
+                --q;
+            }
+            if ((quote - q) % 2 == 0) {
+                return quote;
+            }
+            p = quote + 1;
+        }
+        return nullptr;
+    }
+
+    static int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    static bool readHex4(const char*& p, const char* end, uint* value)
+    {
+        if (end - p < 4) {
+            return false;
+        }
+        *value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int digit = hexValue(p[i]);
+            if (digit < 0) {
+                return false;
+            }
+            *value = (*value << 4) | uint(digit);
+        }
+        p += 4;
+        return true;
+    }
+
+    static void appendUtf8(QByteArray& out, uint codePoint)
+    {
+        if (codePoint < 0x80) {
+            out.append(char(codePoint));
+        } else if (codePoint < 0x800) {
+            out.append(char(0xc0 | (codePoint >> 6)));
+            out.append(char(0x80 | (codePoint & 0x3f)));
+        } else if (codePoint < 0x10000) {
+            out.append(char(0xe0 | (codePoint >> 12)));
+            out.append(char(0x80 | ((codePoint >> 6) & 0x3f)));
+            out.append(char(0x80 | (codePoint & 0x3f)));
+        } else {
+            out.append(char(0xf0 | (codePoint >> 18)));
+            out.append(char(0x80 | ((codePoint >> 12) & 0x3f)));
+            out.append(char(0x80 | ((codePoint >> 6) & 0x3f)));
+            out.append(char(0x80 | (codePoint & 0x3f)));
+        }
+    }
+
+    // 解码带转义的字符串内容，WordPress会把"/"转义为"\/"，非ASCII字符可能是\uXXXX
+    static QByteArray unescape(const char* p, const char* end)
+    {
+        QByteArray out;
+        out.reserve(int(end - p));
+
+        while (p < end) {
+            const char* slash = static_cast<const char*>(std::memchr(p, '\\', size_t(end - p)));
+            if (!slash) {
+                out.append(p, int(end - p));
+                break;
+            }
+            out.append(p, int(slash - p));
+            p = slash + 1;
+            if (p == end) {
+                break;
+            }
+
+            char c = *p++;
+            switch (c) {
+            case 'b': out.append('\b'); break;
+            case 'f': out.append('\f'); break;
+            case 'n': out.append('\n'); break;
+            case 'r': out.append('\r'); break;
+            case 't': out.append('\t'); break;
+            case 'u': {
+                uint codePoint = 0;
+                if (!readHex4(p, end, &codePoint)) {
+                    codePoint = 0xfffd;
+                } else if (codePoint >= 0xd800 && codePoint < 0xdc00) {
+                    // 代理对
+                    uint low = 0;
+                    const char* next = p;
+                    if (end - next >= 2 && next[0] == '\\' && next[1] == 'u') {
+                        next += 2;
+                        if (readHex4(next, end, &low) && low >= 0xdc00 && low < 0xe000) {
+                            codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+                            p = next;
+                        } else {
+                            codePoint = 0xfffd;
+                        }
+                    } else {
+                        codePoint = 0xfffd;
+                    }
+                } else if (codePoint >= 0xdc00 && codePoint < 0xe000) {
+                    codePoint = 0xfffd;
+                }
+                appendUtf8(out, codePoint);
+                break;
+            }
+            default:
+                // \" \\ \/
+                out.append(c);
+                break;
+            }
+        }
+        return out;
+    }
+
+    const char* m_p;
+    const char* m_end;
+    bool m_ok;
+};
+
+}
+
+PostStreamParser::PostStreamParser()
+    : m_state(Start), m_pos(0), m_elementStart(0), m_depth(0), m_inString(false), m_escape(false),
+      m_bytesReceived(0), m_peakBufferSize(0), m_parseNanoseconds(0)
+{
+}
+
+void PostStreamParser::feed(const QByteArray& data)
+{
+    m_bytesReceived += data.size();
+    if (m_state == Failed) {
+        return;
+    }
+
+    m_buffer.append(data);
+    m_peakBufferSize = qMax(m_peakBufferSize, qint64(m_buffer.size()));
+    if (m_state == NotArray) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const char* p = m_buffer.constData();
+    const int size = m_buffer.size();
+
+    while (m_pos < size && m_state != Failed && m_state != NotArray) {
+        char c = p[m_pos];
+
+        if (m_state == InElement) {
+            // 字符串内只需要找结束的引号，花括号和方括号都不算
+            if (m_inString) {
+                if (m_escape) {
+                    m_escape = false;
+                } else if (c == '\\') {
+                    m_escape = true;
+                } else if (c == '"') {
+                    m_inString = false;
+                }
+            } else if (c == '"') {
+                m_inString = true;
+            } else if (c == '{' || c == '[') {
+                ++m_depth;
+            } else if ((c == '}' || c == ']') && --m_depth == 0) {
+                Post post;
+                if (!parsePost(p + m_elementStart, p + m_pos + 1, &post)) {
+                    fail(QString("第%1篇文章的JSON格式无效").arg(m_posts.size() + 1));
+                    break;
+                }
+                m_posts.append(std::move(post));
+                m_state = AfterElement;
+            }
+            ++m_pos;
+            continue;
+        }
+
+        if (isWhitespace(c)) {
+            ++m_pos;
+            continue;
+        }
+
+        switch (m_state) {
+        case Start:
+            if (c == '[') {
+                m_state = FirstElement;
+            } else {
+                m_state = NotArray;
+            }
+            break;
+        case FirstElement:
+        case NextElement:
+            if (c == '{') {
+                m_state = InElement;
+                m_elementStart = m_pos;
+                m_depth = 1;
+            } else if (c == ']' && m_state == FirstElement) {
+                m_state = Done;
+            } else {
+                fail("文章数组中的元素不是对象");
+            }
+            break;
+        case AfterElement:
+            if (c == ',') {
+                m_state = NextElement;
+            } else if (c == ']') {
+                m_state = Done;
+            } else {
+                fail("文章之间缺少分隔符");
+            }
+            break;
+        case Done:
+            fail("文章数组之后有多余的数据");
+            break;
+        default:
+            break;
+        }
+
+        if (m_state != NotArray) {
+            ++m_pos;
+        }
+    }
+
+    // 丢弃已经处理完的数据，只保留未结束的对象
+    if (m_state != NotArray && m_state != Failed) {
+        int consumed = m_state == InElement ? m_elementStart : m_pos;
+        if (consumed > 0) {
+            m_buffer.remove(0, consumed);
+            m_pos -= consumed;
+            m_elementStart -= consumed;
+        }
+    }
+
+    m_parseNanoseconds += timer.nsecsElapsed();
+}
+
+void PostStreamParser::finish()
+{
+    if (m_state == InElement || m_state == FirstElement || m_state == NextElement || m_state == AfterElement) {
+        fail("文章数组不完整");
+    }
+}
+
+bool PostStreamParser::isArray() const
+{
+    return m_state != Start && m_state != NotArray;
+}
+
+bool PostStreamParser::hasError() const
+{
+    return m_state == Failed;
+}
+
+QString PostStreamParser::errorString() const
+{
+    return m_errorString;
+}
+
+QList<Post> PostStreamParser::takePosts()
+{
+    return std::exchange(m_posts, QList<Post>());
+}
+
+QByteArray PostStreamParser::takeBuffered()
+{
+    return std::exchange(m_buffer, QByteArray());
+}
+
+qint64 PostStreamParser::bytesReceived() const
+{
+    return m_bytesReceived;
+}
+
+qint64 PostStreamParser::peakBufferSize() const
+{
+    return m_peakBufferSize;
+}
+
+qint64 PostStreamParser::parseNanoseconds() const
+{
+    return m_parseNanoseconds;
+}
+
+void PostStreamParser::fail(const QString& message)
+{
+    m_state = Failed;
+    m_errorString = message;
+    m_buffer.clear();
+    m_pos = 0;
+}
+
+namespace {
+
+// 按字段描述表中的格式读取一个值，直接写入Post
+template <typename F>
+void readField(JsonReader& reader, Post& post)
+{
+    if constexpr (F::json == PostSchema::Json::Rendered) {
+        F::set(post, reader.readRendered());
+    } else if constexpr (std::is_same<typename F::Type, int>::value) {
+        F::set(post, int(reader.readInt()));
+    } else if constexpr (std::is_same<typename F::Type, QString>::value) {
+        F::set(post, reader.readString());
+    } else {
+        PostSchema::setFromJson<F>(post, QJsonValue(reader.readString()));
+    }
+}
+
+// 嵌入的关联对象数组中第一个对象里的embeddedKey（作者名、特色图片地址）
+template <typename F>
+void readEmbeddedField(JsonReader& reader, Post& post)
+{
+    if (!reader.peek('[')) {
+        reader.skipValue();
+        return;
+    }
+
+    static_assert(std::is_same<typename F::Type, QString>::value, "嵌入的字段按字符串读取");
+
+    // 只读取第一个对象
+    reader.beginArray();
+    bool firstElement = true;
+    bool read = false;
+    while (reader.nextElement(firstElement)) {
+        if (read || !reader.peek('{')) {
+            reader.skipValue();
+            continue;
+        }
+        read = true;
+
+        reader.beginObject();
+        bool firstMember = true;
+        JsonKey key;
+        while (reader.nextMember(firstMember, &key)) {
+            if (key.is(F::embeddedKey)) {
+                F::set(post, reader.readString());
+            } else {
+                reader.skipValue();
+            }
+        }
+    }
+}
+
+// _embedded对象：按关联名找到对应的Embedded字段，其余关联（例如wp:term）跳过
+void readEmbedded(JsonReader& reader, Post& post)
+{
+    if (!reader.peek('{')) {
+        reader.skipValue();
+        return;
+    }
+
+    reader.beginObject();
+    bool first = true;
+    JsonKey relation;
+    while (reader.nextMember(first, &relation)) {
+        bool matched = false;
+        PostSchema::forEach(PostSchema::JsonFields(), [&](auto field) {
+            using F = decltype(field);
+            if constexpr (F::json == PostSchema::Json::Embedded) {
+                if (!matched && relation.is(F::jsonKey)) {
+                    matched = true;
+                    readEmbeddedField<F>(reader, post);
+                }
+            }
+        });
+        if (!matched) {
+            reader.skipValue();
+        }
+    }
+}
+
+}
+
+bool PostStreamParser::parsePost(const char* begin, const char* end, Post* post)
+{
+    JsonReader reader(begin, end);
+    if (!reader.beginObject()) {
+        return false;
+    }
+
+    // 本地ID由数据库分配，保存时按远程ID匹配已有记录
+    Post result;
+    TermIds categoryIds;
+    TermIds tagIds;
+
+    bool first = true;
+    JsonKey key;
+    while (reader.nextMember(first, &key)) {
+        bool matched = false;
+        PostSchema::forEach(PostSchema::JsonFields(), [&](auto field) {
+            using F = decltype(field);
+            if constexpr (F::json != PostSchema::Json::Embedded && (F::access & PostSchema::JsonRead) != 0) {
+                if (!matched && key.is(F::jsonKey)) {
+                    matched = true;
+                    readField<F>(reader, result);
+                }
+            }
+        });
+
+        if (matched) {
+            continue;
+        }
+        if (key.is("_embedded")) {
+            readEmbedded(reader, result);
+        } else if (key.is("categories")) {
+            reader.readIds(&categoryIds);
+        } else if (key.is("tags")) {
+            reader.readIds(&tagIds);
+        } else {
+            // _links、guid、meta等
+            reader.skipValue();
+        }
+    }
+
+    if (!reader.ok() || !reader.atEnd()) {
+        return false;
+    }
+
+    result.setCategoryIds(std::move(categoryIds));
+    result.setTagIds(std::move(tagIds));
+    *post = std::move(result);
+    return true;
+}
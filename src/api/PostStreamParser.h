@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+#include "models/Post.h"
+
+// /wp/v2/posts响应（文章对象数组）的流式解析器
+// 响应数据每到达一段（readyRead）就送入feed()，一个文章对象完整到达后立即直接解码为Post，
+// 不构建QJsonDocument，也不把元素复制为QJsonObject；_links、guid等用不到的子树只扫描跳过。
+// 缓冲区中只保留还没有完整到达的那一个对象，而不是整个响应。
+// 响应不是数组时（例如错误对象）保留收到的全部数据，由调用方按普通JSON处理。
+class PostStreamParser
+{
+public:
+    PostStreamParser();
+
+    void feed(const QByteArray& data);
+
+    // 全部数据送入之后调用，检查数组是否完整结束
+    void finish();
+
+    // 已经确认响应是数组（之后的错误都是解析错误）
+    bool isArray() const;
+    bool hasError() const;
+    QString errorString() const;
+
+    // 取走已经解析完成的文章（分类和标签只有ID，名称不在这里查找）
+    QList<Post> takePosts();
+
+    // 响应不是数组时收到的全部原始数据
+    QByteArray takeBuffered();
+
+    qint64 bytesReceived() const;
+    qint64 peakBufferSize() const;      // 缓冲区的最大字节数
+    qint64 parseNanoseconds() const;    // 各次feed()中累计的解析耗时
+
+    // 把一个完整文章对象的JSON文本[begin, end)解码为Post
+    static bool parsePost(const char* begin, const char* end, Post* post);
+
+private:
+    enum State
+    {
+        Start,          // 等待数组开始
+        FirstElement,   // '['之后，可以是第一个元素或']'
+        NextElement,    // ','之后，必须是下一个元素
+        InElement,      // 正在等待当前对象结束
+        AfterElement,   // 对象之后，','或']'
+        Done,           // 数组已结束
+        NotArray,       // 响应不是数组，只缓存数据
+        Failed
+    };
+
+    void fail(const QString& message);
+
+    State m_state;
+    QByteArray m_buffer;
+    int m_pos;              // 下一个要扫描的字节
+    int m_elementStart;     // 当前对象在缓冲区中的起始位置
+    int m_depth;            // 当前对象内的嵌套层数
+    bool m_inString;
+    bool m_escape;
+    QList<Post> m_posts;
+    QString m_errorString;
+    qint64 m_bytesReceived;
+    qint64 m_peakBufferSize;
+    qint64 m_parseNanoseconds;
+};
@@ -6,25 +6,95 @@
 #include <QFileInfo>
 #include <QBuffer>
 #include <QDateTime>
-#include <QSqlQuery>
+#include <QTimer>
 #include "database/DatabaseManager.h"
+#include "models/TermTable.h"
+#include "models/StringPool.h"
+#include "models/PostSchema.h"
 #include <QSslConfiguration>
 #include <QSslSocket>
-#include <QApplication>
+#include <utility>
+#include <QCoreApplication>
+#include <QSettings>
+#include "diagnostics/Tracing.h"
+#include "PostStreamParser.h"
 
-std::unique_ptr<WordPressAPI> WordPressAPI::s_instance = nullptr;
+std::map<QString, std::unique_ptr<WordPressAPI>> WordPressAPI::s_sessions;
+QString WordPressAPI::s_currentSession;
+
+namespace {
+
+// 把文章的分类/标签ID转换为请求体中的ID数组
+// 临时ID说明词条还没有保存到本地数据库（也就没有WordPress ID），跳过并给出警告
+QJsonArray termIdsToJson(const TermIds& ids, const TermTable& table)
+{
+    QJsonArray array;
+    for (int id : ids) {
+        if (TermTable::isProvisional(id)) {
+            qCWarning(lcNetwork) << "警告: 词条 '" << table.name(id) << "' 还没有保存，没有可用的ID";
+            continue;
+        }
+        array.append(id);
+    }
+    return array;
+}
+
+// 请求体中fields部分的大致字节数，用于统计按字段更新节省的流量
+qint64 estimatedBodySize(const Post& post, Post::Fields fields)
+{
+    qint64 size = PostSchema::jsonSize(post, fields);
+    if (fields & Post::TermsField) {
+        // "categories":[...],"tags":[...],
+        size += 24;
+        for (const TermIds* ids : {&post.categoryIds(), &post.tagIds()}) {
+            for (int id : *ids) {
+                size += QByteArray::number(id).size() + 1;
+            }
+        }
+    }
+    return size;
+}
+
+}
 
 WordPressAPI& WordPressAPI::instance()
 {
-    if (!s_instance) {
-        s_instance = std::unique_ptr<WordPressAPI>(new WordPressAPI());
+    return session(s_currentSession);
+}
+
+WordPressAPI& WordPressAPI::session(const QString& siteId)
+{
+    std::unique_ptr<WordPressAPI>& session = s_sessions[siteId];
+    if (!session) {
+        session = std::unique_ptr<WordPressAPI>(new WordPressAPI());
     }
-    return *s_instance;
+    return *session;
+}
+
+void WordPressAPI::setCurrentSession(const QString& siteId)
+{
+    s_currentSession = siteId;
+}
+
+QString WordPressAPI::currentSession()
+{
+    return s_currentSession;
 }
 
 WordPressAPI::WordPressAPI(QObject* parent)
     : QObject(parent), m_networkManager(new QNetworkAccessManager(this))
 {
+    // 所有请求共用一份SSL配置，这样预热建立的连接和TLS会话可以被后续请求复用
+    m_sslConfiguration = QSslConfiguration::defaultConfiguration();
+    // 默认验证证书；只有在设置中明确开启network/insecureSsl（开发环境的自签名证书）时才跳过
+    m_insecureSsl = QSettings().value("network/insecureSsl", false).toBool();
+    if (m_insecureSsl) {
+        qCWarning(lcNetwork) << "警告: 已开启network/insecureSsl，不验证服务器证书";
+        m_sslConfiguration.setPeerVerifyMode(QSslSocket::VerifyNone);
+    }
+    // 启用会话票据和会话持久化，新建连接时可以恢复之前的TLS会话
+    m_sslConfiguration.setSslOption(QSsl::SslOptionDisableSessionTickets, false);
+    m_sslConfiguration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
 }
 
 WordPressAPI::~WordPressAPI()
@@ -33,14 +103,16 @@ WordPressAPI::~WordPressAPI()
     QList<QNetworkReply*> activeReplies = m_networkManager->findChildren<QNetworkReply*>();
     for (QNetworkReply* reply : activeReplies) {
         if (reply && reply->isRunning()) {
-            qDebug() << "取消未完成的网络请求: " << reply->url().toString();
+            qCDebug(lcNetwork) << "取消未完成的网络请求: " << reply->url().toString();
             reply->abort();
             reply->deleteLater();
         }
     }
     
-    // 等待所有网络请求完成
-    qApp->processEvents();
+    // 等待所有网络请求完成（静态析构时应用对象可能已经销毁）
+    if (QCoreApplication::instance()) {
+        QCoreApplication::processEvents();
+    }
     
     // 确保网络管理器被正确释放
     if (m_networkManager) {
@@ -54,7 +126,7 @@ void WordPressAPI::setApiUrl(const QString& url)
     m_apiUrl = url;
     
     // 记录原始URL
-    qDebug() << "原始API URL: " << m_apiUrl;
+    qCDebug(lcNetwork) << "原始API URL: " << m_apiUrl;
     
     // 确保URL以斜杠结尾
     if (!m_apiUrl.endsWith("/")) {
@@ -78,7 +150,7 @@ void WordPressAPI::setApiUrl(const QString& url)
         }
     }
     
-    qDebug() << "处理后的API基础URL: " << m_apiUrl;
+    qCDebug(lcNetwork) << "处理后的API基础URL: " << m_apiUrl;
 }
 
 void WordPressAPI::setCredentials(const QString& username, const QString& password)
@@ -92,6 +164,43 @@ QString WordPressAPI::apiUrl() const
     return m_apiUrl;
 }
 
+void WordPressAPI::warmUp()
+{
+    QUrl url(m_apiUrl);
+    if (!url.isValid() || url.host().isEmpty()) {
+        return;
+    }
+    
+    // 提前完成DNS解析、TCP连接和TLS握手，连接会留在连接池中供第一个请求使用
+    qCDebug(lcNetwork) << "预热连接: " << url.host();
+    ++m_connectionStats.warmUps;
+    if (url.scheme() == "https") {
+        m_networkManager->connectToHostEncrypted(url.host(), url.port(443), m_sslConfiguration);
+    } else {
+        m_networkManager->connectToHost(url.host(), url.port(80));
+    }
+}
+
+WordPressAPI::ConnectionStats WordPressAPI::connectionStats() const
+{
+    return m_connectionStats;
+}
+
+int WordPressAPI::inFlightRequests() const
+{
+    return m_inFlightRequests;
+}
+
+void WordPressAPI::configureRequest(QNetworkRequest& request) const
+{
+    // 允许HTTP/2：服务器支持时通过ALPN协商，多个并发请求复用同一条TLS连接
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    
+    if (request.url().scheme() == "https") {
+        request.setSslConfiguration(m_sslConfiguration);
+    }
+}
+
 QByteArray WordPressAPI::createAuthHeader() const
 {
     if (m_username.isEmpty() || m_password.isEmpty()) {
@@ -103,11 +212,89 @@ QByteArray WordPressAPI::createAuthHeader() const
     return "Basic " + data;
 }
 
-void WordPressAPI::fetchPosts()
+ApiReply* WordPressAPI::probeConnection()
 {
     if (m_apiUrl.isEmpty()) {
-        emit error("API URL 没有设置");
-        return;
+        return failedRequest("API URL 没有设置");
+    }
+    
+    QByteArray authHeader = createAuthHeader();
+    if (authHeader.isEmpty()) {
+        return failedRequest("认证信息未设置，无法测试连接");
+    }
+    
+    // users/me需要认证，context=edit可以确认账户具有编辑权限
+    QUrl url(m_apiUrl + "users/me");
+    QUrlQuery query;
+    query.addQueryItem("context", "edit");
+    query.addQueryItem("_fields", "id,name");
+    url.setQuery(query);
+    
+    qCDebug(lcNetwork) << "连接测试 API URL: " << url.toString();
+    
+    QNetworkRequest request(url);
+    configureRequest(request);
+    request.setRawHeader("Authorization", authHeader);
+    
+    QNetworkReply* reply = m_networkManager->get(request);
+    return startRequest(reply, &WordPressAPI::onConnectionProbed, "network.probe");
+}
+
+ApiReply* WordPressAPI::fetchPosts(int page, int perPage, const QDateTime& modifiedAfter)
+{
+    QUrlQuery query;
+    query.addQueryItem("per_page", QString::number(perPage));
+    query.addQueryItem("page", QString::number(page));
+    if (modifiedAfter.isValid()) {
+        // WordPress 5.7起支持按修改时间过滤
+        query.addQueryItem("modified_after", modifiedAfter.toUTC().toString(Qt::ISODate));
+    }
+    // 作者名和特色图片地址随文章一起嵌入返回，不需要再逐篇请求用户和媒体
+    query.addQueryItem("_embed", PostSchema::embedRelations());
+    return requestPosts(query, page, "network.fetchPosts");
+}
+
+ApiReply* WordPressAPI::fetchPostIndex(int page, int perPage)
+{
+    // 只要ID和修改时间，一页100篇只有几KB；包括草稿和私密文章（回收站中的不算）
+    QUrlQuery query;
+    query.addQueryItem("per_page", QString::number(perPage));
+    query.addQueryItem("page", QString::number(page));
+    query.addQueryItem("status", "any");
+    query.addQueryItem("orderby", "id");
+    query.addQueryItem("order", "asc");
+    query.addQueryItem("_fields", "id,modified_gmt");
+    return requestPosts(query, page, "network.fetchPostIndex");
+}
+
+ApiReply* WordPressAPI::fetchPost(int remoteId)
+{
+    // 通过列表接口的include过滤获取，与fetchPosts()共用流式解析；包括草稿和私密文章
+    QUrlQuery query;
+    query.addQueryItem("include", QString::number(remoteId));
+    query.addQueryItem("status", "any");
+    query.addQueryItem("_embed", PostSchema::embedRelations());
+    return requestPosts(query, 1, "network.fetchPost");
+}
+
+ApiReply* WordPressAPI::fetchPostsById(const QList<int>& remoteIds)
+{
+    QStringList ids;
+    for (int remoteId : remoteIds) {
+        ids << QString::number(remoteId);
+    }
+    QUrlQuery query;
+    query.addQueryItem("include", ids.join(','));
+    query.addQueryItem("per_page", QString::number(qBound(1, int(remoteIds.size()), 100)));
+    query.addQueryItem("status", "any");
+    query.addQueryItem("_embed", PostSchema::embedRelations());
+    return requestPosts(query, 1, "network.fetchPostsById");
+}
+
+ApiReply* WordPressAPI::requestPosts(const QUrlQuery& query, int page, const QString& spanName)
+{
+    if (m_apiUrl.isEmpty()) {
+        return failedRequest("API URL 没有设置");
     }
     
     // 构建API URL
@@ -120,284 +307,299 @@ void WordPressAPI::fetchPosts()
     }
     
     QUrl url(apiEndpoint);
-    QUrlQuery query;
-    query.addQueryItem("per_page", "100"); // 每页获取100篇文章
-    query.addQueryItem("page", "1");       // 获取第1页
     url.setQuery(query);
     
-    qDebug() << "获取文章API URL: " << url.toString();
+    qCDebug(lcNetwork) << "获取文章API URL: " << url.toString();
     
     QNetworkRequest request(url);
+    configureRequest(request);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
     QByteArray authHeader = createAuthHeader();
     if (!authHeader.isEmpty()) {
         request.setRawHeader("Authorization", authHeader);
-        qDebug() << "添加认证头: " << authHeader;
+        qCDebug(lcNetwork) << "已添加认证头";
     } else {
-        qDebug() << "警告: 未设置认证信息";
+        qCWarning(lcNetwork) << "警告: 未设置认证信息";
     }
     
     QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onPostsReceived);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
+    ApiReply* apiReply = startRequest(reply, &WordPressAPI::onPostsReceived, spanName);
+    apiReply->m_page = page;
+    
+    // 成功的响应在数据到达时逐段解析，不必等完整响应缓冲后再构建整个JSON文档
+    // 错误响应留在回复中，由onPostsReceived()读取错误信息
+    apiReply->m_postParser = std::make_unique<PostStreamParser>();
+    connect(reply, &QNetworkReply::readyRead, apiReply, [reply, apiReply]() {
+        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (statusCode >= 200 && statusCode < 300) {
+            apiReply->m_postParser->feed(reply->readAll());
+        }
+    });
+    return apiReply;
 }
 
-void WordPressAPI::createPost(const Post& post)
+ApiReply* WordPressAPI::createPost(const Post& post)
 {
     if (m_apiUrl.isEmpty()) {
-        emit error("API URL 没有设置");
-        return;
+        return failedRequest("API URL 没有设置");
     }
     
-    QUrl url(m_apiUrl + "posts");
-    qDebug() << "发布文章 API URL: " << url.toString();
+    if (createAuthHeader().isEmpty()) {
+        qCWarning(lcNetwork) << "警告: 未设置认证信息";
+        return failedRequest("认证信息未设置，无法发布文章");
+    }
     
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    // 标题、正文、摘要（{"raw": ...}格式）和状态按字段描述表写入
+    QJsonObject postObject;
+    PostSchema::writeJson(post, postObject);
     
-    // 启用SSL错误忽略（仅在开发环境使用，生产环境应移除）
-    request.setSslConfiguration(QSslConfiguration::defaultConfiguration());
-    QSslConfiguration conf = request.sslConfiguration();
-    conf.setPeerVerifyMode(QSslSocket::VerifyNone);
-    request.setSslConfiguration(conf);
+    // 设置分类和标签 - 必须是ID数组
+    QJsonArray categoriesArray = termIdsToJson(post.categoryIds(), TermTable::categories());
+    if (!categoriesArray.isEmpty()) {
+        postObject["categories"] = categoriesArray;
+    }
     
-    QByteArray authHeader = createAuthHeader();
-    if (!authHeader.isEmpty()) {
-        request.setRawHeader("Authorization", authHeader);
-        qDebug() << "添加认证头: " << authHeader;
-    } else {
-        qDebug() << "警告: 未设置认证信息";
-        emit error("认证信息未设置，无法发布文章");
-        return;
+    QJsonArray tagsArray = termIdsToJson(post.tagIds(), TermTable::tags());
+    if (!tagsArray.isEmpty()) {
+        postObject["tags"] = tagsArray;
+    }
+
+    if (post.featureMediaId() > 0) {
+        postObject["featured_media"] = post.featureMediaId();
     }
     
-    QJsonObject postObject;
+    return queueWrite(CreateWrite, "posts", postObject);
+}
+
+ApiReply* WordPressAPI::updatePost(const Post& post, Post::Fields fields)
+{
+    if (m_apiUrl.isEmpty() || !post.hasRemoteId()) {
+        return failedRequest("API URL 没有设置或无效的远程文章ID");
+    }
     
-    // 设置标题，使用proper JSON对象格式
-    QJsonObject titleObject;
-    titleObject["raw"] = post.title();
-    postObject["title"] = titleObject;
-    
-    // 设置内容，使用proper JSON对象格式
-    QJsonObject contentObject;
-    contentObject["raw"] = post.content();
-    postObject["content"] = contentObject;
-    
-    // 设置摘要，使用proper JSON对象格式
-    QJsonObject excerptObject;
-    excerptObject["raw"] = post.excerpt();
-    postObject["excerpt"] = excerptObject;
-    
-    postObject["status"] = post.status() == Post::Published ? "publish" : "draft";
-    
-    // 设置分类 - 必须是ID数组
-    if (!post.categories().isEmpty()) {
-        QJsonArray categoriesArray;
-        for (const QString& categoryName : post.categories()) {
-            // 从数据库查找分类ID
-            QSqlQuery query;
-            query.prepare("SELECT id FROM categories WHERE name = :name");
-            query.bindValue(":name", categoryName);
-            
-            if (query.exec() && query.next()) {
-                int categoryId = query.value(0).toInt();
-                categoriesArray.append(categoryId);
-                qDebug() << "添加分类ID: " << categoryId << " 名称: " << categoryName;
-            } else {
-                qDebug() << "警告: 找不到分类 '" << categoryName << "' 的ID";
-            }
-        }
-        
-        if (!categoriesArray.isEmpty()) {
-            postObject["categories"] = categoriesArray;
-        }
+    if (createAuthHeader().isEmpty()) {
+        qCWarning(lcNetwork) << "警告: 未设置认证信息";
+        return failedRequest("认证信息未设置，无法更新文章");
     }
     
-    // 设置标签 - 必须是ID数组
-    if (!post.tags().isEmpty()) {
-        QJsonArray tagsArray;
-        for (const QString& tagName : post.tags()) {
-            // 从数据库查找标签ID
-            QSqlQuery query;
-            query.prepare("SELECT id FROM tags WHERE name = :name");
-            query.bindValue(":name", tagName);
-            
-            if (query.exec() && query.next()) {
-                int tagId = query.value(0).toInt();
-                tagsArray.append(tagId);
-                qDebug() << "添加标签ID: " << tagId << " 名称: " << tagName;
-            } else {
-                qDebug() << "警告: 找不到标签 '" << tagName << "' 的ID";
-            }
+    // 请求体只包含修改过的字段（按字段描述表写入）；分类或标签修改过时两组ID都发送（空数组用于清除）
+    auto requestBody = [&post](Post::Fields bodyFields) {
+        QJsonObject postObject;
+        PostSchema::writeJson(post, postObject, bodyFields);
+        if (bodyFields & Post::TermsField) {
+            postObject["categories"] = termIdsToJson(post.categoryIds(), TermTable::categories());
+            postObject["tags"] = termIdsToJson(post.tagIds(), TermTable::tags());
         }
+        return postObject;
+    };
+    
+    if (!fields) {
+        qCDebug(lcNetwork) << "文章自上次同步后没有修改，不发送更新请求: 远程ID=" << post.remoteId();
+        TraceStats::instance().addCounter("api.updatePost.skipped", 1);
+        TraceStats::instance().addCounter("api.updatePost.bytesSaved", estimatedBodySize(post, Post::AllFields));
         
-        if (!tagsArray.isEmpty()) {
-            postObject["tags"] = tagsArray;
-        }
+        ApiReply* apiReply = new ApiReply(this);
+        apiReply->m_post = post;
+        apiReply->m_unchanged = true;
+        QTimer::singleShot(0, apiReply, &ApiReply::finish);
+        return apiReply;
     }
-
-    if (post.featureMediaId() > 0) {
-        postObject["featured_media"] = post.featureMediaId();
+    
+    QJsonObject postObject = requestBody(fields);
+    if (fields != Post::AllFields) {
+        // 与发送完整文章相比少发送的字节数：按没有发送的字段估算，不为统计再序列化一遍完整文章
+        Post::Fields omitted = Post::Fields(Post::AllFields) & ~fields;
+        TraceStats::instance().addCounter("api.updatePost.bytesSaved", estimatedBodySize(post, omitted));
     }
+    qCDebug(lcNetwork) << "更新文章: 远程ID=" << post.remoteId() << "字段=" << int(fields);
     
-    QJsonDocument doc(postObject);
-    QByteArray data = doc.toJson();
+    return queueWrite(UpdateWrite, "posts/" + QString::number(post.remoteId()), postObject);
+}
+
+ApiReply* WordPressAPI::deletePost(int postId)
+{
+    if (m_apiUrl.isEmpty() || postId == -1) {
+        return failedRequest("API URL 没有设置或无效的文章ID");
+    }
     
-    qDebug() << "发送POST请求数据: " << data;
+    // 强制删除，不放入回收站
+    return queueWrite(DeleteWrite, "posts/" + QString::number(postId) + "?force=true", QJsonObject());
+}
+
+void WordPressAPI::setBatchingEnabled(bool enabled)
+{
+    m_batchingEnabled = enabled;
+}
+
+bool WordPressAPI::batchingEnabled() const
+{
+    return m_batchingEnabled;
+}
+
+ApiReply* WordPressAPI::queueWrite(WriteKind kind, const QString& route, const QJsonObject& body)
+{
+    ApiReply* apiReply = new ApiReply(this);
+    PendingWrite write{kind, route, body, apiReply};
     
-    QNetworkReply* reply = m_networkManager->post(request, data);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onPostCreated);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
+    if (!m_batchingEnabled || m_batchSupport == BatchUnsupported) {
+        sendWrite(write);
+        return apiReply;
+    }
     
-    // 添加SSL错误处理
-    connect(reply, &QNetworkReply::sslErrors, [this](const QList<QSslError> &errors) {
-        QString errorStr = "SSL错误: ";
-        for (const QSslError &error : errors) {
-            errorStr += error.errorString() + "; ";
-        }
-        qDebug() << errorStr;
-        emit error(errorStr);
-    });
+    // 同一轮事件循环中发起的写操作攒在一起，回到事件循环时一起发送
+    m_pendingWrites.append(write);
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QTimer::singleShot(0, this, &WordPressAPI::flushWrites);
+    }
+    return apiReply;
 }
 
-void WordPressAPI::updatePost(const Post& post)
+void WordPressAPI::flushWrites()
 {
-    if (m_apiUrl.isEmpty() || !post.hasRemoteId()) {
-        emit error("API URL 没有设置或无效的远程文章ID");
+    m_flushScheduled = false;
+    
+    // 发送之前已经被取消的操作不再发送
+    QList<PendingWrite> writes;
+    for (const PendingWrite& write : std::as_const(m_pendingWrites)) {
+        if (write.reply && !write.reply->isFinished() && !write.reply->hasError()) {
+            writes.append(write);
+        }
+    }
+    m_pendingWrites.clear();
+    
+    if (writes.size() == 1 || m_batchSupport == BatchUnsupported || batchUrl().isEmpty()) {
+        for (const PendingWrite& write : std::as_const(writes)) {
+            sendWrite(write);
+        }
         return;
     }
     
-    QUrl url(m_apiUrl + "posts/" + QString::number(post.remoteId()));
-    qDebug() << "更新文章 API URL: " << url.toString();
+    for (int i = 0; i < writes.size(); i += BatchLimit) {
+        QList<PendingWrite> chunk = writes.mid(i, BatchLimit);
+        if (chunk.size() == 1) {
+            sendWrite(chunk.first());
+        } else {
+            sendBatch(chunk);
+        }
+    }
+}
+
+void WordPressAPI::sendWrite(const PendingWrite& write)
+{
+    QUrl url(m_apiUrl + write.route);
+    qCDebug(lcNetwork) << "文章写操作 API URL: " << url.toString();
     
     QNetworkRequest request(url);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
-    // 启用SSL错误忽略（仅在开发环境使用，生产环境应移除）
-    request.setSslConfiguration(QSslConfiguration::defaultConfiguration());
-    QSslConfiguration conf = request.sslConfiguration();
-    conf.setPeerVerifyMode(QSslSocket::VerifyNone);
-    request.setSslConfiguration(conf);
+    // 使用共享的SSL配置（默认验证证书，见构造函数中的network/insecureSsl）
+    configureRequest(request);
     
     QByteArray authHeader = createAuthHeader();
     if (!authHeader.isEmpty()) {
         request.setRawHeader("Authorization", authHeader);
-        qDebug() << "添加认证头: " << authHeader;
-    } else {
-        qDebug() << "警告: 未设置认证信息";
-        emit error("认证信息未设置，无法更新文章");
-        return;
     }
     
-    QJsonObject postObject;
-    
-    // 设置标题，使用proper JSON对象格式
-    QJsonObject titleObject;
-    titleObject["raw"] = post.title();
-    postObject["title"] = titleObject;
-    
-    // 设置内容，使用proper JSON对象格式
-    QJsonObject contentObject;
-    contentObject["raw"] = post.content();
-    postObject["content"] = contentObject;
-    
-    // 设置摘要，使用proper JSON对象格式
-    QJsonObject excerptObject;
-    excerptObject["raw"] = post.excerpt();
-    postObject["excerpt"] = excerptObject;
-    
-    postObject["status"] = post.status() == Post::Published ? "publish" : "draft";
-    
-    // 设置分类 - 必须是ID数组
-    if (!post.categories().isEmpty()) {
-        QJsonArray categoriesArray;
-        for (const QString& categoryName : post.categories()) {
-            // 从数据库查找分类ID
-            QSqlQuery query;
-            query.prepare("SELECT id FROM categories WHERE name = :name");
-            query.bindValue(":name", categoryName);
-            
-            if (query.exec() && query.next()) {
-                int categoryId = query.value(0).toInt();
-                categoriesArray.append(categoryId);
-            }
-        }
-        
-        if (!categoriesArray.isEmpty()) {
-            postObject["categories"] = categoriesArray;
+    QNetworkReply* reply = nullptr;
+    void (WordPressAPI::*handler)(QNetworkReply*, ApiReply*) = nullptr;
+    QString spanName;
+    switch (write.kind) {
+    case CreateWrite:
+    case UpdateWrite: {
+        QByteArray data = QJsonDocument(write.body).toJson();
+        qCDebug(lcNetwork) << "发送请求数据: " << data.size() << "字节";
+        if (write.kind == CreateWrite) {
+            reply = m_networkManager->post(request, data);
+            handler = &WordPressAPI::onPostCreated;
+            spanName = "network.createPost";
+        } else {
+            reply = m_networkManager->put(request, data);
+            handler = &WordPressAPI::onPostUpdated;
+            spanName = "network.updatePost";
         }
+        break;
     }
-    
-    // 设置标签 - 必须是ID数组
-    if (!post.tags().isEmpty()) {
-        QJsonArray tagsArray;
-        for (const QString& tagName : post.tags()) {
-            // 从数据库查找标签ID
-            QSqlQuery query;
-            query.prepare("SELECT id FROM tags WHERE name = :name");
-            query.bindValue(":name", tagName);
-            
-            if (query.exec() && query.next()) {
-                int tagId = query.value(0).toInt();
-                tagsArray.append(tagId);
-            }
-        }
-        
-        if (!tagsArray.isEmpty()) {
-            postObject["tags"] = tagsArray;
-        }
+    case DeleteWrite:
+        reply = m_networkManager->deleteResource(request);
+        handler = &WordPressAPI::onPostDeleted;
+        spanName = "network.deletePost";
+        break;
     }
     
-    QJsonDocument doc(postObject);
-    QByteArray data = doc.toJson();
-    
-    qDebug() << "发送PUT请求数据: " << data;
-    
-    QNetworkReply* reply = m_networkManager->put(request, data);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onPostUpdated);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
-    
-    // 添加SSL错误处理
-    connect(reply, &QNetworkReply::sslErrors, [this](const QList<QSslError> &errors) {
+    // 添加SSL错误处理（错误本身会通过请求句柄返回）
+    connect(reply, &QNetworkReply::sslErrors, this, [](const QList<QSslError> &errors) {
         QString errorStr = "SSL错误: ";
         for (const QSslError &error : errors) {
             errorStr += error.errorString() + "; ";
         }
-        qDebug() << errorStr;
-        emit error(errorStr);
+        qCWarning(lcNetwork) << errorStr;
     });
+    
+    if (write.reply) {
+        startRequest(reply, handler, spanName, write.reply);
+    } else {
+        // 调用方已经释放了句柄，请求照常完成
+        startRequest(reply, handler, spanName);
+    }
 }
 
-void WordPressAPI::deletePost(int postId)
+QString WordPressAPI::batchUrl() const
 {
-    if (m_apiUrl.isEmpty() || postId == -1) {
-        emit error("API URL 没有设置或无效的文章ID");
-        return;
+    int index = m_apiUrl.indexOf("wp/v2");
+    return index < 0 ? QString() : m_apiUrl.left(index) + "batch/v1";
+}
+
+void WordPressAPI::sendBatch(const QList<PendingWrite>& writes)
+{
+    // 每项的路径是完整的REST路由，例如 /wp/v2/posts/12
+    QString routePrefix = "/" + m_apiUrl.mid(m_apiUrl.indexOf("wp/v2"));
+    
+    QJsonArray requests;
+    for (const PendingWrite& write : writes) {
+        QJsonObject item;
+        item["method"] = write.kind == CreateWrite ? "POST" : write.kind == UpdateWrite ? "PUT" : "DELETE";
+        item["path"] = routePrefix + write.route;
+        if (write.kind != DeleteWrite) {
+            item["body"] = write.body;
+        }
+        requests.append(item);
     }
     
-    QUrl url(m_apiUrl + "posts/" + QString::number(postId));
-    QUrlQuery query;
-    query.addQueryItem("force", "true"); // 强制删除
-    url.setQuery(query);
-    
-    QNetworkRequest request(url);
+    // normal：每项单独校验和执行，一项失败不影响其他项
+    QJsonObject batch;
+    batch["validation"] = "normal";
+    batch["requests"] = requests;
+    QByteArray data = QJsonDocument(batch).toJson(QJsonDocument::Compact);
     
+    QNetworkRequest request{QUrl(batchUrl())};
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    configureRequest(request);
     QByteArray authHeader = createAuthHeader();
     if (!authHeader.isEmpty()) {
         request.setRawHeader("Authorization", authHeader);
     }
     
-    QNetworkReply* reply = m_networkManager->deleteResource(request);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onPostDeleted);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
+    qCDebug(lcNetwork) << "发送batch/v1请求: " << writes.size() << "项，" << data.size() << "字节";
+    ++m_connectionStats.batchRequests;
+    m_connectionStats.batchedWrites += writes.size();
+    
+    QNetworkReply* reply = m_networkManager->post(request, data);
+    m_batches.insert(reply, writes);
+    for (const PendingWrite& write : writes) {
+        if (write.reply) {
+            write.reply->m_batchReply = reply;
+            write.reply->m_sent = true;
+        }
+    }
+    startRequest(reply, &WordPressAPI::onBatchReceived, "network.batch");
 }
 
-void WordPressAPI::fetchCategories()
+ApiReply* WordPressAPI::fetchCategories()
 {
     if (m_apiUrl.isEmpty()) {
-        emit error("API URL 没有设置");
-        return;
+        return failedRequest("API URL 没有设置");
     }
     
     QUrl url(m_apiUrl + "categories");
@@ -406,6 +608,7 @@ void WordPressAPI::fetchCategories()
     url.setQuery(query);
     
     QNetworkRequest request(url);
+    configureRequest(request);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
     QByteArray authHeader = createAuthHeader();
@@ -414,15 +617,13 @@ void WordPressAPI::fetchCategories()
     }
     
     QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onCategoriesReceived);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
+    return startRequest(reply, &WordPressAPI::onCategoriesReceived, "network.fetchCategories");
 }
 
-void WordPressAPI::fetchTags()
+ApiReply* WordPressAPI::fetchTags()
 {
     if (m_apiUrl.isEmpty()) {
-        emit error("API URL 没有设置");
-        return;
+        return failedRequest("API URL 没有设置");
     }
     
     QUrl url(m_apiUrl + "tags");
@@ -431,6 +632,7 @@ void WordPressAPI::fetchTags()
     url.setQuery(query);
     
     QNetworkRequest request(url);
+    configureRequest(request);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
     QByteArray authHeader = createAuthHeader();
@@ -439,57 +641,52 @@ void WordPressAPI::fetchTags()
     }
     
     QNetworkReply* reply = m_networkManager->get(request);
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onTagsReceived);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
+    return startRequest(reply, &WordPressAPI::onTagsReceived, "network.fetchTags");
 }
 
-void WordPressAPI::uploadMedia(const QString& filePath, const QString& title)
+ApiReply* WordPressAPI::uploadMedia(const QString& filePath, const QString& title)
 {
     if (m_apiUrl.isEmpty()) {
-        emit error("API URL未设置");
-        return;
+        return failedRequest("API URL未设置");
     }
     
     QFile* file=new QFile(filePath);
     if (!file->open(QIODevice::ReadOnly)) {
-        emit error("无法打开文件: " + filePath);
         file->deleteLater();
-        return;
+        return failedRequest("无法打开文件: " + filePath);
     }
     
     QUrl url(m_apiUrl + "media");
-    qDebug() << "上传媒体 API URL: " << url.toString();
+    qCDebug(lcNetwork) << "上传媒体 API URL: " << url.toString();
     
     QNetworkRequest request(url);
     
-    // 忽略SSL错误，用于开发环境（在生产环境中应移除）
-    QSslConfiguration conf = request.sslConfiguration();
-    conf.setPeerVerifyMode(QSslSocket::VerifyNone);
-    request.setSslConfiguration(conf);
+    // 使用共享的SSL配置（其中忽略SSL错误，用于开发环境，在生产环境中应移除）
+    configureRequest(request);
     
     QByteArray authHeader = createAuthHeader();
     if (!authHeader.isEmpty()) {
         request.setRawHeader("Authorization", authHeader);
-        qDebug() << "已添加认证头";
+        qCDebug(lcNetwork) << "已添加认证头";
     } else {
-        emit error("认证信息未设置，无法上传媒体");
-        return;
+        file->deleteLater();
+        return failedRequest("认证信息未设置，无法上传媒体");
     }
     
     QFileInfo fileInfo(filePath);
     if (!fileInfo.exists() || !fileInfo.isReadable()) {
-        emit error("文件不存在或无法读取: " + filePath);
-        return;
+        file->deleteLater();
+        return failedRequest("文件不存在或无法读取: " + filePath);
     }
     
     // 检查文件大小
     qint64 fileSize = fileInfo.size();
     if (fileSize > 50 * 1024 * 1024) { // 50MB限制
-        emit error("文件过大，超过50MB的限制: " + QString::number(fileSize / (1024.0 * 1024.0), 'f', 2) + "MB");
-        return;
+        file->deleteLater();
+        return failedRequest("文件过大，超过50MB的限制: " + QString::number(fileSize / (1024.0 * 1024.0), 'f', 2) + "MB");
     }
     
-    qDebug() << "正在上传文件:" << filePath << "，大小:" << QString::number(fileSize / 1024.0, 'f', 2) + "KB";
+    qCDebug(lcNetwork) << "正在上传文件:" << filePath << "，大小:" << QString::number(fileSize / 1024.0, 'f', 2) + "KB";
     
     // 创建multipart请求
     QHttpMultiPart* multiPart = new QHttpMultiPart(QHttpMultiPart::FormDataType);
@@ -503,10 +700,10 @@ void WordPressAPI::uploadMedia(const QString& filePath, const QString& title)
     // 确保MIME类型是图片
     if (!mimeType.startsWith("image/")) {
         mimeType = "image/" + fileInfo.suffix().toLower();
-        qDebug() << "文件MIME类型不是图片，强制设置为:" << mimeType;
+        qCDebug(lcNetwork) << "文件MIME类型不是图片，强制设置为:" << mimeType;
     }
     
-    qDebug() << "文件MIME类型:" << mimeType;
+    qCDebug(lcNetwork) << "文件MIME类型:" << mimeType;
     
     filePart.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(mimeType));
     filePart.setHeader(QNetworkRequest::ContentDispositionHeader, 
@@ -522,21 +719,17 @@ void WordPressAPI::uploadMedia(const QString& filePath, const QString& title)
         titlePart.setHeader(QNetworkRequest::ContentDispositionHeader, QVariant("form-data; name=\"title\""));
         titlePart.setBody(title.toUtf8());
         multiPart->append(titlePart);
-        qDebug() << "添加标题:" << title;
+        qCDebug(lcNetwork) << "添加标题:" << title;
     }
     
     QNetworkReply* reply = m_networkManager->post(request, multiPart);
     multiPart->setParent(reply); // 当回复完成时，自动删除multiPart
     
-    connect(reply, &QNetworkReply::finished, this, &WordPressAPI::onMediaUploaded);
-    connect(reply, &QNetworkReply::errorOccurred, this, &WordPressAPI::handleNetworkError);
-    
-    // 连接并转发上传进度信号
-    connect(reply, &QNetworkReply::uploadProgress, this, [this](qint64 bytesSent, qint64 bytesTotal) {
+    // 上传进度通过请求句柄的uploadProgress信号转发
+    connect(reply, &QNetworkReply::uploadProgress, this, [](qint64 bytesSent, qint64 bytesTotal) {
         if (bytesTotal > 0) {
-            qDebug() << "上传进度: " << bytesSent << "/" << bytesTotal 
+            qCDebug(lcNetwork) << "上传进度: " << bytesSent << "/" << bytesTotal 
                      << "(" << int(100.0 * bytesSent / bytesTotal) << "%)";
-            emit uploadProgress(bytesSent, bytesTotal);
         }
     });
     
@@ -546,402 +739,386 @@ void WordPressAPI::uploadMedia(const QString& filePath, const QString& title)
         for (const QSslError &error : errors) {
             errorMsg += error.errorString() + "; ";
         }
-        qDebug() << errorMsg;
-        emit error(errorMsg);
+        qCWarning(lcNetwork) << errorMsg;
         
-        // 在开发环境中忽略SSL错误
-        reply->ignoreSslErrors();
+        // 只有明确开启了不安全模式（开发环境）时才忽略SSL错误
+        if (m_insecureSsl) {
+            reply->ignoreSslErrors();
+        }
     });
+    
+    return startRequest(reply, &WordPressAPI::onMediaUploaded, "network.uploadMedia");
 }
 
-void WordPressAPI::onPostsReceived()
+ApiReply* WordPressAPI::startRequest(QNetworkReply* reply, void (WordPressAPI::*handler)(QNetworkReply*, ApiReply*),
+                                     const QString& spanName, ApiReply* apiReply)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        qDebug() << "错误: 无效的网络回复对象";
-        return;
-    }
+    if (!apiReply) {
+        apiReply = new ApiReply(this);
+    }
+    apiReply->setNetworkReply(reply);
+    ++m_connectionStats.requests;
+    ++m_inFlightRequests;
+    
+    // 统计TLS握手和连接复用情况
+    bool isEncrypted = reply->url().scheme() == "https";
+    bool ticketOffered = !m_sslConfiguration.sessionTicket().isEmpty();
+    connect(reply, &QNetworkReply::encrypted, this, [this, reply, ticketOffered]() {
+        ++m_connectionStats.tlsHandshakes;
+        if (ticketOffered) {
+            ++m_connectionStats.ticketHandshakes;
+        }
+        
+        // 保存服务器下发的会话票据，之后新建的连接可以用它恢复会话
+        QByteArray ticket = reply->sslConfiguration().sessionTicket();
+        if (!ticket.isEmpty()) {
+            m_sslConfiguration.setSessionTicket(ticket);
+        }
+    });
     
+    // 协议要等响应头到达才知道：此时才把请求计入所在主机的HTTP/2并发流，结束时减去。
+    // HTTP/1.1请求、还在等待连接的请求和其他主机的请求都不计入
+    QString host = reply->url().host();
+    auto http2Stream = std::make_shared<bool>(false);
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply, host, http2Stream]() {
+        if (!*http2Stream && reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+            *http2Stream = true;
+            int streams = ++m_http2Streams[host];
+            m_connectionStats.peakHttp2Streams = qMax(m_connectionStats.peakHttp2Streams, streams);
+        }
+    });
+    
+    connect(reply, &QNetworkReply::finished, apiReply, [this, reply, apiReply, handler, isEncrypted, host, http2Stream, spanName]() {
+        --m_inFlightRequests;
+        if (*http2Stream) {
+            --m_http2Streams[host];
+        }
+        
+        // 记录整个请求的耗时和响应大小（流式解析时大部分数据已经被解析器读取）
+        qint64 responseBytes = reply->bytesAvailable();
+        if (apiReply->m_postParser) {
+            responseBytes += apiReply->m_postParser->bytesReceived();
+        }
+        TraceStats::instance().record(spanName, apiReply->m_elapsed.nsecsElapsed(), responseBytes);
+        
+        // 没有经历握手的HTTPS请求复用了已有连接
+        if (isEncrypted && apiReply->m_timing.encryptedMs < 0 && reply->error() == QNetworkReply::NoError) {
+            ++m_connectionStats.reusedConnections;
+        }
+        
+        // 记录协商的协议
+        if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+            apiReply->m_protocol = "h2";
+            ++m_connectionStats.http2Requests;
+        } else if (reply->error() == QNetworkReply::NoError) {
+            apiReply->m_protocol = "http/1.1";
+            ++m_connectionStats.http1Requests;
+        }
+        
+        (this->*handler)(reply, apiReply);
+        reply->deleteLater();
+    });
+    
+    return apiReply;
+}
+
+ApiReply* WordPressAPI::failedRequest(const QString& errorMessage)
+{
+    qCWarning(lcNetwork) << "请求未发送: " << errorMessage;
+    
+    ApiReply* apiReply = new ApiReply(this);
+    apiReply->finishWithError(errorMessage);
+    return apiReply;
+}
+
+void WordPressAPI::onPostsReceived(QNetworkReply* reply, ApiReply* apiReply)
+{
     // 检查HTTP状态码
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    qDebug() << "获取文章 HTTP状态码: " << statusCode;
+    qCDebug(lcNetwork) << "获取文章 HTTP状态码: " << statusCode;
+    
+    // 流式解析时这里只剩下最后一段数据
+    QByteArray responseData = reply->readAll();
     
-    // 获取响应头信息
-    QList<QByteArray> headerList = reply->rawHeaderList();
-    for (const QByteArray& header : headerList) {
-        qDebug() << "响应头: " << header << "=" << reply->rawHeader(header);
+    if (reply->error() != QNetworkReply::NoError) {
+        apiReply->finishWithError(networkErrorMessage(reply, responseData));
+        return;
     }
     
-    QByteArray responseData = reply->readAll();
-    qDebug() << "响应数据长度: " << responseData.size() << "字节";
+    // 分页信息
+    if (reply->hasRawHeader("X-WP-Total")) {
+        apiReply->m_totalItems = reply->rawHeader("X-WP-Total").toInt();
+    }
+    if (reply->hasRawHeader("X-WP-TotalPages")) {
+        apiReply->m_totalPages = reply->rawHeader("X-WP-TotalPages").toInt();
+    }
+    
+    PostStreamParser* parser = apiReply->m_postParser.get();
+    if (parser) {
+        parser->feed(responseData);
+        parser->finish();
+        qCDebug(lcNetwork) << "响应数据长度: " << parser->bytesReceived() << "字节，解析缓冲区峰值: "
+                           << parser->peakBufferSize() << "字节";
+        
+        if (parser->isArray()) {
+            if (parser->hasError()) {
+                qCWarning(lcNetwork) << "JSON解析错误: " << parser->errorString();
+                apiReply->finishWithError("JSON解析错误: " + parser->errorString());
+                return;
+            }
+            
+            apiReply->m_posts = parser->takePosts();
+            for (const Post& post : apiReply->m_posts) {
+                registerUnknownTerms(post);
+            }
+            qCDebug(lcNetwork) << "解析后的文章数量: " << apiReply->m_posts.size();
+            
+            // 解析分散在各次readyRead中，记录累计的解析耗时
+            TraceStats::instance().record("parse.posts", parser->parseNanoseconds(), parser->bytesReceived(),
+                                          apiReply->m_posts.size());
+            apiReply->finish();
+            return;
+        }
+        
+        // 不是文章数组（例如错误对象），取回解析器保留的全部数据按普通JSON处理
+        responseData = parser->takeBuffered();
+    }
     
     // 仅输出前200字符，避免日志过长
     if (!responseData.isEmpty()) {
-        qDebug() << "响应数据预览: " << responseData.left(200) << "...";
+        qCDebug(lcNetwork) << "响应数据预览: " << responseData.left(200) << "...";
     }
     
-    reply->deleteLater();
+    // 解析阶段单独计时
+    TraceSpan parseSpan("parse.posts");
+    parseSpan.addBytes(responseData.size());
     
     QJsonParseError parseError;
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
     
     if (parseError.error != QJsonParseError::NoError) {
-        qDebug() << "JSON解析错误: " << parseError.errorString();
-        emit error("JSON解析错误: " + parseError.errorString());
+        qCWarning(lcNetwork) << "JSON解析错误: " << parseError.errorString();
+        apiReply->finishWithError("JSON解析错误: " + parseError.errorString());
         return;
     }
     
     if (jsonDoc.isArray()) {
         QJsonArray jsonArray = jsonDoc.array();
-        qDebug() << "获取到的文章数量: " << jsonArray.size();
+        qCDebug(lcNetwork) << "获取到的文章数量: " << jsonArray.size();
         
-        QList<Post> posts = parsePosts(jsonArray);
-        qDebug() << "解析后的文章数量: " << posts.size();
+        apiReply->m_posts = parsePosts(jsonArray);
+        qCDebug(lcNetwork) << "解析后的文章数量: " << apiReply->m_posts.size();
         
-        emit postsReceived(posts);
+        parseSpan.addRows(apiReply->m_posts.size());
+        parseSpan.finish();
+        apiReply->finish();
     } else if (jsonDoc.isObject()) {
         // 某些WordPress API可能在错误时返回对象而不是数组
         QJsonObject errorObj = jsonDoc.object();
         if (errorObj.contains("code") || errorObj.contains("message")) {
             QString errorCode = errorObj["code"].toString();
             QString errorMessage = errorObj["message"].toString();
-            qDebug() << "API错误: " << errorCode << " - " << errorMessage;
-            emit error("API错误: " + errorMessage);
+            qCWarning(lcNetwork) << "API错误: " << errorCode << " - " << errorMessage;
+            apiReply->finishWithError("API错误: " + errorMessage);
         } else {
-            qDebug() << "响应不是文章数组: " << jsonDoc.toJson().left(200) << "...";
-            emit error("响应格式无效，预期是文章数组");
+            qCDebug(lcNetwork) << "响应不是文章数组: " << jsonDoc.toJson().left(200) << "...";
+            apiReply->finishWithError("响应格式无效，预期是文章数组");
         }
     } else {
-        qDebug() << "无效的响应格式，既不是数组也不是对象";
-        emit error("无效的响应格式");
+        qCDebug(lcNetwork) << "无效的响应格式，既不是数组也不是对象";
+        apiReply->finishWithError("无效的响应格式");
     }
 }
 
-void WordPressAPI::onPostCreated()
+void WordPressAPI::onPostCreated(QNetworkReply* reply, ApiReply* apiReply)
+{
+    onPostWritten(reply, apiReply, CreateWrite);
+}
+
+void WordPressAPI::onPostUpdated(QNetworkReply* reply, ApiReply* apiReply)
+{
+    onPostWritten(reply, apiReply, UpdateWrite);
+}
+
+void WordPressAPI::onPostDeleted(QNetworkReply* reply, ApiReply* apiReply)
+{
+    onPostWritten(reply, apiReply, DeleteWrite);
+}
+
+void WordPressAPI::onPostWritten(QNetworkReply* reply, ApiReply* apiReply, WriteKind kind)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        emit error("无效的网络回复对象");
-        return;
-    }
-    
     // 检查HTTP状态码
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    qDebug() << "创建文章 HTTP状态码: " << statusCode;
+    qCDebug(lcNetwork) << "文章写操作 HTTP状态码: " << statusCode;
     
     QByteArray responseData = reply->readAll();
-    qDebug() << "响应数据长度: " << responseData.size() << "字节";
+    qCDebug(lcNetwork) << "响应数据长度: " << responseData.size() << "字节";
     if (!responseData.isEmpty()) {
-        qDebug() << "响应数据预览: " << responseData.left(200) << "...";
+        qCDebug(lcNetwork) << "响应数据预览: " << responseData.left(200) << "...";
     }
     
-    reply->deleteLater();
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
+    bool isObject = parseError.error == QJsonParseError::NoError && jsonDoc.isObject();
     
-    // 检查状态码是否表示成功
-    if (statusCode < 200 || statusCode >= 300) {
-        QString errorMsg = QString("创建文章失败，HTTP错误: %1").arg(statusCode);
-        
-        // 尝试从响应中提取更多错误信息
-        QJsonParseError parseError;
-        QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
-        if (parseError.error == QJsonParseError::NoError && jsonDoc.isObject()) {
-            QJsonObject obj = jsonDoc.object();
-            if (obj.contains("message")) {
-                errorMsg += "\n错误信息: " + obj["message"].toString();
-            }
-        }
-        
-        emit error(errorMsg);
+    // 没有收到HTTP响应，或者错误响应中没有可用的错误信息
+    if (statusCode == 0 || ((statusCode < 200 || statusCode >= 300) && !isObject)) {
+        apiReply->finishWithError(networkErrorMessage(reply, responseData));
         return;
     }
     
-    // 解析成功响应
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
     if (parseError.error != QJsonParseError::NoError) {
-        emit error("JSON解析错误: " + parseError.errorString());
+        apiReply->finishWithError("JSON解析错误: " + parseError.errorString());
         return;
     }
     
-    if (!jsonDoc.isObject()) {
-        emit error("无效的响应格式，预期是文章对象");
+    if (!isObject) {
+        apiReply->finishWithError("无效的响应格式，预期是文章对象");
         return;
     }
     
-    QJsonObject jsonObj = jsonDoc.object();
-    
-    // 提取文章信息
-    int remoteId = jsonObj["id"].toInt();  // 这是WordPress返回的远程ID
-    qDebug() << "WordPress返回的远程ID: " << remoteId;
-    
-    QString title;
-    if (jsonObj.contains("title") && jsonObj["title"].isObject()) {
-        title = jsonObj["title"].toObject()["rendered"].toString();
-    } else {
-        title = "未知标题";
-    }
-    
-    QString content;
-    if (jsonObj.contains("content") && jsonObj["content"].isObject()) {
-        content = jsonObj["content"].toObject()["rendered"].toString();
-    } else {
-        content = "";
-    }
-    
-    QString excerpt;
-    if (jsonObj.contains("excerpt") && jsonObj["excerpt"].isObject()) {
-        excerpt = jsonObj["excerpt"].toObject()["rendered"].toString();
-    } else {
-        excerpt = "";
-    }
-    
-    QDateTime publishDate = QDateTime::currentDateTime();
-    if (jsonObj.contains("date")) {
-        publishDate = QDateTime::fromString(jsonObj["date"].toString(), Qt::ISODate);
-    }
-    
-    QString author = jsonObj["author"].toString();
-    Post::Status status = jsonObj["status"].toString() == "publish" ? Post::Published : Post::Draft;
-    
-    // 创建一个新的Post对象，使用-1作为本地ID（将由数据库自动分配）
-    // 并设置远程ID为WordPress返回的ID
-    Post post(-1, title, content, excerpt, publishDate, author, status);
-    post.setRemoteId(remoteId);  // 设置WordPress远程ID
-    
-    // 处理分类和标签
-    if (jsonObj.contains("categories") && jsonObj["categories"].isArray()) {
-        QJsonArray categories = jsonObj["categories"].toArray();
-        for (const QJsonValue& catId : categories) {
-            // 从数据库获取分类名称
-            QSqlQuery query;
-            query.prepare("SELECT name FROM categories WHERE id = :id");
-            query.bindValue(":id", catId.toInt());
-            if (query.exec() && query.next()) {
-                post.addCategory(query.value(0).toString());
-            }
+    finishWrite(kind, statusCode, jsonDoc.object(), apiReply);
+}
+
+void WordPressAPI::finishWrite(WriteKind kind, int statusCode, const QJsonObject& body, ApiReply* apiReply)
+{
+    // 检查状态码是否表示成功
+    if (statusCode < 200 || statusCode >= 300) {
+        QString action = kind == CreateWrite ? "创建文章" : kind == UpdateWrite ? "更新文章" : "删除文章";
+        QString errorMsg = QString("%1失败，HTTP错误: %2").arg(action).arg(statusCode);
+        if (body.contains("message")) {
+            errorMsg += "\n错误信息: " + body["message"].toString();
         }
+        apiReply->finishWithError(errorMsg);
+        return;
     }
     
-    if (jsonObj.contains("tags") && jsonObj["tags"].isArray()) {
-        QJsonArray tags = jsonObj["tags"].toArray();
-        for (const QJsonValue& tagId : tags) {
-            // 从数据库获取标签名称
-            QSqlQuery query;
-            query.prepare("SELECT name FROM tags WHERE id = :id");
-            query.bindValue(":id", tagId.toInt());
-            if (query.exec() && query.next()) {
-                post.addTag(query.value(0).toString());
-            }
+    if (kind == DeleteWrite) {
+        if (body["deleted"].toBool()) {
+            apiReply->m_deletedId = body["previous"].toObject()["id"].toInt();
+            apiReply->finish();
+        } else {
+            apiReply->finishWithError("删除文章失败");
         }
+        return;
     }
     
-    emit postCreated(post);
+    // 使用-1作为本地ID（由调用者设置），远程ID为WordPress返回的ID
+    apiReply->m_post = parsePostObject(body);
+    apiReply->finish();
 }
 
-void WordPressAPI::onPostUpdated()
+void WordPressAPI::onBatchReceived(QNetworkReply* reply, ApiReply* apiReply)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        emit error("无效的网络回复对象");
-        return;
+    QList<PendingWrite> writes = m_batches.take(reply);
+    // 之后每项按单独的请求处理（逐个重新发送时可以再取消）
+    for (const PendingWrite& write : std::as_const(writes)) {
+        if (write.reply) {
+            write.reply->m_batchReply = nullptr;
+        }
     }
-    
-    // 检查HTTP状态码
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    qDebug() << "更新文章 HTTP状态码: " << statusCode;
-    
     QByteArray responseData = reply->readAll();
-    qDebug() << "响应数据长度: " << responseData.size() << "字节";
-    if (!responseData.isEmpty()) {
-        qDebug() << "响应数据预览: " << responseData.left(200) << "...";
-    }
-    
-    reply->deleteLater();
     
-    // 检查状态码是否表示成功
-    if (statusCode < 200 || statusCode >= 300) {
-        QString errorMsg = QString("更新文章失败，HTTP错误: %1").arg(statusCode);
-        
-        // 尝试从响应中提取更多错误信息
-        QJsonParseError parseError;
-        QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
-        if (parseError.error == QJsonParseError::NoError && jsonDoc.isObject()) {
-            QJsonObject obj = jsonDoc.object();
-            if (obj.contains("message")) {
-                errorMsg += "\n错误信息: " + obj["message"].toString();
+    // 成功时返回207，responses按顺序对应每一项
+    QJsonObject body = QJsonDocument::fromJson(responseData).object();
+    QJsonArray responses = body["responses"].toArray();
+    bool succeeded = statusCode >= 200 && statusCode < 300;
+    if (succeeded && responses.size() == writes.size()) {
+        m_batchSupport = BatchSupported;
+        for (int i = 0; i < writes.size(); ++i) {
+            QJsonObject item = responses.at(i).toObject();
+            if (writes.at(i).reply) {
+                finishWrite(writes.at(i).kind, item["status"].toInt(), item["body"].toObject(), writes.at(i).reply);
             }
         }
-        
-        emit error(errorMsg);
+        apiReply->finish();
         return;
     }
     
-    // 解析成功响应
-    QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
-    if (parseError.error != QJsonParseError::NoError) {
-        emit error("JSON解析错误: " + parseError.errorString());
-        return;
-    }
-    
-    if (!jsonDoc.isObject()) {
-        emit error("无效的响应格式，预期是文章对象");
-        return;
-    }
-    
-    QJsonObject jsonObj = jsonDoc.object();
+    // 服务器没有batch/v1路由（WordPress 5.6之前或被禁用）：之后都逐个发送
+    // 超过了服务器的数量上限（requests参数校验失败）：这一批逐个重新发送
+    bool unsupported = statusCode == 404 || statusCode == 405 || statusCode == 501;
+    bool tooLarge = statusCode == 400 && body["code"].toString() == "rest_invalid_param"
+                    && body["data"].toObject()["params"].toObject().contains("requests");
     
-    // 提取文章信息
-    int remoteId = jsonObj["id"].toInt();
-    qDebug() << "WordPress返回的远程ID: " << remoteId;
+    QString errorMessage = succeeded ? QString("batch/v1响应的项数与请求不一致")
+                                     : networkErrorMessage(reply, responseData);
+    apiReply->finishWithError(errorMessage);
     
-    QString title;
-    if (jsonObj.contains("title") && jsonObj["title"].isObject()) {
-        title = jsonObj["title"].toObject()["rendered"].toString();
-    } else {
-        title = "未知标题";
-    }
-    
-    QString content;
-    if (jsonObj.contains("content") && jsonObj["content"].isObject()) {
-        content = jsonObj["content"].toObject()["rendered"].toString();
-    } else {
-        content = "";
-    }
-    
-    QString excerpt;
-    if (jsonObj.contains("excerpt") && jsonObj["excerpt"].isObject()) {
-        excerpt = jsonObj["excerpt"].toObject()["rendered"].toString();
-    } else {
-        excerpt = "";
-    }
-    
-    QDateTime publishDate = QDateTime::currentDateTime();
-    if (jsonObj.contains("date")) {
-        publishDate = QDateTime::fromString(jsonObj["date"].toString(), Qt::ISODate);
-    }
-    
-    QString author = jsonObj["author"].toString();
-    Post::Status status = jsonObj["status"].toString() == "publish" ? Post::Published : Post::Draft;
-    
-    // 创建一个新的Post对象
-    // 使用-1作为本地ID（稍后会由调用者更新）
-    Post post(-1, title, content, excerpt, publishDate, author, status);
-    post.setRemoteId(remoteId);  // 设置WordPress远程ID
-    
-    // 处理分类和标签
-    if (jsonObj.contains("categories") && jsonObj["categories"].isArray()) {
-        QJsonArray categories = jsonObj["categories"].toArray();
-        for (const QJsonValue& catId : categories) {
-            // 从数据库获取分类名称
-            QSqlQuery query;
-            query.prepare("SELECT name FROM categories WHERE id = :id");
-            query.bindValue(":id", catId.toInt());
-            if (query.exec() && query.next()) {
-                post.addCategory(query.value(0).toString());
+    // 其他情况（连接中断、服务器错误、认证失败、响应项数不对等）与单独请求失败时一样，每项都以这个错误结束；
+    // 服务器可能已经执行了其中一部分，不能重新发送
+    if (!unsupported && !tooLarge) {
+        qCWarning(lcNetwork) << "batch/v1请求失败: HTTP" << statusCode << errorMessage;
+        for (const PendingWrite& write : std::as_const(writes)) {
+            if (write.reply) {
+                write.reply->finishWithError(errorMessage);
             }
         }
+        return;
     }
     
-    if (jsonObj.contains("tags") && jsonObj["tags"].isArray()) {
-        QJsonArray tags = jsonObj["tags"].toArray();
-        for (const QJsonValue& tagId : tags) {
-            // 从数据库获取标签名称
-            QSqlQuery query;
-            query.prepare("SELECT name FROM tags WHERE id = :id");
-            query.bindValue(":id", tagId.toInt());
-            if (query.exec() && query.next()) {
-                post.addTag(query.value(0).toString());
-            }
+    if (unsupported) {
+        qCWarning(lcNetwork) << "服务器不支持batch/v1，改为逐个发送写操作";
+        m_batchSupport = BatchUnsupported;
+    } else {
+        qCWarning(lcNetwork) << "batch/v1请求超过了服务器的数量上限，这一批改为逐个发送";
+    }
+    for (const PendingWrite& write : std::as_const(writes)) {
+        if (write.reply && !write.reply->isFinished() && !write.reply->hasError()) {
+            sendWrite(write);
         }
     }
-    
-    emit postUpdated(post);
 }
 
-void WordPressAPI::onPostDeleted()
+void WordPressAPI::onCategoriesReceived(QNetworkReply* reply, ApiReply* apiReply)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        return;
-    }
-    
     QByteArray responseData = reply->readAll();
-    reply->deleteLater();
     
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
-    if (jsonDoc.isObject()) {
-        QJsonObject jsonObj = jsonDoc.object();
-        
-        if (jsonObj["deleted"].toBool()) {
-            int id = jsonObj["previous"].toObject()["id"].toInt();
-            emit postDeleted(id);
-        } else {
-            emit error("删除文章失败");
-        }
-    } else {
-        emit error("无效的响应格式");
-    }
-}
-
-void WordPressAPI::onCategoriesReceived()
-{
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
+    if (reply->error() != QNetworkReply::NoError) {
+        apiReply->finishWithError(networkErrorMessage(reply, responseData));
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    reply->deleteLater();
-    
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
     if (jsonDoc.isArray()) {
-        QList<Category> categories = parseCategories(jsonDoc.array());
-        emit categoriesReceived(categories);
+        apiReply->m_categories = parseCategories(jsonDoc.array());
+        apiReply->finish();
     } else {
-        emit error("无效的响应格式");
+        apiReply->finishWithError("无效的响应格式");
     }
 }
 
-void WordPressAPI::onTagsReceived()
+void WordPressAPI::onTagsReceived(QNetworkReply* reply, ApiReply* apiReply)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
+    QByteArray responseData = reply->readAll();
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        apiReply->finishWithError(networkErrorMessage(reply, responseData));
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    reply->deleteLater();
-    
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
     if (jsonDoc.isArray()) {
-        QList<Tag> tags = parseTags(jsonDoc.array());
-        emit tagsReceived(tags);
+        apiReply->m_tags = parseTags(jsonDoc.array());
+        apiReply->finish();
     } else {
-        emit error("无效的响应格式");
+        apiReply->finishWithError("无效的响应格式");
     }
 }
 
-void WordPressAPI::onMediaUploaded()
+void WordPressAPI::onMediaUploaded(QNetworkReply* reply, ApiReply* apiReply)
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (!reply) {
-        emit error("无效的网络回复对象");
-        return;
-    }
-    
     // 检查HTTP状态码
     int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    qDebug() << "媒体上传 HTTP状态码: " << statusCode;
+    qCDebug(lcNetwork) << "媒体上传 HTTP状态码: " << statusCode;
     
     QByteArray responseData = reply->readAll();
-    qDebug() << "响应数据长度: " << responseData.size() << "字节";
+    qCDebug(lcNetwork) << "响应数据长度: " << responseData.size() << "字节";
     if (!responseData.isEmpty()) {
-        qDebug() << "响应数据预览: " << responseData.left(200) << "...";
+        qCDebug(lcNetwork) << "响应数据预览: " << responseData.left(200) << "...";
     }
     
-    reply->deleteLater();
-    
     // 检查状态码是否表示成功
     if (statusCode < 200 || statusCode >= 300) {
         QString errorMsg = QString("上传媒体失败，HTTP错误: %1").arg(statusCode);
@@ -954,9 +1131,11 @@ void WordPressAPI::onMediaUploaded()
             if (obj.contains("message")) {
                 errorMsg += "\n错误信息: " + obj["message"].toString();
             }
+        } else if (reply->error() != QNetworkReply::NoError) {
+            errorMsg = networkErrorMessage(reply, responseData);
         }
         
-        emit error(errorMsg);
+        apiReply->finishWithError(errorMsg);
         return;
     }
     
@@ -964,12 +1143,12 @@ void WordPressAPI::onMediaUploaded()
     QJsonParseError parseError;
     QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
     if (parseError.error != QJsonParseError::NoError) {
-        emit error("JSON解析错误: " + parseError.errorString());
+        apiReply->finishWithError("JSON解析错误: " + parseError.errorString());
         return;
     }
     
     if (!jsonDoc.isObject()) {
-        emit error("无效的响应格式，预期是媒体对象");
+        apiReply->finishWithError("无效的响应格式，预期是媒体对象");
         return;
     }
     
@@ -988,53 +1167,101 @@ void WordPressAPI::onMediaUploaded()
     }
 
     if (!url.isEmpty()) {
-        qDebug() << "媒体上传成功，URL: " << url;
-        emit mediaUploaded(url,mediaId);
+        qCDebug(lcNetwork) << "媒体上传成功，URL: " << url;
+        apiReply->m_mediaUrl = url;
+        apiReply->m_mediaId = mediaId;
+        apiReply->finish();
     } else {
-        emit error("在响应中找不到媒体URL");
+        apiReply->finishWithError("在响应中找不到媒体URL");
     }
+}
 
+void WordPressAPI::onConnectionProbed(QNetworkReply* reply, ApiReply* apiReply)
+{
+    QByteArray responseData = reply->readAll();
     
+    if (reply->error() != QNetworkReply::NoError) {
+        apiReply->finishWithError(networkErrorMessage(reply, responseData));
+        return;
+    }
+    
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData);
+    if (!jsonDoc.isObject() || !jsonDoc.object().contains("id")) {
+        apiReply->finishWithError("无效的响应格式，预期是用户对象");
+        return;
+    }
     
+    QJsonObject jsonObj = jsonDoc.object();
+    apiReply->m_userId = jsonObj["id"].toInt();
+    apiReply->m_userName = jsonObj["name"].toString();
+    apiReply->finish();
 }
 
-void WordPressAPI::handleNetworkError(QNetworkReply::NetworkError error)
+QString WordPressAPI::networkErrorMessage(QNetworkReply* reply, const QByteArray& responseData) const
 {
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-    if (reply) {
-        QString errorDetails = reply->errorString();
-        int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-        QUrl requestUrl = reply->request().url();
-        QByteArray responseData = reply->readAll();
+    QString errorDetails = reply->errorString();
+    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    QUrl requestUrl = reply->request().url();
+    
+    QString fullErrorMsg = QString("网络错误 [%1]: %2\nURL: %3\n")
+        .arg(statusCode)
+        .arg(errorDetails)
+        .arg(requestUrl.toString());
         
-        QString fullErrorMsg = QString("网络错误 [%1]: %2\nURL: %3\n")
-            .arg(statusCode)
-            .arg(errorDetails)
-            .arg(requestUrl.toString());
-            
-        // 尝试解析响应内容，获取更多错误信息
-        if (!responseData.isEmpty()) {
-            QJsonParseError parseError;
-            QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
-            
-            if (parseError.error == QJsonParseError::NoError && jsonDoc.isObject()) {
-                QJsonObject errorObj = jsonDoc.object();
-                if (errorObj.contains("message")) {
-                    fullErrorMsg += "API错误信息: " + errorObj["message"].toString() + "\n";
-                }
-                if (errorObj.contains("code")) {
-                    fullErrorMsg += "错误代码: " + errorObj["code"].toString();
-                }
-            } else {
-                fullErrorMsg += "响应内容: " + QString::fromUtf8(responseData);
+    // 尝试解析响应内容，获取更多错误信息
+    if (!responseData.isEmpty()) {
+        QJsonParseError parseError;
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(responseData, &parseError);
+        
+        if (parseError.error == QJsonParseError::NoError && jsonDoc.isObject()) {
+            QJsonObject errorObj = jsonDoc.object();
+            if (errorObj.contains("message")) {
+                fullErrorMsg += "API错误信息: " + errorObj["message"].toString() + "\n";
             }
+            if (errorObj.contains("code")) {
+                fullErrorMsg += "错误代码: " + errorObj["code"].toString();
+            }
+        } else {
+            fullErrorMsg += "响应内容: " + QString::fromUtf8(responseData);
         }
-        
-        qDebug() << "API错误详情:" << fullErrorMsg;
-        emit this->error(fullErrorMsg);
-    } else {
-        emit this->error("未知网络错误");
     }
+    
+    qCWarning(lcNetwork) << "API错误详情:" << fullErrorMsg;
+    return fullErrorMsg;
+}
+
+Post WordPressAPI::parsePostObject(const QJsonObject& jsonObj) const
+{
+    // 提取文章信息（没有日期时使用当前时间）
+    Post post;
+    PostSchema::readJson(post, jsonObj);
+    if (!jsonObj["title"].isObject()) {
+        post.setTitle("未知标题");
+    }
+    qCDebug(lcParse) << "WordPress返回的远程ID: " << post.remoteId();
+    
+    // 处理分类和标签（只保留本地已知的ID）
+    if (jsonObj.contains("categories") && jsonObj["categories"].isArray()) {
+        TermIds categoryIds;
+        for (const QJsonValue& catId : jsonObj["categories"].toArray()) {
+            if (TermTable::categories().contains(catId.toInt())) {
+                categoryIds.append(catId.toInt());
+            }
+        }
+        post.setCategoryIds(std::move(categoryIds));
+    }
+    
+    if (jsonObj.contains("tags") && jsonObj["tags"].isArray()) {
+        TermIds tagIds;
+        for (const QJsonValue& tagId : jsonObj["tags"].toArray()) {
+            if (TermTable::tags().contains(tagId.toInt())) {
+                tagIds.append(tagId.toInt());
+            }
+        }
+        post.setTagIds(std::move(tagIds));
+    }
+    
+    return post;
 }
 
 QList<Post> WordPressAPI::parsePosts(const QJsonArray& jsonArray)
@@ -1048,90 +1275,68 @@ QList<Post> WordPressAPI::parsePosts(const QJsonArray& jsonArray)
         
         QJsonObject jsonObj = value.toObject();
         
-        int id = jsonObj["id"].toInt();
-        QString title = jsonObj["title"].toObject()["rendered"].toString();
-        QString content = jsonObj["content"].toObject()["rendered"].toString();
-        QString excerpt = jsonObj["excerpt"].toObject()["rendered"].toString();
-        QDateTime publishDate = QDateTime::fromString(jsonObj["date"].toString(), Qt::ISODate);
-        QString author = jsonObj["author"].toString(); // 理想情况下应该获取作者名称
-        Post::Status status = jsonObj["status"].toString() == "publish" ? Post::Published : Post::Draft;
-        
-        Post post(id, title, content, excerpt, publishDate, author, status);
+        // 本地ID由数据库分配，保存时按远程ID匹配已有记录
+        Post post;
+        PostSchema::readJson(post, jsonObj);
+        int id = post.remoteId();
         
-        // 处理特色图片
-        if (jsonObj.contains("featured_media") && jsonObj["featured_media"].toInt() > 0) {
-            // 理想情况下，我们应该单独获取媒体信息
-            // 这里简化处理
-        }
-        
-        // 处理分类
+        // 处理分类：ID直接放入文章
         if (jsonObj.contains("categories") && jsonObj["categories"].isArray()) {
             QJsonArray categoriesArray = jsonObj["categories"].toArray();
-            qDebug() << "处理文章分类，文章ID:" << id << "，分类数量:" << categoriesArray.size();
+            qCDebug(lcParse) << "处理文章分类，文章ID:" << id << "，分类数量:" << categoriesArray.size();
             
+            TermIds categoryIds;
             for (const QJsonValue& catValue : categoriesArray) {
                 int categoryId = catValue.toInt();
-                
-                // 从数据库中查找分类名称
-                QSqlQuery query;
-                query.prepare("SELECT name FROM categories WHERE id = :id");
-                query.bindValue(":id", categoryId);
-                
-                QString categoryName;
-                if (query.exec() && query.next()) {
-                    categoryName = query.value(0).toString();
-                    qDebug() << "找到分类: ID=" << categoryId << "名称=" << categoryName;
-                } else {
-                    // 如果数据库中没有找到，从远程获取分类信息
-                    categoryName = QString("分类%1").arg(categoryId); // 临时名称
-                    qDebug() << "未找到分类，使用临时名称: ID=" << categoryId << "名称=" << categoryName;
-                    
-                    // 创建新的分类条目
-                    Category category(categoryId, categoryName);
-                    DatabaseManager::instance().saveCategory(category);
+                if (categoryId > 0) {
+                    categoryIds.append(categoryId);
                 }
-                
-                post.addCategory(categoryName);
             }
+            post.setCategoryIds(std::move(categoryIds));
         }
         
         // 处理标签
         if (jsonObj.contains("tags") && jsonObj["tags"].isArray()) {
             QJsonArray tagsArray = jsonObj["tags"].toArray();
-            qDebug() << "处理文章标签，文章ID:" << id << "，标签数量:" << tagsArray.size();
+            qCDebug(lcParse) << "处理文章标签，文章ID:" << id << "，标签数量:" << tagsArray.size();
             
+            TermIds tagIds;
             for (const QJsonValue& tagValue : tagsArray) {
                 int tagId = tagValue.toInt();
-                
-                // 从数据库中查找标签名称
-                QSqlQuery query;
-                query.prepare("SELECT name FROM tags WHERE id = :id");
-                query.bindValue(":id", tagId);
-                
-                QString tagName;
-                if (query.exec() && query.next()) {
-                    tagName = query.value(0).toString();
-                    qDebug() << "找到标签: ID=" << tagId << "名称=" << tagName;
-                } else {
-                    // 如果数据库中没有找到，从远程获取标签信息
-                    tagName = QString("标签%1").arg(tagId); // 临时名称
-                    qDebug() << "未找到标签，使用临时名称: ID=" << tagId << "名称=" << tagName;
-                    
-                    // 创建新的标签条目
-                    Tag tag(tagId, tagName);
-                    DatabaseManager::instance().saveTag(tag);
+                if (tagId > 0) {
+                    tagIds.append(tagId);
                 }
-                
-                post.addTag(tagName);
             }
+            post.setTagIds(std::move(tagIds));
         }
         
-        posts.append(post);
+        registerUnknownTerms(post);
+        posts.append(std::move(post));
     }
     
     return posts;
 }
 
+void WordPressAPI::registerUnknownTerms(const Post& post)
+{
+    for (int categoryId : post.categoryIds()) {
+        if (!TermTable::categories().contains(categoryId)) {
+            // 临时名称，获取分类列表时会被真实名称覆盖
+            Category category(categoryId, QString("分类%1").arg(categoryId));
+            qCDebug(lcParse) << "未找到分类，使用临时名称: ID=" << categoryId << "名称=" << category.name();
+            DatabaseManager::instance().saveCategory(category);
+        }
+    }
+    
+    for (int tagId : post.tagIds()) {
+        if (!TermTable::tags().contains(tagId)) {
+            Tag tag(tagId, QString("标签%1").arg(tagId));
+            qCDebug(lcParse) << "未找到标签，使用临时名称: ID=" << tagId << "名称=" << tag.name();
+            DatabaseManager::instance().saveTag(tag);
+        }
+    }
+}
+
 QList<Category> WordPressAPI::parseCategories(const QJsonArray& jsonArray)
 {
     QList<Category> categories;
@@ -1144,7 +1349,7 @@ QList<Category> WordPressAPI::parseCategories(const QJsonArray& jsonArray)
         QJsonObject jsonObj = value.toObject();
         
         int id = jsonObj["id"].toInt();
-        QString name = jsonObj["name"].toString();
+        QString name = StringPool::instance().intern(jsonObj["name"].toString());
         
         categories.append(Category(id, name));
     }
@@ -1164,7 +1369,7 @@ QList<Tag> WordPressAPI::parseTags(const QJsonArray& jsonArray)
         QJsonObject jsonObj = value.toObject();
         
         int id = jsonObj["id"].toInt();
-        QString name = jsonObj["name"].toString();
+        QString name = StringPool::instance().intern(jsonObj["name"].toString());
         
         tags.append(Tag(id, name));
     }
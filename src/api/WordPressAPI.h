@@ -11,19 +11,50 @@
 #include <QFile>
 #include <QString>
 #include <QUrl>
+#include <QUrlQuery>
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QPointer>
+#include <QSslConfiguration>
+#include <QDateTime>
+#include <map>
+#include <memory>
 
 #include "models/Post.h"
 #include "models/Category.h"
 #include "models/Tag.h"
+#include "ApiReply.h"
 
 class WordPressAPI : public QObject
 {
     Q_OBJECT
 
 public:
+    // 连接统计，用于确认预热连接和TLS会话是否被复用
+    struct ConnectionStats
+    {
+        int requests = 0;           // 发出的请求数
+        int warmUps = 0;            // 预热次数
+        int tlsHandshakes = 0;      // 完整或恢复的TLS握手次数
+        int ticketHandshakes = 0;   // 携带会话票据（尝试恢复会话）的握手次数
+        int reusedConnections = 0;  // 复用已有连接、无需握手的HTTPS请求数
+        int http2Requests = 0;      // 通过HTTP/2完成的请求数
+        int http1Requests = 0;      // 通过HTTP/1.1完成的请求数
+        int peakHttp2Streams = 0;   // 同一主机的HTTP/2连接上同时进行的最大流数（只计收到响应头、确认使用HTTP/2的请求）
+        int batchRequests = 0;      // 发出的batch/v1请求数（也计入requests）
+        int batchedWrites = 0;      // 通过batch/v1发送的写操作数
+    };
+
+    // batch/v1每个请求最多包含的操作数（WordPress的默认上限）
+    static const int BatchLimit = 25;
+
+    // 当前站点的会话
     static WordPressAPI& instance();
+    // 每个站点一个会话（各自的地址、凭据、连接和批量写入队列），切换站点时已建立的连接不会丢失
+    static WordPressAPI& session(const QString& siteId);
+    static void setCurrentSession(const QString& siteId);
+    static QString currentSession();
     ~WordPressAPI();
 
     // 设置API访问信息
@@ -31,64 +62,50 @@ public:
     void setCredentials(const QString& username, const QString& password);
     QString apiUrl() const;
     
+    // 预热连接：提前建立到站点的TLS连接，避免第一个请求承担完整的握手延迟
+    void warmUp();
+    ConnectionStats connectionStats() const;
+    // 还没有完成的请求数
+    int inFlightRequests() const;
+    
+    // 连接测试：只请求当前用户的id和名称，用于验证凭据并测量延迟
+    ApiReply* probeConnection();
+    
     // 博客文章操作
-    void fetchPosts();
-    void createPost(const Post& post);
-    void updatePost(const Post& post);
-    void deletePost(int postId);
+    // 每个调用都返回独立的请求句柄，结果和错误通过句柄的finished()获取
+    // 按页获取文章；modifiedAfter有效时只获取在此之后修改过的文章（增量同步）
+    ApiReply* fetchPosts(int page = 1, int perPage = 100, const QDateTime& modifiedAfter = QDateTime());
+    // 文章索引：只获取远程ID和修改时间（posts()中的文章只有remoteId()和remoteModified()），按ID升序
+    // 用于与本地文章对比，找出新增、修改和远程已删除的文章
+    ApiReply* fetchPostIndex(int page = 1, int perPage = 100);
+    // 获取一篇文章的当前版本（posts()中最多一篇），推送修改前用来检查远程是否被修改过
+    ApiReply* fetchPost(int remoteId);
+    // 一次获取多篇文章的当前版本（最多100篇），批量推送前检查远程是否被修改过；已删除的文章不在posts()中
+    ApiReply* fetchPostsById(const QList<int>& remoteIds);
+    ApiReply* createPost(const Post& post);
+    // fields：需要发送的字段，由调用方与上次同步时的状态比较得到（DatabaseManager::unsyncedFields()）；
+    // 为空时不发送请求，返回的句柄isUnchanged()
+    ApiReply* updatePost(const Post& post, Post::Fields fields);
+    ApiReply* deletePost(int postId);
+    
+    // 批量写入：同一轮事件循环中发起的创建、更新和删除合并为batch/v1请求（每个最多BatchLimit项），
+    // 每个操作仍然得到自己的ApiReply；服务器不支持batch/v1时自动改为逐个发送。默认启用
+    void setBatchingEnabled(bool enabled);
+    bool batchingEnabled() const;
     
     // 分类操作
-    void fetchCategories();
-    void createCategory(const Category& category);
-    void updateCategory(const Category& category);
-    void deleteCategory(int categoryId);
+    ApiReply* fetchCategories();
     
     // 标签操作
-    void fetchTags();
-    void createTag(const Tag& tag);
-    void updateTag(const Tag& tag);
-    void deleteTag(int tagId);
+    ApiReply* fetchTags();
     
     // 媒体上传
-    void uploadMedia(const QString& filePath, const QString& title = "");
-
-signals:
-    // 博客文章信号
-    void postsReceived(const QList<Post>& posts);
-    void postCreated(const Post& post);
-    void postUpdated(const Post& post);
-    void postDeleted(int postId);
-    
-    // 分类信号
-    void categoriesReceived(const QList<Category>& categories);
-    void categoryCreated(const Category& category);
-    void categoryUpdated(const Category& category);
-    void categoryDeleted(int categoryId);
-    
-    // 标签信号
-    void tagsReceived(const QList<Tag>& tags);
-    void tagCreated(const Tag& tag);
-    void tagUpdated(const Tag& tag);
-    void tagDeleted(int tagId);
-    
-    // 媒体信号
-    void mediaUploaded(const QString& url,int mediaId);
-    
-    // 上传进度信号
-    void uploadProgress(qint64 bytesSent, qint64 bytesTotal);
-    
-    // 错误信号
-    void error(const QString& errorMessage);
-
-private slots:
-    void onPostsReceived();
-    void onPostCreated();
-    void onPostUpdated();
-    void onPostDeleted();
-    void onCategoriesReceived();
-    void onTagsReceived();
-    void onMediaUploaded();
-    void handleNetworkError(QNetworkReply::NetworkError errorCode);
+    ApiReply* uploadMedia(const QString& filePath, const QString& title = "");
+    
+    // 把文章数组解析为Post列表（分类和标签名称从本地数据库查找）
+    // fetchPosts()使用PostStreamParser在数据到达时解析，这里用于已经解码的JSON文档
+    // 公开以便基准测试直接测量解析开销
+    QList<Post> parsePosts(const QJsonArray& jsonArray);
 
 private:
     WordPressAPI(QObject* parent = nullptr);
@@ -100,8 +117,68 @@ private:
     // 创建认证头
     QByteArray createAuthHeader() const;
     
+    // 为请求应用共享的SSL配置，并允许HTTP/2
+    void configureRequest(QNetworkRequest& request) const;
+    
+    // 创建请求句柄，并把网络回复的完成事件转交给对应的处理函数
+    // apiReply为空时新建一个句柄
+    ApiReply* startRequest(QNetworkReply* reply, void (WordPressAPI::*handler)(QNetworkReply*, ApiReply*),
+                           const QString& spanName, ApiReply* apiReply = nullptr);
+    ApiReply* failedRequest(const QString& errorMessage);
+    // fetchPosts()、fetchPostIndex()和fetchPost()共用：流式解析的文章列表请求
+    ApiReply* requestPosts(const QUrlQuery& query, int page, const QString& spanName);
+    
+    // 处理网络回复
+    void onPostsReceived(QNetworkReply* reply, ApiReply* apiReply);
+    void onPostCreated(QNetworkReply* reply, ApiReply* apiReply);
+    void onPostUpdated(QNetworkReply* reply, ApiReply* apiReply);
+    void onPostDeleted(QNetworkReply* reply, ApiReply* apiReply);
+    void onBatchReceived(QNetworkReply* reply, ApiReply* apiReply);
+    void onCategoriesReceived(QNetworkReply* reply, ApiReply* apiReply);
+    void onTagsReceived(QNetworkReply* reply, ApiReply* apiReply);
+    void onMediaUploaded(QNetworkReply* reply, ApiReply* apiReply);
+    void onConnectionProbed(QNetworkReply* reply, ApiReply* apiReply);
+    QString networkErrorMessage(QNetworkReply* reply, const QByteArray& responseData) const;
+    Post parsePostObject(const QJsonObject& jsonObj) const;
+    
+    // 文章的写操作（单独发送或放在batch/v1中）
+    enum WriteKind
+    {
+        CreateWrite,
+        UpdateWrite,
+        DeleteWrite
+    };
+    
+    struct PendingWrite
+    {
+        WriteKind kind;
+        QString route;          // 相对API地址的路由，例如 posts/12?force=true
+        QJsonObject body;
+        QPointer<ApiReply> reply;
+    };
+    
+    // 服务器是否支持batch/v1（第一次批量请求之后确定）
+    enum BatchSupport
+    {
+        BatchUnknown,
+        BatchSupported,
+        BatchUnsupported
+    };
+    
+    ApiReply* queueWrite(WriteKind kind, const QString& route, const QJsonObject& body);
+    void flushWrites();
+    void sendWrite(const PendingWrite& write);
+    void sendBatch(const QList<PendingWrite>& writes);
+    // batch/v1的地址；API地址中没有wp/v2命名空间时为空
+    QString batchUrl() const;
+    void onPostWritten(QNetworkReply* reply, ApiReply* apiReply, WriteKind kind);
+    // 处理一个写操作的结果（单独请求的响应或batch/v1响应中的一项）
+    void finishWrite(WriteKind kind, int statusCode, const QJsonObject& body, ApiReply* apiReply);
+    
+    // 本地还不知道的分类和标签ID先以临时名称保存，获取分类和标签列表时会被真实名称覆盖
+    void registerUnknownTerms(const Post& post);
+    
     // 解析返回的JSON数据
-    QList<Post> parsePosts(const QJsonArray& jsonArray);
     QList<Category> parseCategories(const QJsonArray& jsonArray);
     QList<Tag> parseTags(const QJsonArray& jsonArray);
     
@@ -109,6 +186,18 @@ private:
     QString m_username;
     QString m_password;
     QNetworkAccessManager* m_networkManager;
+    QSslConfiguration m_sslConfiguration;
+    bool m_insecureSsl = false;     // 不验证服务器证书（设置network/insecureSsl，仅用于开发环境）
+    ConnectionStats m_connectionStats;
+    int m_inFlightRequests = 0;
+    QHash<QString, int> m_http2Streams;     // 各主机上进行中的HTTP/2请求数
+    
+    bool m_batchingEnabled = true;
+    BatchSupport m_batchSupport = BatchUnknown;
+    bool m_flushScheduled = false;
+    QList<PendingWrite> m_pendingWrites;
+    QHash<QNetworkReply*, QList<PendingWrite>> m_batches;   // 进行中的batch/v1请求包含的操作
     
-    static std::unique_ptr<WordPressAPI> s_instance;
+    static std::map<QString, std::unique_ptr<WordPressAPI>> s_sessions;
+    static QString s_currentSession;
 }; 
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "BinaryDelta.h"
+#include <QHash>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const char FormatVersion = 1;
+const char OpInsert = 0;
+const char OpCopy = 1;
+
+// 建立索引的块大小，同时也是最短的复制长度（更短的匹配不如直接插入）
+const int BlockSize = 16;
+
+void writeVarint(QByteArray& out, quint64 value)
+{
+    while (value >= 0x80) {
+        out.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(char(value));
+}
+
+bool readVarint(const QByteArray& in, int& pos, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        uchar byte = uchar(in.at(pos++));
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+quint64 blockKey(const char* data)
+{
+    // FNV-1a，块内容完全相同的位置哈希相同，匹配后再逐字节确认
+    quint64 hash = 1469598103934665603ULL;
+    for (int i = 0; i < BlockSize; ++i) {
+        hash ^= uchar(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void flushInsert(QByteArray& out, const char* data, int length)
+{
+    if (length <= 0) {
+        return;
+    }
+    out.append(OpInsert);
+    writeVarint(out, quint64(length));
+    out.append(data, length);
+}
+
+}
+
+QByteArray BinaryDelta::encode(const QByteArray& base, const QByteArray& target)
+{
+    QByteArray out;
+    out.append(FormatVersion);
+    writeVarint(out, quint64(target.size()));
+
+    const char* b = base.constData();
+    const char* t = target.constData();
+    const int baseSize = base.size();
+    const int targetSize = target.size();
+
+    // 基准中每个对齐块的位置（同样内容的块只记第一个）
+    QHash<quint64, int> index;
+    index.reserve(baseSize / BlockSize + 1);
+    for (int offset = 0; offset + BlockSize <= baseSize; offset += BlockSize) {
+        quint64 key = blockKey(b + offset);
+        if (!index.contains(key)) {
+            index.insert(key, offset);
+        }
+    }
+
+    int literalStart = 0;
+    int pos = 0;
+    while (pos + BlockSize <= targetSize) {
+        auto it = index.constFind(blockKey(t + pos));
+        if (it == index.constEnd() || std::memcmp(b + it.value(), t + pos, BlockSize) != 0) {
+            ++pos;
+            continue;
+        }
+
+        int baseStart = it.value();
+        int targetStart = pos;
+
+        // 向后扩展到不再相同为止
+        int length = BlockSize;
+        while (targetStart + length < targetSize && baseStart + length < baseSize
+               && t[targetStart + length] == b[baseStart + length]) {
+            ++length;
+        }
+
+        // 向前扩展，吃掉尚未输出的插入字节
+        while (targetStart > literalStart && baseStart > 0 && t[targetStart - 1] == b[baseStart - 1]) {
+            --targetStart;
+            --baseStart;
+            ++length;
+        }
+
+        flushInsert(out, t + literalStart, targetStart - literalStart);
+        out.append(OpCopy);
+        writeVarint(out, quint64(baseStart));
+        writeVarint(out, quint64(length));
+
+        pos = targetStart + length;
+        literalStart = pos;
+    }
+
+    flushInsert(out, t + literalStart, targetSize - literalStart);
+    return out;
+}
+
+bool BinaryDelta::apply(const QByteArray& base, const QByteArray& delta, QByteArray* target)
+{
+    if (!target || delta.isEmpty() || delta.at(0) != FormatVersion) {
+        return false;
+    }
+
+    int pos = 1;
+    quint64 targetSize = 0;
+    if (!readVarint(delta, pos, targetSize) || targetSize > quint64(std::numeric_limits<int>::max())) {
+        return false;
+    }
+
+    // 长度来自保存的数据，损坏时可能很大：预留的空间不超过base和差异本身的大小，
+    // 由复制指令重复产生的更长结果按需增长
+    QByteArray out;
+    out.reserve(int(qMin(targetSize, quint64(base.size()) + quint64(delta.size()))));
+
+    while (pos < delta.size()) {
+        char op = delta.at(pos++);
+        if (op == OpInsert) {
+            quint64 length = 0;
+            if (!readVarint(delta, pos, length) || length > quint64(delta.size() - pos)) {
+                return false;
+            }
+            out.append(delta.constData() + pos, int(length));
+            pos += int(length);
+        } else if (op == OpCopy) {
+            quint64 offset = 0;
+            quint64 length = 0;
+            if (!readVarint(delta, pos, offset) || !readVarint(delta, pos, length)
+                || offset > quint64(base.size()) || length > quint64(base.size()) - offset) {
+                return false;
+            }
+            out.append(base.constData() + offset, int(length));
+        } else {
+            return false;
+        }
+    }
+
+    if (quint64(out.size()) != targetSize) {
+        return false;
+    }
+
+    *target = std::move(out);
+    return true;
+}
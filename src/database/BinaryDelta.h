@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QByteArray>
+
+// 二进制差异编码，用于文章修订历史
+// 差异由“从基准复制一段”和“插入新字节”两种指令组成：
+//   头部：格式版本(1字节) + 目标长度(varint)
+//   指令：0x00 长度(varint) 字节... 插入
+//         0x01 偏移(varint) 长度(varint) 从基准复制
+// 编码时把基准按固定大小的块建立哈希索引，在目标中查找匹配并向两侧扩展，
+// 适合“在一篇长文章里改几处”这类修改，时间和空间都与两者长度成线性关系。
+class BinaryDelta
+{
+public:
+    // 计算把base变成target的差异
+    static QByteArray encode(const QByteArray& base, const QByteArray& target);
+
+    // 把差异应用到base上；差异损坏或与base不匹配时返回false
+    static bool apply(const QByteArray& base, const QByteArray& delta, QByteArray* target);
+
+private:
+    BinaryDelta() = delete;
+};
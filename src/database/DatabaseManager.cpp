@@ -1,10 +1,196 @@
 #include "DatabaseManager.h"
 #include <QDebug>
 #include <QDir>
+#include <QHash>
 #include <QStandardPaths>
+#include <QStringList>
+#include <utility>
+#include "diagnostics/Tracing.h"
+#include "models/TermTable.h"
+#include "models/StringPool.h"
+#include "BinaryDelta.h"
+#include "PostColumns.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 
 std::unique_ptr<DatabaseManager> DatabaseManager::s_instance = nullptr;
 
+namespace {
+
+// 数据库结构版本（PRAGMA user_version）
+// 1: 正文可以保存为压缩BLOB
+// 2: content_hash/terms_hash列
+// 3: remote_modified列
+const int SchemaVersion = 3;
+
+// 插入一篇文章全部列（以及两个摘要列）的语句
+QString insertPostSql()
+{
+    using Sql = PostColumns::Sql<PostSchema::Columns>;
+    return QString("INSERT INTO posts (%1, content_hash, terms_hash) VALUES (%2, ?, ?)")
+        .arg(QLatin1String(Sql::names.data()), QLatin1String(Sql::placeholders.data()));
+}
+
+// 一行全部列的摘要；没有加载正文时无法计算，保存为NULL（下次保存时一定重写）
+QVariant rowHash(const Post& post)
+{
+    return post.isContentLoaded() ? QVariant(qint64(PostSchema::hashRow(post))) : QVariant();
+}
+
+// 修订内容的序列化：紧凑JSON（键按字母排序，输出稳定，相邻修订的差异很小）
+QByteArray serializeRevision(const Post& post)
+{
+    QJsonArray categories;
+    for (int id : post.categoryIds()) {
+        categories.append(id);
+    }
+    QJsonArray tags;
+    for (int id : post.tagIds()) {
+        tags.append(id);
+    }
+    
+    QJsonObject object;
+    object["title"] = post.title();
+    object["content"] = post.content();
+    object["excerpt"] = post.excerpt();
+    object["status"] = int(post.status());
+    object["featured_image_url"] = post.featuredImageUrl();
+    object["categories"] = categories;
+    object["tags"] = tags;
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+bool deserializeRevision(const QByteArray& data, Post& post)
+{
+    QJsonDocument document = QJsonDocument::fromJson(data);
+    if (!document.isObject()) {
+        return false;
+    }
+    
+    QJsonObject object = document.object();
+    post.setTitle(object["title"].toString());
+    post.setContent(object["content"].toString());
+    post.setExcerpt(object["excerpt"].toString());
+    post.setStatus(static_cast<Post::Status>(object["status"].toInt()));
+    post.setFeaturedImageUrl(object["featured_image_url"].toString());
+    
+    TermIds categoryIds;
+    for (const QJsonValue& value : object["categories"].toArray()) {
+        categoryIds.append(value.toInt());
+    }
+    post.setCategoryIds(std::move(categoryIds));
+    
+    TermIds tagIds;
+    for (const QJsonValue& value : object["tags"].toArray()) {
+        tagIds.append(value.toInt());
+    }
+    post.setTagIds(std::move(tagIds));
+    return true;
+}
+
+// 同步基线的序列化：可编辑字段按列名保存，加上分类和标签
+QByteArray serializeSyncBase(const Post& post)
+{
+    QJsonObject object;
+    PostSchema::forEach(PostSchema::EditableColumns(), [&](auto field) {
+        using F = decltype(field);
+        object[QLatin1String(F::column)] = PostSchema::JsonCodec<typename F::Type>::toJson(F::get(post));
+    });
+    
+    QJsonArray categories;
+    for (int id : post.categoryIds()) {
+        categories.append(id);
+    }
+    QJsonArray tags;
+    for (int id : post.tagIds()) {
+        tags.append(id);
+    }
+    object["categories"] = categories;
+    object["tags"] = tags;
+    return qCompress(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+bool deserializeSyncBase(const QByteArray& data, Post& post)
+{
+    QJsonDocument document = QJsonDocument::fromJson(qUncompress(data));
+    if (!document.isObject()) {
+        return false;
+    }
+    
+    QJsonObject object = document.object();
+    PostSchema::forEach(PostSchema::EditableColumns(), [&](auto field) {
+        using F = decltype(field);
+        PostSchema::setFromJson<F>(post, object.value(QLatin1String(F::column)));
+    });
+    
+    TermIds categoryIds;
+    for (const QJsonValue& value : object["categories"].toArray()) {
+        categoryIds.append(value.toInt());
+    }
+    post.setCategoryIds(std::move(categoryIds));
+    
+    TermIds tagIds;
+    for (const QJsonValue& value : object["tags"].toArray()) {
+        tagIds.append(value.toInt());
+    }
+    post.setTagIds(std::move(tagIds));
+    return true;
+}
+
+// 把ID集合中的临时ID换成正式ID，名称还不在数据库中时先插入
+// 直接使用传入的连接（而不是saveCategory/saveTag），后台线程也可以调用
+bool resolveTermIds(QSqlDatabase& db, const QString& tableName, TermTable& table, TermIds& ids)
+{
+    for (int& id : ids) {
+        if (!TermTable::isProvisional(id)) {
+            continue;
+        }
+        
+        int resolved = table.resolved(id);
+        if (resolved == 0) {
+            QString name = table.name(id);
+            QSqlQuery query(db);
+            query.prepare(QString("INSERT OR IGNORE INTO %1 (name) VALUES (:name)").arg(tableName));
+            query.bindValue(":name", name);
+            if (!query.exec()) {
+                qCWarning(lcDatabase) << "创建" << tableName << "失败: " << query.lastError().text();
+                return false;
+            }
+            
+            query.prepare(QString("SELECT id FROM %1 WHERE name = :name").arg(tableName));
+            query.bindValue(":name", name);
+            if (!query.exec() || !query.next()) {
+                qCWarning(lcDatabase) << "查找" << tableName << "失败: " << query.lastError().text();
+                return false;
+            }
+            resolved = query.value(0).toInt();
+            table.insert(resolved, name);
+            qCDebug(lcDatabase) << "保存新词条: " << tableName << "ID=" << resolved << "名称=" << name;
+        }
+        id = resolved;
+    }
+    return true;
+}
+
+// 读取一张关联表，按文章ID分组为升序的ID集合
+QHash<int, TermIds> loadTermLinks(const QString& sql)
+{
+    QHash<int, TermIds> links;
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    if (!query.exec(sql + " ORDER BY 1, 2")) {
+        qCWarning(lcDatabase) << "读取文章关联失败: " << query.lastError().text();
+        return links;
+    }
+    while (query.next()) {
+        links[query.value(0).toInt()].append(query.value(1).toInt());
+    }
+    return links;
+}
+
+}
+
 DatabaseManager& DatabaseManager::instance()
 {
     if (!s_instance) {
@@ -14,6 +200,8 @@ DatabaseManager& DatabaseManager::instance()
 }
 
 DatabaseManager::DatabaseManager()
+    : m_compressContent(true),
+      m_lastRevisions(RevisionCacheBytes)
 {
 }
 
@@ -30,15 +218,39 @@ bool DatabaseManager::initialize()
         dir.mkpath(".");
     }
 
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
-    m_db.setDatabaseName(dataPath + "/blogclient.db");
+    return initialize(dataPath + "/blogclient.db");
+}
+
+bool DatabaseManager::initialize(const QString& databasePath)
+{
+    // 重复初始化时（例如基准测试切换数据集）复用默认连接，只更换数据库文件
+    close();
+    m_lastRevisions.clear();
+    if (QSqlDatabase::contains(QSqlDatabase::defaultConnection)) {
+        m_db = QSqlDatabase::database(QSqlDatabase::defaultConnection, false);
+    } else {
+        m_db = QSqlDatabase::addDatabase("QSQLITE");
+    }
+    m_db.setDatabaseName(databasePath);
+    // 自动保存在后台线程用另一个连接写入，写锁冲突时等待而不是立即失败
+    m_db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
 
     if (!m_db.open()) {
-        qDebug() << "数据库连接失败";
+        qCWarning(lcDatabase) << "数据库连接失败";
         return false;
     } else {
-        qDebug() << "数据库连接成功";
-        return createTables();
+        qCDebug(lcDatabase) << "数据库连接成功";
+        // WAL模式下后台线程写入时界面线程仍然可以读取
+        QSqlQuery pragma;
+        if (!pragma.exec("PRAGMA journal_mode=WAL")) {
+            qCWarning(lcDatabase) << "启用WAL失败: " << pragma.lastError().text();
+        }
+        
+        if (!createTables() || !migrate()) {
+            return false;
+        }
+        loadTermTables();
+        return true;
     }
 }
 
@@ -47,6 +259,21 @@ void DatabaseManager::close()
     m_db.close();
 }
 
+QString DatabaseManager::databasePath() const
+{
+    return m_db.databaseName();
+}
+
+void DatabaseManager::setContentCompression(bool enabled)
+{
+    m_compressContent = enabled;
+}
+
+bool DatabaseManager::contentCompression() const
+{
+    return m_compressContent;
+}
+
 bool DatabaseManager::createTables()
 {
     QSqlQuery query;
@@ -62,7 +289,7 @@ bool DatabaseManager::createTables()
                     "author TEXT, "
                     "status INTEGER, "
                     "featured_image_url TEXT)")) {
-        qDebug() << "创建posts表失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "创建posts表失败: " << query.lastError().text();
         return false;
     }
     
@@ -78,18 +305,23 @@ bool DatabaseManager::createTables()
         }
         
         if (!hasRemoteIdColumn) {
-            qDebug() << "添加remote_id列到posts表";
+            qCDebug(lcDatabase) << "添加remote_id列到posts表";
             if (!query.exec("ALTER TABLE posts ADD COLUMN remote_id INTEGER DEFAULT -1")) {
-                qDebug() << "添加remote_id列失败: " << query.lastError().text();
+                qCWarning(lcDatabase) << "添加remote_id列失败: " << query.lastError().text();
             }
         }
     }
     
+    // 按远程ID查找文章（同步时的去重匹配）
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_posts_remote_id ON posts (remote_id)")) {
+        qCWarning(lcDatabase) << "创建remote_id索引失败: " << query.lastError().text();
+    }
+    
     // 创建categories表
     if (!query.exec("CREATE TABLE IF NOT EXISTS categories ("
                     "id INTEGER PRIMARY KEY AUTOINCREMENT, "
                     "name TEXT NOT NULL UNIQUE)")) {
-        qDebug() << "创建categories表失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "创建categories表失败: " << query.lastError().text();
         return false;
     }
     
@@ -97,7 +329,7 @@ bool DatabaseManager::createTables()
     if (!query.exec("CREATE TABLE IF NOT EXISTS tags ("
                     "id INTEGER PRIMARY KEY AUTOINCREMENT, "
                     "name TEXT NOT NULL UNIQUE)")) {
-        qDebug() << "创建tags表失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "创建tags表失败: " << query.lastError().text();
         return false;
     }
     
@@ -108,7 +340,43 @@ bool DatabaseManager::createTables()
                     "PRIMARY KEY (post_id, category_id), "
                     "FOREIGN KEY (post_id) REFERENCES posts (id) ON DELETE CASCADE, "
                     "FOREIGN KEY (category_id) REFERENCES categories (id) ON DELETE CASCADE)")) {
-        qDebug() << "创建post_categories表失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "创建post_categories表失败: " << query.lastError().text();
+        return false;
+    }
+    
+    // 创建post_revisions表：每个修订保存完整快照（qCompress压缩）或相对上一修订的BinaryDelta差异
+    if (!query.exec("CREATE TABLE IF NOT EXISTS post_revisions ("
+                    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                    "post_id INTEGER NOT NULL, "
+                    "revision INTEGER NOT NULL, "
+                    "created_at DATETIME, "
+                    "is_snapshot INTEGER NOT NULL, "
+                    "full_size INTEGER, "
+                    "data BLOB, "
+                    "UNIQUE (post_id, revision), "
+                    "FOREIGN KEY (post_id) REFERENCES posts (id) ON DELETE CASCADE)")) {
+        qCWarning(lcDatabase) << "创建post_revisions表失败: " << query.lastError().text();
+        return false;
+    }
+    
+    // 创建post_sync_hashes表：上次同步时各字段的摘要（field为Post::Field）
+    if (!query.exec("CREATE TABLE IF NOT EXISTS post_sync_hashes ("
+                    "post_id INTEGER NOT NULL, "
+                    "field INTEGER NOT NULL, "
+                    "hash INTEGER NOT NULL, "
+                    "PRIMARY KEY (post_id, field), "
+                    "FOREIGN KEY (post_id) REFERENCES posts (id) ON DELETE CASCADE)")) {
+        qCWarning(lcDatabase) << "创建post_sync_hashes表失败: " << query.lastError().text();
+        return false;
+    }
+    
+    // 创建post_sync_base表：上次同步时的完整版本（压缩的JSON），三方合并时作为共同祖先
+    if (!query.exec("CREATE TABLE IF NOT EXISTS post_sync_base ("
+                    "post_id INTEGER PRIMARY KEY, "
+                    "remote_modified TEXT, "
+                    "data BLOB NOT NULL, "
+                    "FOREIGN KEY (post_id) REFERENCES posts (id) ON DELETE CASCADE)")) {
+        qCWarning(lcDatabase) << "创建post_sync_base表失败: " << query.lastError().text();
         return false;
     }
     
@@ -119,145 +387,376 @@ bool DatabaseManager::createTables()
                     "PRIMARY KEY (post_id, tag_id), "
                     "FOREIGN KEY (post_id) REFERENCES posts (id) ON DELETE CASCADE, "
                     "FOREIGN KEY (tag_id) REFERENCES tags (id) ON DELETE CASCADE)")) {
-        qDebug() << "创建post_tags表失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "创建post_tags表失败: " << query.lastError().text();
         return false;
     }
     
     return true;
 }
 
-bool DatabaseManager::savePost(Post& post)
+bool DatabaseManager::migrate()
 {
     QSqlQuery query;
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qCWarning(lcDatabase) << "读取数据库版本失败: " << query.lastError().text();
+        return false;
+    }
+    int version = query.value(0).toInt();
+    query.finish();
+    
+    if (version >= SchemaVersion) {
+        return true;
+    }
     
-    qDebug() << "保存文章到数据库: ID=" << post.id() << "远程ID=" << post.remoteId() << "标题=" << post.title() << "状态=" << post.status();
+    qCDebug(lcDatabase) << "升级数据库: 版本" << version << "->" << SchemaVersion;
+    TraceSpan span("db.migrate");
     
-    // 首先检查文章是否已存在（通过本地ID匹配）
+    // 每一步在自己的事务中执行，并在同一个事务中更新user_version：中途失败或退出时，
+    // 已完成的步骤不会重做，未完成的步骤整体回滚，下次启动从这一步重新开始
+    auto finishStep = [this, &query](int stepVersion) {
+        if (!query.exec(QString("PRAGMA user_version = %1").arg(stepVersion))) {
+            qCWarning(lcDatabase) << "更新数据库版本失败: " << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+        if (!m_db.commit()) {
+            qCWarning(lcDatabase) << "提交数据库升级失败: " << m_db.lastError().text();
+            return false;
+        }
+        return true;
+    };
+    
+    // 0 -> 1：把已有的长正文转换为压缩BLOB
+    // 与当前的压缩设置无关：版本号只升级一次，关闭压缩时跳过的话这些正文以后再也不会被转换
+    int converted = 0;
+    if (version < 1) {
+        QList<int> ids;
+        QSqlQuery select;
+        select.setForwardOnly(true);
+        if (!select.exec(QString("SELECT id FROM posts WHERE typeof(content) = 'text' AND length(content) >= %1")
+                             .arg(PostColumns::ContentCodec::MinCompressedLength))) {
+            qCWarning(lcDatabase) << "查找待压缩的正文失败: " << select.lastError().text();
+            return false;
+        }
+        while (select.next()) {
+            ids.append(select.value(0).toInt());
+        }
+        select.finish();
+        
+        m_db.transaction();
+        QSqlQuery read;
+        read.prepare("SELECT content FROM posts WHERE id = :id");
+        QSqlQuery write;
+        write.prepare("UPDATE posts SET content = :content WHERE id = :id");
+        for (int id : ids) {
+            read.bindValue(":id", id);
+            if (!read.exec() || !read.next()) {
+                continue;
+            }
+            QVariant content = PostColumns::ContentCodec::encode(read.value(0).toString(), true);
+            read.finish();
+            
+            write.bindValue(":content", content);
+            write.bindValue(":id", id);
+            if (!write.exec()) {
+                qCWarning(lcDatabase) << "压缩正文失败: " << write.lastError().text();
+                m_db.rollback();
+                return false;
+            }
+            ++converted;
+        }
+        if (!finishStep(1)) {
+            return false;
+        }
+    }
+    
+    // 1 -> 2：行和分类/标签的摘要，已有的行为NULL，下次保存时写入
+    if (version < 2) {
+        m_db.transaction();
+        if (!query.exec("ALTER TABLE posts ADD COLUMN content_hash INTEGER")
+            || !query.exec("ALTER TABLE posts ADD COLUMN terms_hash INTEGER")) {
+            qCWarning(lcDatabase) << "添加摘要列失败: " << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+        if (!finishStep(2)) {
+            return false;
+        }
+    }
+    
+    // 2 -> 3：服务器上的修改时间，已有的行为NULL，对比远程文章列表时视为有更新
+    if (version < 3) {
+        m_db.transaction();
+        if (!query.exec("ALTER TABLE posts ADD COLUMN remote_modified TEXT")) {
+            qCWarning(lcDatabase) << "添加remote_modified列失败: " << query.lastError().text();
+            m_db.rollback();
+            return false;
+        }
+        if (!finishStep(3)) {
+            return false;
+        }
+    }
+    
+    // 压缩后释放的页只有VACUUM之后才会从文件中去掉
+    if (converted > 0 && !query.exec("VACUUM")) {
+        qCWarning(lcDatabase) << "VACUUM失败: " << query.lastError().text();
+    }
+    
+    span.addRows(converted);
+    qCDebug(lcDatabase) << "数据库升级完成，压缩了" << converted << "篇文章的正文";
+    return true;
+}
+
+void DatabaseManager::loadTermTables()
+{
+    TermTable::categories().clear();
+    for (const Category& category : getAllCategories()) {
+        TermTable::categories().insert(category.id(), category.name());
+    }
+    
+    TermTable::tags().clear();
+    for (const Tag& tag : getAllTags()) {
+        TermTable::tags().insert(tag.id(), tag.name());
+    }
+    
+    qCDebug(lcDatabase) << "加载了" << TermTable::categories().size() << "个分类和"
+                        << TermTable::tags().size() << "个标签";
+}
+
+bool DatabaseManager::savePost(Post& post, SaveOutcome* outcome)
+{
+    TraceSpan span("db.savePost");
+    span.addRows(1);
+    QSqlQuery query;
+    
+    qCDebug(lcDatabase) << "保存文章到数据库: ID=" << post.id() << "远程ID=" << post.remoteId() << "标题=" << post.title() << "状态=" << post.status();
+    
+    // 从远程获取的文章没有本地ID，按远程ID匹配已有记录，重复同步时更新而不是插入重复行
+    if (post.id() <= 0 && post.hasRemoteId()) {
+        int existingId = findPostIdByRemoteId(post.remoteId());
+        if (existingId > 0) {
+            post.setId(existingId);
+        }
+    }
+    
+    // 没有加载正文的文章（来自文章列表）更新时保留数据库中的正文
+    Post::Fields fields = Post::AllFields;
+    bool update = false;
+    QVariant storedRowHash;
+    QVariant storedTermsHash;
+    
+    // 首先检查文章是否已存在（通过本地ID匹配），同时取出上次保存时的摘要
     if (post.id() > 0) {
         QSqlQuery checkQuery;
-        checkQuery.prepare("SELECT id FROM posts WHERE id = :id");
+        checkQuery.prepare("SELECT content_hash, terms_hash FROM posts WHERE id = :id");
         checkQuery.bindValue(":id", post.id());
         
         if (checkQuery.exec() && checkQuery.next()) {
             // 文章已存在，执行更新
-            qDebug() << "更新已存在的文章: ID=" << post.id() << "远程ID=" << post.remoteId();
-            
-            query.prepare("UPDATE posts SET title = :title, content = :content, excerpt = :excerpt, "
-                         "publish_date = :publish_date, author = :author, status = :status, "
-                         "featured_image_url = :featured_image_url, remote_id = :remote_id WHERE id = :id");
-            query.bindValue(":id", post.id());
-            query.bindValue(":remote_id", post.remoteId());
+            qCDebug(lcDatabase) << "更新已存在的文章: ID=" << post.id() << "远程ID=" << post.remoteId();
+            update = true;
+            storedRowHash = checkQuery.value(0);
+            storedTermsHash = checkQuery.value(1);
         } else {
             // 文章不存在，执行插入
-            qDebug() << "插入新文章: ID=" << post.id() << "远程ID=" << post.remoteId();
-            
-            query.prepare("INSERT INTO posts (title, content, excerpt, publish_date, author, status, featured_image_url, remote_id) "
-                          "VALUES (:title, :content, :excerpt, :publish_date, :author, :status, :featured_image_url, :remote_id)");
-            query.bindValue(":remote_id", post.remoteId());
+            qCDebug(lcDatabase) << "插入新文章: ID=" << post.id() << "远程ID=" << post.remoteId();
         }
     } else {
         // 本地创建的新文章
-        qDebug() << "插入本地创建的新文章，远程ID=" << post.remoteId();
-        
-        query.prepare("INSERT INTO posts (title, content, excerpt, publish_date, author, status, featured_image_url, remote_id) "
-                      "VALUES (:title, :content, :excerpt, :publish_date, :author, :status, :featured_image_url, :remote_id)");
-        query.bindValue(":remote_id", post.remoteId());
+        qCDebug(lcDatabase) << "插入本地创建的新文章，远程ID=" << post.remoteId();
     }
     
-    query.bindValue(":title", post.title());
-    query.bindValue(":content", post.content());
-    query.bindValue(":excerpt", post.excerpt());
-    query.bindValue(":publish_date", post.publishDate());
-    query.bindValue(":author", post.author());
-    query.bindValue(":status", post.status());
-    query.bindValue(":featured_image_url", post.featuredImageUrl());
+    // 临时ID先换成正式ID，摘要按正式ID计算
+    if (!resolvePostTerms(m_db, post)) {
+        return false;
+    }
+    
+    // 与上次保存时的摘要相同的部分不再写入（重复同步时大多数文章都没有变化）
+    QVariant contentHash = rowHash(post);
+    qint64 termsHash = qint64(PostSchema::hashTerms(post));
+    bool rowChanged = !update || contentHash.isNull() || storedRowHash.isNull()
+        || storedRowHash.toLongLong() != contentHash.toLongLong();
+    bool termsChanged = !update || storedTermsHash.isNull() || storedTermsHash.toLongLong() != termsHash;
+    
+    if (!rowChanged && !termsChanged) {
+        qCDebug(lcDatabase) << "文章没有变化，跳过保存: ID=" << post.id();
+        if (outcome) {
+            *outcome = Unchanged;
+        }
+        return true;
+    }
+    
+    if (!rowChanged) {
+        query.prepare("UPDATE posts SET terms_hash = ? WHERE id = ?");
+        query.bindValue(0, termsHash);
+        query.bindValue(1, post.id());
+    } else {
+        if (update) {
+            fields.setFlag(Post::ContentField, post.isContentLoaded());
+            query.prepare("UPDATE posts SET " + PostColumns::assignments(PostSchema::Columns(), fields)
+                          + ", content_hash = ?, terms_hash = ? WHERE id = ?");
+        } else {
+            query.prepare(insertPostSql());
+        }
+        
+        int position = PostColumns::bind(PostSchema::Columns(), query, post, fields, m_compressContent);
+        query.bindValue(position++, contentHash);
+        query.bindValue(position++, termsHash);
+        if (update) {
+            query.bindValue(position, post.id());
+        }
+    }
     
     if (!query.exec()) {
-        qDebug() << "保存文章失败: " << query.lastError().text() << "SQL=" << query.lastQuery();
+        qCWarning(lcDatabase) << "保存文章失败: " << query.lastError().text() << "SQL=" << query.lastQuery();
         return false;
     }
     
     // 如果是新插入的本地文章（没有ID），获取自动生成的ID
     if (post.id() == -1) {
         post.setId(query.lastInsertId().toInt());
-        qDebug() << "为新文章分配ID: " << post.id();
+        qCDebug(lcDatabase) << "为新文章分配ID: " << post.id();
     }
     
-    // 处理分类关联
-    if (!post.categories().isEmpty()) {
-        // 先删除旧的分类关联
-        QSqlQuery deleteCategories;
-        deleteCategories.prepare("DELETE FROM post_categories WHERE post_id = :post_id");
-        deleteCategories.bindValue(":post_id", post.id());
-        if (!deleteCategories.exec()) {
-            qDebug() << "删除文章分类关联失败: " << deleteCategories.lastError().text();
-        }
-        
-        qDebug() << "开始处理文章分类关联，文章ID=" << post.id() << "，分类数量=" << post.categories().size();
-        
-        // 添加新的分类关联
-        for (const QString& categoryName : post.categories()) {
-            qDebug() << "正在处理分类: " << categoryName;
-            
-            // 先查找分类是否已存在
-            QSqlQuery findCategory;
-            findCategory.prepare("SELECT id FROM categories WHERE name = :name");
-            findCategory.bindValue(":name", categoryName);
-            
-            if (findCategory.exec() && findCategory.next()) {
-                // 分类已存在，直接使用ID
-                int categoryId = findCategory.value(0).toInt();
-                qDebug() << "找到已存在的分类: ID=" << categoryId << "名称=" << categoryName;
-                addCategoryToPost(post.id(), categoryId);
-            } else {
-                // 分类不存在，创建新分类
-                Category category(-1, categoryName);
-                if (saveCategory(category)) {
-                    qDebug() << "创建新分类: ID=" << category.id() << "名称=" << category.name();
-                    addCategoryToPost(post.id(), category.id());
-                }
-            }
-        }
+    // 处理分类和标签关联
+    if (termsChanged && !savePostTerms(m_db, post)) {
+        return false;
+    }
+    
+    if (outcome) {
+        *outcome = update ? Updated : Inserted;
+    }
+    qCDebug(lcDatabase) << "文章保存成功: ID=" << post.id() << "标题=" << post.title();
+    return true;
+}
+
+bool DatabaseManager::resolvePostTerms(QSqlDatabase& db, Post& post)
+{
+    // 按名称添加的新分类/标签先写入数据库，文章中的临时ID换成正式ID
+    TermIds categoryIds = post.categoryIds();
+    if (!resolveTermIds(db, "categories", TermTable::categories(), categoryIds)) {
+        return false;
+    }
+    if (categoryIds != post.categoryIds()) {
+        post.setCategoryIds(std::move(categoryIds));
+    }
+    
+    TermIds tagIds = post.tagIds();
+    if (!resolveTermIds(db, "tags", TermTable::tags(), tagIds)) {
+        return false;
+    }
+    if (tagIds != post.tagIds()) {
+        post.setTagIds(std::move(tagIds));
+    }
+    return true;
+}
+
+bool DatabaseManager::savePostTerms(QSqlDatabase& db, Post& post)
+{
+    if (!resolvePostTerms(db, post)) {
+        return false;
+    }
+    
+    // 关联行整体重写：先删除旧的，再逐个插入（同一条预编译语句重复执行）
+    QSqlQuery deleteCategories(db);
+    deleteCategories.prepare("DELETE FROM post_categories WHERE post_id = :post_id");
+    deleteCategories.bindValue(":post_id", post.id());
+    if (!deleteCategories.exec()) {
+        qCWarning(lcDatabase) << "删除文章分类关联失败: " << deleteCategories.lastError().text();
+        return false;
     }
     
-    // 处理标签关联
-    if (!post.tags().isEmpty()) {
-        // 先删除旧的标签关联
-        QSqlQuery deleteTags;
-        deleteTags.prepare("DELETE FROM post_tags WHERE post_id = :post_id");
-        deleteTags.bindValue(":post_id", post.id());
-        if (!deleteTags.exec()) {
-            qDebug() << "删除文章标签关联失败: " << deleteTags.lastError().text();
+    QSqlQuery insertCategory(db);
+    insertCategory.prepare("INSERT OR IGNORE INTO post_categories (post_id, category_id) VALUES (:post_id, :category_id)");
+    for (int categoryId : post.categoryIds()) {
+        insertCategory.bindValue(":post_id", post.id());
+        insertCategory.bindValue(":category_id", categoryId);
+        if (!insertCategory.exec()) {
+            qCWarning(lcDatabase) << "添加文章分类失败: " << insertCategory.lastError().text();
+            return false;
         }
-        
-        qDebug() << "开始处理文章标签关联，文章ID=" << post.id() << "，标签数量=" << post.tags().size();
-        
-        // 添加新的标签关联
-        for (const QString& tagName : post.tags()) {
-            qDebug() << "正在处理标签: " << tagName;
-            
-            // 先查找标签是否已存在
-            QSqlQuery findTag;
-            findTag.prepare("SELECT id FROM tags WHERE name = :name");
-            findTag.bindValue(":name", tagName);
-            
-            if (findTag.exec() && findTag.next()) {
-                // 标签已存在，直接使用ID
-                int tagId = findTag.value(0).toInt();
-                qDebug() << "找到已存在的标签: ID=" << tagId << "名称=" << tagName;
-                addTagToPost(post.id(), tagId);
-            } else {
-                // 标签不存在，创建新标签
-                Tag tag(-1, tagName);
-                if (saveTag(tag)) {
-                    qDebug() << "创建新标签: ID=" << tag.id() << "名称=" << tag.name();
-                    addTagToPost(post.id(), tag.id());
-                }
-            }
+    }
+    
+    QSqlQuery deleteTags(db);
+    deleteTags.prepare("DELETE FROM post_tags WHERE post_id = :post_id");
+    deleteTags.bindValue(":post_id", post.id());
+    if (!deleteTags.exec()) {
+        qCWarning(lcDatabase) << "删除文章标签关联失败: " << deleteTags.lastError().text();
+        return false;
+    }
+    
+    QSqlQuery insertTag(db);
+    insertTag.prepare("INSERT OR IGNORE INTO post_tags (post_id, tag_id) VALUES (:post_id, :tag_id)");
+    for (int tagId : post.tagIds()) {
+        insertTag.bindValue(":post_id", post.id());
+        insertTag.bindValue(":tag_id", tagId);
+        if (!insertTag.exec()) {
+            qCWarning(lcDatabase) << "添加文章标签失败: " << insertTag.lastError().text();
+            return false;
         }
     }
     
-    qDebug() << "文章保存成功: ID=" << post.id() << "标题=" << post.title();
+    qCDebug(lcDatabase) << "文章分类/标签关联已更新: ID=" << post.id()
+                        << "分类数量=" << post.categoryIds().size() << "标签数量=" << post.tagIds().size();
+    return true;
+}
+
+bool DatabaseManager::savePostFields(QSqlDatabase db, Post& post, Post::Fields fields, bool compressContent)
+{
+    TraceSpan span("db.savePostFields");
+    if (post.id() <= 0) {
+        qCWarning(lcDatabase) << "只能更新已保存的文章";
+        return false;
+    }
+    
+    // 各字段对应的列，未修改的列不出现在UPDATE语句中
+    if (!post.isContentLoaded()) {
+        fields.setFlag(Post::ContentField, false);
+    }
+    
+    db.transaction();
+    
+    if ((fields & Post::TermsField) && !resolvePostTerms(db, post)) {
+        db.rollback();
+        return false;
+    }
+    
+    // 摘要随修改的字段一起更新，之后的savePost()才能正确判断是否有变化
+    QString assignments = PostColumns::assignments(PostSchema::EditableColumns(), fields);
+    if (!assignments.isEmpty()) {
+        assignments += ", ";
+    }
+    assignments += "content_hash = ?";
+    if (fields & Post::TermsField) {
+        assignments += ", terms_hash = ?";
+    }
+    
+    QSqlQuery query(db);
+    query.prepare("UPDATE posts SET " + assignments + " WHERE id = ?");
+    int position = PostColumns::bind(PostSchema::EditableColumns(), query, post, fields, compressContent);
+    query.bindValue(position++, rowHash(post));
+    if (fields & Post::TermsField) {
+        query.bindValue(position++, qint64(PostSchema::hashTerms(post)));
+    }
+    query.bindValue(position, post.id());
+    if (fields & Post::ContentField) {
+        span.addBytes(post.content().size());
+    }
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "更新文章字段失败: " << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    
+    if ((fields & Post::TermsField) && !savePostTerms(db, post)) {
+        db.rollback();
+        return false;
+    }
+    
+    db.commit();
+    span.addRows(1);
+    qCDebug(lcDatabase) << "更新文章字段: ID=" << post.id() << "字段=" << int(fields);
     return true;
 }
 
@@ -268,120 +767,206 @@ bool DatabaseManager::deletePost(int postId)
     query.bindValue(":id", postId);
     
     if (!query.exec()) {
-        qDebug() << "删除文章失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "删除文章失败: " << query.lastError().text();
         return false;
     }
     
+    // SQLite默认不启用外键约束，修订历史需要单独删除
+    query.prepare("DELETE FROM post_revisions WHERE post_id = :id");
+    query.bindValue(":id", postId);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "删除文章修订失败: " << query.lastError().text();
+    }
+    m_lastRevisions.remove(postId);
+    
+    query.prepare("DELETE FROM post_sync_hashes WHERE post_id = :id");
+    query.bindValue(":id", postId);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "删除文章同步状态失败: " << query.lastError().text();
+    }
+    
+    query.prepare("DELETE FROM post_sync_base WHERE post_id = :id");
+    query.bindValue(":id", postId);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "删除文章同步基线失败: " << query.lastError().text();
+    }
+    
     return true;
 }
 
 QList<Post> DatabaseManager::getAllPosts(bool publishedOnly)
 {
+    TraceSpan span("db.getAllPosts");
     QList<Post> posts;
     QSqlQuery query;
     
-    QString queryStr = "SELECT id, title, content, excerpt, publish_date, author, status, featured_image_url FROM posts";
+    // 列表不需要正文，不读取content列（正文在打开文章时由getPostById加载）
+    QString queryStr = QString("SELECT id, %1 FROM posts")
+        .arg(QLatin1String(PostColumns::Sql<PostSchema::SummaryColumns>::names.data()));
     if (publishedOnly) {
         queryStr += " WHERE status = 1"; // 只获取已发布的帖子 (Post::Published = 1)
     }
     queryStr += " ORDER BY publish_date DESC";
     
-    qDebug() << "执行查询获取文章: " << queryStr;
+    qCDebug(lcDatabase) << "执行查询获取文章: " << queryStr;
     
     if (!query.exec(queryStr)) {
-        qDebug() << "获取文章失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "获取文章失败: " << query.lastError().text();
         return posts;
     }
     
+    // 一次性读出全部关联行，避免每篇文章各查询两次
+    QHash<int, TermIds> categoryLinks = loadTermLinks("SELECT post_id, category_id FROM post_categories");
+    QHash<int, TermIds> tagLinks = loadTermLinks("SELECT post_id, tag_id FROM post_tags");
+    
     int count = 0;
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString title = query.value(1).toString();
-        QString content = query.value(2).toString();
-        QString excerpt = query.value(3).toString();
-        QDateTime publishDate = query.value(4).toDateTime();
-        QString author = query.value(5).toString();
-        Post::Status status = static_cast<Post::Status>(query.value(6).toInt());
-        QString featuredImageUrl = query.value(7).toString();
-        
-        qDebug() << "加载文章: ID=" << id << "标题=" << title << "状态=" << status;
-        
-        Post post(id, title, content, excerpt, publishDate, author, status);
-        post.setFeaturedImageUrl(featuredImageUrl);
+        Post post;
+        post.setId(id);
+        PostColumns::read(PostSchema::SummaryColumns(), query, post, 1);
+        post.setContentLoaded(false);
         
-        // 获取帖子的分类
-        QList<Category> categories = getCategoriesForPost(id);
-        QStringList categoryNames;
-        for (const auto& category : categories) {
-            categoryNames << category.name();
-        }
-        post.setCategories(categoryNames);
+        qCDebug(lcDatabase) << "加载文章: ID=" << id << "标题=" << post.title() << "状态=" << post.status();
         
-        // 获取帖子的标签
-        QList<Tag> tags = getTagsForPost(id);
-        QStringList tagNames;
-        for (const auto& tag : tags) {
-            tagNames << tag.name();
-        }
-        post.setTags(tagNames);
+        // 帖子的分类和标签（关联行已按ID排序）
+        post.setCategoryIds(categoryLinks.take(id));
+        post.setTagIds(tagLinks.take(id));
         
-        posts.append(post);
+        posts.append(std::move(post));
         count++;
     }
     
-    qDebug() << "从数据库加载了 " << count << " 篇文章" << (publishedOnly ? " (仅已发布)" : " (全部)");
+    qCDebug(lcDatabase) << "从数据库加载了 " << count << " 篇文章" << (publishedOnly ? " (仅已发布)" : " (全部)");
+    span.addRows(count);
     
     return posts;
 }
 
 Post DatabaseManager::getPostById(int postId)
 {
+    TraceSpan span("db.getPostById");
+    span.addRows(1);
     QSqlQuery query;
-    query.prepare("SELECT id, title, content, excerpt, publish_date, author, status, featured_image_url, remote_id FROM posts WHERE id = :id");
-    query.bindValue(":id", postId);
+    query.prepare(QString("SELECT id, %1 FROM posts WHERE id = ?")
+                      .arg(QLatin1String(PostColumns::Sql<PostSchema::Columns>::names.data())));
+    query.bindValue(0, postId);
     
-    qDebug() << "获取文章详情: 本地ID=" << postId;
+    qCDebug(lcDatabase) << "获取文章详情: 本地ID=" << postId;
     
     if (!query.exec() || !query.next()) {
-        qDebug() << "根据ID获取文章失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "根据ID获取文章失败: " << query.lastError().text();
         return Post();
     }
     
     int id = query.value(0).toInt();
-    QString title = query.value(1).toString();
-    QString content = query.value(2).toString();
-    QString excerpt = query.value(3).toString();
-    QDateTime publishDate = query.value(4).toDateTime();
-    QString author = query.value(5).toString();
-    Post::Status status = static_cast<Post::Status>(query.value(6).toInt());
-    QString featuredImageUrl = query.value(7).toString();
-    int remoteId = query.value(8).toInt();
-    
-    qDebug() << "找到文章: 本地ID=" << id << "远程ID=" << remoteId << "标题=" << title << "状态=" << status;
+    Post post;
+    post.setId(id);
+    PostColumns::read(PostSchema::Columns(), query, post, 1);
     
-    Post post(id, title, content, excerpt, publishDate, author, status);
-    post.setFeaturedImageUrl(featuredImageUrl);
-    post.setRemoteId(remoteId);
+    qCDebug(lcDatabase) << "找到文章: 本地ID=" << id << "远程ID=" << post.remoteId() << "标题=" << post.title() << "状态=" << post.status();
     
     // 获取帖子的分类
-    QList<Category> categories = getCategoriesForPost(id);
-    for (const auto& category : categories) {
-        post.addCategory(category.name());
+    QSqlQuery linkQuery;
+    linkQuery.prepare("SELECT category_id FROM post_categories WHERE post_id = :post_id ORDER BY category_id");
+    linkQuery.bindValue(":post_id", id);
+    if (linkQuery.exec()) {
+        TermIds categoryIds;
+        while (linkQuery.next()) {
+            categoryIds.append(linkQuery.value(0).toInt());
+        }
+        post.setCategoryIds(std::move(categoryIds));
     }
-    qDebug() << "加载了文章分类: " << post.categories().join(", ");
+    qCDebug(lcDatabase) << "加载了文章分类: " << post.categories().join(", ");
     
     // 获取帖子的标签
-    QList<Tag> tags = getTagsForPost(id);
-    for (const auto& tag : tags) {
-        post.addTag(tag.name());
+    linkQuery.prepare("SELECT tag_id FROM post_tags WHERE post_id = :post_id ORDER BY tag_id");
+    linkQuery.bindValue(":post_id", id);
+    if (linkQuery.exec()) {
+        TermIds tagIds;
+        while (linkQuery.next()) {
+            tagIds.append(linkQuery.value(0).toInt());
+        }
+        post.setTagIds(std::move(tagIds));
     }
-    qDebug() << "加载了文章标签: " << post.tags().join(", ");
+    qCDebug(lcDatabase) << "加载了文章标签: " << post.tags().join(", ");
     
     return post;
 }
 
+bool DatabaseManager::loadPostContent(Post& post)
+{
+    if (post.isContentLoaded()) {
+        return true;
+    }
+    
+    TraceSpan span("db.loadPostContent");
+    QSqlQuery query;
+    query.prepare("SELECT content FROM posts WHERE id = :id");
+    query.bindValue(":id", post.id());
+    
+    if (!query.exec() || !query.next()) {
+        qCWarning(lcDatabase) << "加载文章正文失败: ID=" << post.id() << query.lastError().text();
+        return false;
+    }
+    
+    post.setContent(PostColumns::ContentCodec::decode(query.value(0)));
+    span.addBytes(post.content().size());
+    return true;
+}
+
+int DatabaseManager::findPostIdByRemoteId(int remoteId)
+{
+    QSqlQuery query;
+    query.prepare("SELECT id FROM posts WHERE remote_id = :remote_id");
+    query.bindValue(":remote_id", remoteId);
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "按远程ID查找文章失败: " << query.lastError().text();
+        return -1;
+    }
+    
+    return query.next() ? query.value(0).toInt() : -1;
+}
+
+QList<PostIndex::Stamp> DatabaseManager::getPostStamps()
+{
+    TraceSpan span("db.getPostStamps");
+    QList<PostIndex::Stamp> stamps;
+    
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    if (!query.exec("SELECT id, remote_id, remote_modified FROM posts WHERE remote_id > 0 ORDER BY remote_id")) {
+        qCWarning(lcDatabase) << "获取文章修改时间失败: " << query.lastError().text();
+        return stamps;
+    }
+    
+    while (query.next()) {
+        PostIndex::Stamp stamp;
+        stamp.localId = query.value(0).toInt();
+        stamp.remoteId = query.value(1).toInt();
+        stamp.modified = query.value(2).toString();
+        stamps.append(stamp);
+    }
+    
+    span.addRows(stamps.size());
+    return stamps;
+}
+
+int DatabaseManager::postCount(bool publishedOnly)
+{
+    QSqlQuery query;
+    if (!query.exec(publishedOnly ? "SELECT COUNT(*) FROM posts WHERE status = 1" : "SELECT COUNT(*) FROM posts")) {
+        qCWarning(lcDatabase) << "统计文章数量失败: " << query.lastError().text();
+        return 0;
+    }
+    
+    return query.next() ? query.value(0).toInt() : 0;
+}
+
 bool DatabaseManager::saveCategory(Category& category)
 {
+    TraceSpan span("db.saveCategory");
     QSqlQuery query;
     
     // 先检查是否已存在同名分类
@@ -394,7 +979,8 @@ bool DatabaseManager::saveCategory(Category& category)
             // 已存在同名分类，使用现有ID
             int existingId = checkQuery.value(0).toInt();
             category.setId(existingId);
-            qDebug() << "使用已存在的分类: ID=" << existingId << "名称=" << category.name();
+            qCDebug(lcDatabase) << "使用已存在的分类: ID=" << existingId << "名称=" << category.name();
+            TermTable::categories().insert(existingId, category.name());
             return true;
         }
     }
@@ -411,16 +997,28 @@ bool DatabaseManager::saveCategory(Category& category)
     query.bindValue(":name", category.name());
     
     if (!query.exec()) {
-        qDebug() << "保存分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "保存分类失败: " << query.lastError().text();
         return false;
     }
     
+    // 从WordPress获取的分类带有远程ID，本地还没有时按这个ID插入
+    if (category.id() != -1 && query.numRowsAffected() == 0) {
+        query.prepare("INSERT INTO categories (id, name) VALUES (:id, :name)");
+        query.bindValue(":id", category.id());
+        query.bindValue(":name", category.name());
+        if (!query.exec()) {
+            qCWarning(lcDatabase) << "插入分类失败: " << query.lastError().text();
+            return false;
+        }
+    }
+    
     // 如果是插入新分类，获取自动生成的ID
     if (category.id() == -1) {
         category.setId(query.lastInsertId().toInt());
-        qDebug() << "创建新分类: ID=" << category.id() << "名称=" << category.name();
+        qCDebug(lcDatabase) << "创建新分类: ID=" << category.id() << "名称=" << category.name();
     }
     
+    TermTable::categories().insert(category.id(), category.name());
     return true;
 }
 
@@ -431,10 +1029,11 @@ bool DatabaseManager::deleteCategory(int categoryId)
     query.bindValue(":id", categoryId);
     
     if (!query.exec()) {
-        qDebug() << "删除分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "删除分类失败: " << query.lastError().text();
         return false;
     }
     
+    TermTable::categories().remove(categoryId);
     return true;
 }
 
@@ -444,13 +1043,13 @@ QList<Category> DatabaseManager::getAllCategories()
     QSqlQuery query;
     
     if (!query.exec("SELECT id, name FROM categories ORDER BY name")) {
-        qDebug() << "获取分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "获取分类失败: " << query.lastError().text();
         return categories;
     }
     
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
+        QString name = StringPool::instance().intern(query.value(1).toString());
         
         categories.append(Category(id, name));
     }
@@ -461,6 +1060,7 @@ QList<Category> DatabaseManager::getAllCategories()
 QList<Category> DatabaseManager::getCategoriesForPost(int postId)
 {
     QList<Category> categories;
+    TraceSpan span("db.getCategoriesForPost");
     QSqlQuery query;
     
     query.prepare("SELECT c.id, c.name FROM categories c "
@@ -469,13 +1069,13 @@ QList<Category> DatabaseManager::getCategoriesForPost(int postId)
     query.bindValue(":post_id", postId);
     
     if (!query.exec()) {
-        qDebug() << "获取文章分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "获取文章分类失败: " << query.lastError().text();
         return categories;
     }
     
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
+        QString name = StringPool::instance().intern(query.value(1).toString());
         
         categories.append(Category(id, name));
     }
@@ -485,6 +1085,7 @@ QList<Category> DatabaseManager::getCategoriesForPost(int postId)
 
 bool DatabaseManager::saveTag(Tag& tag)
 {
+    TraceSpan span("db.saveTag");
     QSqlQuery query;
     
     // 先检查是否已存在同名标签
@@ -497,7 +1098,8 @@ bool DatabaseManager::saveTag(Tag& tag)
             // 已存在同名标签，使用现有ID
             int existingId = checkQuery.value(0).toInt();
             tag.setId(existingId);
-            qDebug() << "使用已存在的标签: ID=" << existingId << "名称=" << tag.name();
+            qCDebug(lcDatabase) << "使用已存在的标签: ID=" << existingId << "名称=" << tag.name();
+            TermTable::tags().insert(existingId, tag.name());
             return true;
         }
     }
@@ -514,16 +1116,28 @@ bool DatabaseManager::saveTag(Tag& tag)
     query.bindValue(":name", tag.name());
     
     if (!query.exec()) {
-        qDebug() << "保存标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "保存标签失败: " << query.lastError().text();
         return false;
     }
     
+    // 从WordPress获取的标签带有远程ID，本地还没有时按这个ID插入
+    if (tag.id() != -1 && query.numRowsAffected() == 0) {
+        query.prepare("INSERT INTO tags (id, name) VALUES (:id, :name)");
+        query.bindValue(":id", tag.id());
+        query.bindValue(":name", tag.name());
+        if (!query.exec()) {
+            qCWarning(lcDatabase) << "插入标签失败: " << query.lastError().text();
+            return false;
+        }
+    }
+    
     // 如果是插入新标签，获取自动生成的ID
     if (tag.id() == -1) {
         tag.setId(query.lastInsertId().toInt());
-        qDebug() << "创建新标签: ID=" << tag.id() << "名称=" << tag.name();
+        qCDebug(lcDatabase) << "创建新标签: ID=" << tag.id() << "名称=" << tag.name();
     }
     
+    TermTable::tags().insert(tag.id(), tag.name());
     return true;
 }
 
@@ -534,10 +1148,11 @@ bool DatabaseManager::deleteTag(int tagId)
     query.bindValue(":id", tagId);
     
     if (!query.exec()) {
-        qDebug() << "删除标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "删除标签失败: " << query.lastError().text();
         return false;
     }
     
+    TermTable::tags().remove(tagId);
     return true;
 }
 
@@ -547,13 +1162,13 @@ QList<Tag> DatabaseManager::getAllTags()
     QSqlQuery query;
     
     if (!query.exec("SELECT id, name FROM tags ORDER BY name")) {
-        qDebug() << "获取标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "获取标签失败: " << query.lastError().text();
         return tags;
     }
     
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
+        QString name = StringPool::instance().intern(query.value(1).toString());
         
         tags.append(Tag(id, name));
     }
@@ -564,6 +1179,7 @@ QList<Tag> DatabaseManager::getAllTags()
 QList<Tag> DatabaseManager::getTagsForPost(int postId)
 {
     QList<Tag> tags;
+    TraceSpan span("db.getTagsForPost");
     QSqlQuery query;
     
     query.prepare("SELECT t.id, t.name FROM tags t "
@@ -572,13 +1188,13 @@ QList<Tag> DatabaseManager::getTagsForPost(int postId)
     query.bindValue(":post_id", postId);
     
     if (!query.exec()) {
-        qDebug() << "获取文章标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "获取文章标签失败: " << query.lastError().text();
         return tags;
     }
     
     while (query.next()) {
         int id = query.value(0).toInt();
-        QString name = query.value(1).toString();
+        QString name = StringPool::instance().intern(query.value(1).toString());
         
         tags.append(Tag(id, name));
     }
@@ -594,7 +1210,7 @@ bool DatabaseManager::addCategoryToPost(int postId, int categoryId)
     query.bindValue(":category_id", categoryId);
     
     if (!query.exec()) {
-        qDebug() << "添加文章分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "添加文章分类失败: " << query.lastError().text();
         return false;
     }
     
@@ -609,7 +1225,7 @@ bool DatabaseManager::removeCategoryFromPost(int postId, int categoryId)
     query.bindValue(":category_id", categoryId);
     
     if (!query.exec()) {
-        qDebug() << "删除文章分类失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "删除文章分类失败: " << query.lastError().text();
         return false;
     }
     
@@ -624,7 +1240,7 @@ bool DatabaseManager::addTagToPost(int postId, int tagId)
     query.bindValue(":tag_id", tagId);
     
     if (!query.exec()) {
-        qDebug() << "添加文章标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "添加文章标签失败: " << query.lastError().text();
         return false;
     }
     
@@ -639,9 +1255,298 @@ bool DatabaseManager::removeTagFromPost(int postId, int tagId)
     query.bindValue(":tag_id", tagId);
     
     if (!query.exec()) {
-        qDebug() << "删除文章标签失败: " << query.lastError().text();
+        qCWarning(lcDatabase) << "删除文章标签失败: " << query.lastError().text();
         return false;
     }
     
     return true;
-} 
\ No newline at end of file
+} 
+
+bool DatabaseManager::saveRevision(const Post& post)
+{
+    if (post.id() <= 0 || !post.isContentLoaded()) {
+        return false;
+    }
+    
+    TraceSpan span("db.saveRevision");
+    QByteArray data = serializeRevision(post);
+    
+    // 上一修订：优先使用内存中的副本，否则从数据库还原
+    int lastRevision = 0;
+    QByteArray lastData;
+    if (const QPair<int, QByteArray>* cached = m_lastRevisions.object(post.id())) {
+        lastRevision = cached->first;
+        lastData = cached->second;
+    } else {
+        QSqlQuery query;
+        query.prepare("SELECT MAX(revision) FROM post_revisions WHERE post_id = :post_id");
+        query.bindValue(":post_id", post.id());
+        if (query.exec() && query.next()) {
+            lastRevision = query.value(0).toInt();
+        }
+        if (lastRevision > 0 && !loadRevisionData(post.id(), lastRevision, &lastData)) {
+            // 历史已经损坏时从新的快照开始，不影响之后的修订
+            lastData.clear();
+        }
+    }
+    
+    if (lastRevision > 0 && data == lastData) {
+        return true;
+    }
+    
+    int revision = lastRevision + 1;
+    QByteArray snapshot = qCompress(data);
+    QByteArray stored = snapshot;
+    bool isSnapshot = true;
+    
+    // 不是快照位置时保存差异；差异比压缩快照还大时（几乎整篇重写）直接保存快照
+    if (lastRevision > 0 && !lastData.isEmpty() && (revision - 1) % RevisionSnapshotInterval != 0) {
+        QByteArray delta = BinaryDelta::encode(lastData, data);
+        if (delta.size() < snapshot.size()) {
+            stored = delta;
+            isSnapshot = false;
+        }
+    }
+    
+    QSqlQuery query;
+    query.prepare("INSERT INTO post_revisions (post_id, revision, created_at, is_snapshot, full_size, data) "
+                  "VALUES (:post_id, :revision, :created_at, :is_snapshot, :full_size, :data)");
+    query.bindValue(":post_id", post.id());
+    query.bindValue(":revision", revision);
+    query.bindValue(":created_at", QDateTime::currentDateTime());
+    query.bindValue(":is_snapshot", isSnapshot ? 1 : 0);
+    query.bindValue(":full_size", data.size());
+    query.bindValue(":data", stored);
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "保存文章修订失败: " << query.lastError().text();
+        return false;
+    }
+    
+    m_lastRevisions.insert(post.id(), new QPair<int, QByteArray>(revision, data), data.size());
+    span.addBytes(stored.size());
+    qCDebug(lcDatabase) << "保存文章修订: ID=" << post.id() << "修订=" << revision
+                        << (isSnapshot ? "快照" : "差异") << stored.size() << "/" << data.size() << "字节";
+    
+    // 旧修订只能从快照处整段删除，写入快照时清理一次即可，不必每次保存都查询（最多多保留一个快照间隔）
+    if (isSnapshot) {
+        pruneRevisions(post.id(), DefaultRevisionLimit);
+    }
+    return true;
+}
+
+QList<DatabaseManager::RevisionInfo> DatabaseManager::getRevisions(int postId)
+{
+    QList<RevisionInfo> revisions;
+    QSqlQuery query;
+    query.prepare("SELECT revision, created_at, is_snapshot, full_size, length(data) FROM post_revisions "
+                  "WHERE post_id = :post_id ORDER BY revision DESC");
+    query.bindValue(":post_id", postId);
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "获取文章修订失败: " << query.lastError().text();
+        return revisions;
+    }
+    
+    while (query.next()) {
+        RevisionInfo info;
+        info.revision = query.value(0).toInt();
+        info.createdAt = query.value(1).toDateTime();
+        info.snapshot = query.value(2).toInt() != 0;
+        info.fullSize = query.value(3).toInt();
+        info.storedSize = query.value(4).toInt();
+        revisions.append(info);
+    }
+    
+    return revisions;
+}
+
+Post DatabaseManager::getRevision(int postId, int revision)
+{
+    QByteArray data;
+    Post post = getPostById(postId);
+    if (post.id() <= 0 || !loadRevisionData(postId, revision, &data) || !deserializeRevision(data, post)) {
+        qCWarning(lcDatabase) << "还原文章修订失败: ID=" << postId << "修订=" << revision;
+        return Post();
+    }
+    return post;
+}
+
+bool DatabaseManager::loadRevisionData(int postId, int revision, QByteArray* data)
+{
+    TraceSpan span("db.loadRevision");
+    
+    // 从不晚于目标修订的最近一个快照开始，依次应用之后的差异
+    QSqlQuery query;
+    query.prepare("SELECT revision, is_snapshot, data FROM post_revisions "
+                  "WHERE post_id = :post_id AND revision <= :revision AND revision >= "
+                  "(SELECT MAX(revision) FROM post_revisions WHERE post_id = :post_id2 AND revision <= :revision2 AND is_snapshot = 1) "
+                  "ORDER BY revision");
+    query.bindValue(":post_id", postId);
+    query.bindValue(":revision", revision);
+    query.bindValue(":post_id2", postId);
+    query.bindValue(":revision2", revision);
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "读取文章修订失败: " << query.lastError().text();
+        return false;
+    }
+    
+    QByteArray current;
+    int lastRevision = 0;
+    int steps = 0;
+    while (query.next()) {
+        int rowRevision = query.value(0).toInt();
+        bool isSnapshot = query.value(1).toInt() != 0;
+        QByteArray stored = query.value(2).toByteArray();
+        
+        if (isSnapshot) {
+            current = qUncompress(stored);
+            if (current.isEmpty()) {
+                qCWarning(lcDatabase) << "文章修订快照无法解压: ID=" << postId << "修订=" << rowRevision;
+                return false;
+            }
+        } else {
+            QByteArray next;
+            if (lastRevision != rowRevision - 1 || !BinaryDelta::apply(current, stored, &next)) {
+                qCWarning(lcDatabase) << "文章修订差异无法应用: ID=" << postId << "修订=" << rowRevision;
+                return false;
+            }
+            current = std::move(next);
+        }
+        lastRevision = rowRevision;
+        ++steps;
+    }
+    
+    if (lastRevision != revision) {
+        return false;
+    }
+    
+    span.addRows(steps);
+    *data = std::move(current);
+    return true;
+}
+
+int DatabaseManager::pruneRevisions(int postId, int keep)
+{
+    QSqlQuery query;
+    query.prepare("SELECT MAX(revision) FROM post_revisions WHERE post_id = :post_id");
+    query.bindValue(":post_id", postId);
+    if (!query.exec() || !query.next()) {
+        return 0;
+    }
+    
+    int cutoff = query.value(0).toInt() - qMax(keep, 1) + 1;
+    if (cutoff <= 1) {
+        return 0;
+    }
+    
+    // 最早保留的修订必须能还原，所以从它之前（含）最近的快照开始保留
+    query.prepare("SELECT MAX(revision) FROM post_revisions WHERE post_id = :post_id AND revision <= :cutoff AND is_snapshot = 1");
+    query.bindValue(":post_id", postId);
+    query.bindValue(":cutoff", cutoff);
+    if (!query.exec() || !query.next() || query.value(0).isNull()) {
+        return 0;
+    }
+    int firstKept = query.value(0).toInt();
+    
+    query.prepare("DELETE FROM post_revisions WHERE post_id = :post_id AND revision < :first_kept");
+    query.bindValue(":post_id", postId);
+    query.bindValue(":first_kept", firstKept);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "清理文章修订失败: " << query.lastError().text();
+        return 0;
+    }
+    
+    int removed = query.numRowsAffected();
+    if (removed > 0) {
+        qCDebug(lcDatabase) << "清理文章修订: ID=" << postId << "删除" << removed << "个";
+    }
+    return removed;
+}
+
+Post::Fields DatabaseManager::unsyncedFields(const Post& post)
+{
+    return PostSchema::changedSince(syncedHashes(post.id()), post);
+}
+
+PostSchema::FieldHashes DatabaseManager::syncedHashes(int postId)
+{
+    PostSchema::FieldHashes hashes;
+    QSqlQuery query;
+    query.prepare("SELECT field, hash FROM post_sync_hashes WHERE post_id = :post_id");
+    query.bindValue(":post_id", postId);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "读取文章同步状态失败: " << query.lastError().text();
+        return hashes;
+    }
+    
+    while (query.next()) {
+        hashes.insert(query.value(0).toInt(), quint64(query.value(1).toLongLong()));
+    }
+    return hashes;
+}
+
+bool DatabaseManager::markSynced(const Post& post)
+{
+    if (post.id() <= 0) {
+        return false;
+    }
+    
+    // 所有字段在一条语句中写入，调用方已经开启事务时也不需要嵌套事务
+    const PostSchema::FieldHashes hashes = PostSchema::hashFields(post);
+    QStringList rows;
+    for (int i = 0; i < hashes.size(); ++i) {
+        rows << "(?, ?, ?)";
+    }
+    
+    QSqlQuery query;
+    query.prepare("INSERT OR REPLACE INTO post_sync_hashes (post_id, field, hash) VALUES " + rows.join(", "));
+    int position = 0;
+    for (auto it = hashes.constBegin(); it != hashes.constEnd(); ++it) {
+        query.bindValue(position++, post.id());
+        query.bindValue(position++, it.key());
+        query.bindValue(position++, qint64(it.value()));
+    }
+    
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "保存文章同步状态失败: " << query.lastError().text();
+        return false;
+    }
+    
+    // 没有加载正文时无法保存完整的基线，保留原来的基线
+    if (!post.isContentLoaded()) {
+        return true;
+    }
+    
+    TraceSpan span("db.saveSyncBase");
+    QByteArray data = serializeSyncBase(post);
+    span.addBytes(data.size());
+    query.prepare("INSERT OR REPLACE INTO post_sync_base (post_id, remote_modified, data) VALUES (?, ?, ?)");
+    query.bindValue(0, post.id());
+    query.bindValue(1, post.remoteModified());
+    query.bindValue(2, data);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "保存文章同步基线失败: " << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+Post DatabaseManager::syncBase(int postId)
+{
+    Post post;
+    QSqlQuery query;
+    query.prepare("SELECT remote_modified, data FROM post_sync_base WHERE post_id = :post_id");
+    query.bindValue(":post_id", postId);
+    if (!query.exec()) {
+        qCWarning(lcDatabase) << "读取文章同步基线失败: " << query.lastError().text();
+        return post;
+    }
+    
+    if (query.next() && deserializeSyncBase(query.value(1).toByteArray(), post)) {
+        post.setId(postId);
+        post.setRemoteModified(query.value(0).toString());
+    }
+    return post;
+}
@@ -1,62 +1,143 @@
-#pragma once
-
-#include <QSqlDatabase>
-#include <QSqlQuery>
-#include <QSqlError>
-#include <QList>
-#include <memory>
-
-#include "models/Post.h"
-#include "models/Category.h"
-#include "models/Tag.h"
-
-class DatabaseManager
-{
-public:
-    static DatabaseManager& instance();
-    ~DatabaseManager();
-    
-    // 初始化和关闭数据库
-    bool initialize();
-    void close();
-    
-    // Post操作
-    bool savePost(Post& post);
-    bool deletePost(int postId);
-    QList<Post> getAllPosts(bool publishedOnly = false);
-    Post getPostById(int postId);
-    
-    // Category操作
-    bool saveCategory(Category& category);
-    bool deleteCategory(int categoryId);
-    QList<Category> getAllCategories();
-    QList<Category> getCategoriesForPost(int postId);
-    
-    // Tag操作
-    bool saveTag(Tag& tag);
-    bool deleteTag(int tagId);
-    QList<Tag> getAllTags();
-    QList<Tag> getTagsForPost(int postId);
-    
-    // 分类与帖子的关联
-    bool addCategoryToPost(int postId, int categoryId);
-    bool removeCategoryFromPost(int postId, int categoryId);
-    
-    // 标签与帖子的关联
-    bool addTagToPost(int postId, int tagId);
-    bool removeTagFromPost(int postId, int tagId);
-
-private:
-    DatabaseManager();
-    
-    // 禁止复制构造和赋值操作
-    DatabaseManager(const DatabaseManager&) = delete;
-    DatabaseManager& operator=(const DatabaseManager&) = delete;
-    
-    // 创建表
-    bool createTables();
-    
-    QSqlDatabase m_db;
-    
-    static std::unique_ptr<DatabaseManager> s_instance;
+#pragma once
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QCache>
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QDateTime>
+#include <memory>
+
+#include "models/Post.h"
+#include "models/Category.h"
+#include "models/Tag.h"
+#include "models/PostSchema.h"
+#include "models/PostIndex.h"
+
+class DatabaseManager
+{
+public:
+    // 一条修订记录的概要
+    struct RevisionInfo
+    {
+        int revision = 0;           // 文章内从1开始递增的修订号
+        QDateTime createdAt;
+        bool snapshot = false;      // 完整快照还是相对上一修订的差异
+        int fullSize = 0;           // 还原后的大小（字节）
+        int storedSize = 0;         // 实际占用的大小（字节）
+    };
+    
+    // 每隔多少个修订保存一次完整快照，还原任意修订最多应用这么多个差异
+    static const int RevisionSnapshotInterval = 20;
+    // 每篇文章默认保留的修订数
+    static const int DefaultRevisionLimit = 200;
+    
+    // savePost()对数据库的实际改动
+    enum SaveOutcome
+    {
+        Inserted,
+        Updated,
+        Unchanged   // 行和分类/标签的摘要与上次保存时相同，没有写入
+    };
+    
+    static DatabaseManager& instance();
+    ~DatabaseManager();
+    
+    // 初始化和关闭数据库
+    // 不带参数时使用应用数据目录下的blogclient.db
+    bool initialize();
+    bool initialize(const QString& databasePath);
+    void close();
+    QString databasePath() const;
+    
+    // Post操作
+    bool savePost(Post& post, SaveOutcome* outcome = nullptr);
+    bool deletePost(int postId);
+    QList<Post> getAllPosts(bool publishedOnly = false);
+    Post getPostById(int postId);
+    // 为列表中加载的文章补上正文（getAllPosts不读取正文）
+    bool loadPostContent(Post& post);
+    // 只更新已有文章中fields列出的列（自动保存使用）
+    // 使用传入的连接，可以在数据库后台线程中用该线程自己的连接调用
+    static bool savePostFields(QSqlDatabase db, Post& post, Post::Fields fields, bool compressContent);
+    // 按WordPress远程ID查找本地文章ID，不存在时返回-1
+    int findPostIdByRemoteId(int remoteId);
+    // 有远程ID的文章的远程ID和上次同步时的修改时间，用于与远程文章列表对比
+    QList<PostIndex::Stamp> getPostStamps();
+    int postCount(bool publishedOnly = false);
+    
+    // 正文压缩：开启时较长的正文以带格式版本号的压缩BLOB保存，默认开启
+    // 只影响之后写入的正文；两种格式都可以读取。首次升级数据库时已有的长正文总是会被压缩
+    void setContentCompression(bool enabled);
+    bool contentCompression() const;
+    
+    // Category操作
+    bool saveCategory(Category& category);
+    bool deleteCategory(int categoryId);
+    QList<Category> getAllCategories();
+    QList<Category> getCategoriesForPost(int postId);
+    
+    // Tag操作
+    bool saveTag(Tag& tag);
+    bool deleteTag(int tagId);
+    QList<Tag> getAllTags();
+    QList<Tag> getTagsForPost(int postId);
+    
+    // 分类与帖子的关联
+    bool addCategoryToPost(int postId, int categoryId);
+    bool removeCategoryFromPost(int postId, int categoryId);
+    
+    // 标签与帖子的关联
+    bool addTagToPost(int postId, int tagId);
+    bool removeTagFromPost(int postId, int tagId);
+    
+    // 修订历史
+    // 与上一修订相同时不保存；保存快照时按DefaultRevisionLimit清理旧修订
+    bool saveRevision(const Post& post);
+    QList<RevisionInfo> getRevisions(int postId);
+    // 还原指定修订：在文章当前数据上替换标题、正文、摘要、状态、特色图片、分类和标签，失败时返回id为-1的文章
+    Post getRevision(int postId, int revision);
+    // 只保留最近keep个修订（为了能还原，可能多保留到最近的一个快照），返回删除的行数
+    int pruneRevisions(int postId, int keep);
+    
+    // 同步状态：上次成功推送到WordPress或从WordPress获取时各字段的摘要
+    // 更新远程文章时只发送摘要不同的字段
+    PostSchema::FieldHashes syncedHashes(int postId);
+    // 与上次同步时相比修改过的字段（传给WordPressAPI::updatePost()）；从未同步过的文章为全部字段
+    Post::Fields unsyncedFields(const Post& post);
+    bool markSynced(const Post& post);
+    // 上次同步时的版本（markSynced()时加载了正文才会保存），用于三方合并；没有时返回的文章ID为-1
+    Post syncBase(int postId);
+
+private:
+    DatabaseManager();
+    
+    // 禁止复制构造和赋值操作
+    DatabaseManager(const DatabaseManager&) = delete;
+    DatabaseManager& operator=(const DatabaseManager&) = delete;
+    
+    // 创建表
+    bool createTables();
+    // 按PRAGMA user_version执行一次性的数据库升级
+    bool migrate();
+    
+    // 把分类和标签读入TermTable
+    void loadTermTables();
+    // 把临时分类/标签ID换成正式ID，并重写文章的关联行
+    static bool savePostTerms(QSqlDatabase& db, Post& post);
+    // 只把临时ID换成正式ID，不写关联行
+    static bool resolvePostTerms(QSqlDatabase& db, Post& post);
+    // 读取并还原修订的内容（序列化后的字节）
+    bool loadRevisionData(int postId, int revision, QByteArray* data);
+    
+    QSqlDatabase m_db;
+    bool m_compressContent;
+    // 最近编辑的文章最近一次修订的修订号和内容，保存下一个修订时不需要再从数据库还原
+    // 按内容字节数计算开销，超过RevisionCacheBytes时淘汰最久没有使用的文章
+    static const int RevisionCacheBytes = 8 * 1024 * 1024;
+    QCache<int, QPair<int, QByteArray>> m_lastRevisions;
+    
+    static std::unique_ptr<DatabaseManager> s_instance;
 }; 
\ No newline at end of file
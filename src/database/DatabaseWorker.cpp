@@ -0,0 +1,103 @@
+#include "DatabaseWorker.h"
+#include "DatabaseManager.h"
+#include "diagnostics/Tracing.h"
+#include <QMetaObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+
+std::unique_ptr<DatabaseWorker> DatabaseWorker::s_instance = nullptr;
+
+DatabaseWorker& DatabaseWorker::instance()
+{
+    if (!s_instance) {
+        s_instance = std::unique_ptr<DatabaseWorker>(new DatabaseWorker());
+    }
+    return *s_instance;
+}
+
+DatabaseWorker::DatabaseWorker()
+    : m_context(new QObject), m_connectionName("blogclient-worker")
+{
+    m_thread.setObjectName("DatabaseWorker");
+    m_context->moveToThread(&m_thread);
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    stop();
+    delete m_context;
+}
+
+void DatabaseWorker::savePostFields(const Post& post, Post::Fields fields)
+{
+    if (!m_thread.isRunning()) {
+        m_thread.start();
+    }
+
+    QString databasePath = DatabaseManager::instance().databasePath();
+    bool compress = DatabaseManager::instance().contentCompression();
+
+    QMetaObject::invokeMethod(m_context, [this, post, fields, databasePath, compress]() {
+        Post copy = post;
+        bool ok = ensureConnection(databasePath)
+            && DatabaseManager::savePostFields(QSqlDatabase::database(m_connectionName, false), copy, fields, compress);
+        emit postSaved(copy.id(), int(fields), ok);
+    });
+}
+
+void DatabaseWorker::waitForIdle()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    // 任务按顺序执行，空任务返回时之前提交的任务都已完成
+    QMetaObject::invokeMethod(m_context, []() {}, Qt::BlockingQueuedConnection);
+}
+
+void DatabaseWorker::stop()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    // 连接在后台线程中创建，也在后台线程中关闭和移除
+    QMetaObject::invokeMethod(m_context, [this]() {
+        if (QSqlDatabase::contains(m_connectionName)) {
+            QSqlDatabase::database(m_connectionName, false).close();
+            QSqlDatabase::removeDatabase(m_connectionName);
+        }
+        m_openPath.clear();
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+bool DatabaseWorker::ensureConnection(const QString& databasePath)
+{
+    if (databasePath.isEmpty()) {
+        qCWarning(lcDatabase) << "后台线程: 数据库尚未初始化";
+        return false;
+    }
+
+    if (m_openPath == databasePath) {
+        return true;
+    }
+
+    QSqlDatabase db = QSqlDatabase::contains(m_connectionName)
+        ? QSqlDatabase::database(m_connectionName, false)
+        : QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    db.close();
+    db.setDatabaseName(databasePath);
+    db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+
+    if (!db.open()) {
+        qCWarning(lcDatabase) << "后台线程: 数据库连接失败: " << db.lastError().text();
+        m_openPath.clear();
+        return false;
+    }
+
+    m_openPath = databasePath;
+    return true;
+}
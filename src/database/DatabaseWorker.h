@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <memory>
+
+#include "models/Post.h"
+
+// 数据库后台线程
+// 自动保存等不需要立即得到结果的写操作在这里执行，界面线程在输入时不会被磁盘写入阻塞。
+// 后台线程使用自己的SQLite连接（连接不能跨线程使用），打开的是DatabaseManager当前的数据库文件；
+// 数据库处于WAL模式，后台写入时界面线程仍然可以读取。写操作按提交的顺序依次执行。
+class DatabaseWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static DatabaseWorker& instance();
+    ~DatabaseWorker();
+
+    // 在后台更新文章中fields列出的字段，完成后发出postSaved()
+    void savePostFields(const Post& post, Post::Fields fields);
+
+    // 等待已经提交的写操作全部完成（在界面线程同步保存或退出之前调用）
+    void waitForIdle();
+
+    // 结束后台线程并关闭它的连接
+    void stop();
+
+signals:
+    // fields为Post::Fields的整数值，在界面线程中通过排队连接收到
+    void postSaved(int postId, int fields, bool ok);
+
+private:
+    DatabaseWorker();
+
+    // 禁止复制构造和赋值操作
+    DatabaseWorker(const DatabaseWorker&) = delete;
+    DatabaseWorker& operator=(const DatabaseWorker&) = delete;
+
+    // 以下函数只在后台线程中调用
+    bool ensureConnection(const QString& databasePath);
+
+    QThread m_thread;
+    QObject* m_context;         // 属于后台线程的对象，任务通过它排队执行
+    QString m_connectionName;
+    QString m_openPath;         // 后台连接当前打开的数据库文件（只在后台线程访问）
+
+    static std::unique_ptr<DatabaseWorker> s_instance;
+};
@@ -0,0 +1,40 @@
+#include "PostColumns.h"
+#include "diagnostics/Tracing.h"
+
+namespace {
+
+// 正文BLOB的格式：第一个字节是格式版本，后面是数据
+// 版本1：qCompress压缩的UTF-8文本。TEXT类型的值是未压缩的正文（旧数据或较短的正文）
+const char ContentFormatQCompress = 1;
+
+}
+
+QVariant PostColumns::ContentCodec::encode(const QString& content, bool compress)
+{
+    if (!compress || content.size() < MinCompressedLength) {
+        return content;
+    }
+    
+    QByteArray blob = qCompress(content.toUtf8());
+    blob.prepend(ContentFormatQCompress);
+    return blob;
+}
+
+QString PostColumns::ContentCodec::decode(const QVariant& value)
+{
+    if (value.userType() != QMetaType::QByteArray) {
+        return value.toString();
+    }
+    
+    QByteArray blob = value.toByteArray();
+    if (blob.isEmpty()) {
+        return QString();
+    }
+    
+    if (blob.at(0) == ContentFormatQCompress) {
+        return QString::fromUtf8(qUncompress(reinterpret_cast<const uchar*>(blob.constData()) + 1, blob.size() - 1));
+    }
+    
+    qCWarning(lcDatabase) << "未知的正文格式版本: " << int(blob.at(0));
+    return QString();
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <QDateTime>
+#include <QSqlQuery>
+#include <QString>
+#include <QVariant>
+#include <array>
+#include <cstddef>
+
+#include "models/PostSchema.h"
+
+// 由PostSchema生成的posts表语句片段、参数绑定和行解码
+// 列清单和占位符在编译期拼好；参数按位置绑定、列按位置读取，位置同样在编译期确定，
+// 读写每一行时不再按名称查找占位符或列。
+namespace PostColumns {
+
+// 正文的存储格式：短正文保存为TEXT，长正文保存为[格式版本][qCompress(UTF-8)]的BLOB
+struct ContentCodec
+{
+    // 短于这个长度的正文压缩收益不大，直接保存文本
+    static const int MinCompressedLength = 256;
+
+    static QVariant encode(const QString& content, bool compress);
+    static QString decode(const QVariant& value);
+};
+
+namespace detail {
+
+constexpr std::size_t length(const char* text)
+{
+    std::size_t n = 0;
+    while (text[n] != '\0') {
+        ++n;
+    }
+    return n;
+}
+
+// 列清单中每一项的写法
+enum class Item {
+    Name,           // title
+    Placeholder,    // ?
+    Assignment      // title = ?
+};
+
+constexpr std::size_t itemLength(const char* column, Item item)
+{
+    return item == Item::Name ? length(column) : item == Item::Placeholder ? 1 : length(column) + 4;
+}
+
+template <std::size_t N>
+constexpr void append(std::array<char, N>& out, std::size_t& pos, const char* text)
+{
+    for (std::size_t i = 0; text[i] != '\0'; ++i) {
+        out[pos++] = text[i];
+    }
+}
+
+template <Item I, typename... F>
+constexpr std::size_t listLength()
+{
+    return ((itemLength(F::column, I) + 2) + ...) - 2;
+}
+
+// 以", "连接的列清单，结果是以'\0'结尾的字符数组
+template <Item I, typename... F>
+constexpr std::array<char, listLength<I, F...>() + 1> makeList()
+{
+    std::array<char, listLength<I, F...>() + 1> out{};
+    const char* columns[] = {F::column...};
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < sizeof...(F); ++i) {
+        if (i > 0) {
+            append(out, pos, ", ");
+        }
+        if (I == Item::Placeholder) {
+            append(out, pos, "?");
+        } else {
+            append(out, pos, columns[i]);
+            if (I == Item::Assignment) {
+                append(out, pos, " = ?");
+            }
+        }
+    }
+    out[pos] = '\0';
+    return out;
+}
+
+template <typename T>
+struct SqlCodec;
+
+template <>
+struct SqlCodec<QString>
+{
+    static QVariant toSql(const QString& value) { return value; }
+    static QString fromSql(const QVariant& value) { return value.toString(); }
+};
+
+template <>
+struct SqlCodec<int>
+{
+    static QVariant toSql(int value) { return value; }
+    static int fromSql(const QVariant& value) { return value.toInt(); }
+};
+
+template <>
+struct SqlCodec<QDateTime>
+{
+    static QVariant toSql(const QDateTime& value) { return value; }
+    static QDateTime fromSql(const QVariant& value) { return value.toDateTime(); }
+};
+
+template <>
+struct SqlCodec<Post::Status>
+{
+    static QVariant toSql(Post::Status value) { return int(value); }
+    static Post::Status fromSql(const QVariant& value) { return static_cast<Post::Status>(value.toInt()); }
+};
+
+template <typename F>
+QVariant toSql(const Post& post, bool compressContent)
+{
+    if constexpr (F::compressible) {
+        return ContentCodec::encode(F::get(post), compressContent);
+    } else {
+        return SqlCodec<typename F::Type>::toSql(F::get(post));
+    }
+}
+
+template <typename F>
+void fromSql(Post& post, const QVariant& value)
+{
+    if constexpr (F::compressible) {
+        F::set(post, ContentCodec::decode(value));
+    } else {
+        F::set(post, SqlCodec<typename F::Type>::fromSql(value));
+    }
+}
+
+// 没有对应Post::Field的列（remote_id）总是包含在内
+template <typename F>
+bool included(Post::Fields fields)
+{
+    return F::flag == 0 || (fields & Post::Field(F::flag));
+}
+
+}
+
+// 字段列表对应的语句片段（编译期常量）
+template <typename L>
+struct Sql;
+
+template <typename... F>
+struct Sql<PostSchema::List<F...>>
+{
+    // title, content, ...
+    static constexpr auto names = detail::makeList<detail::Item::Name, F...>();
+    // ?, ?, ...
+    static constexpr auto placeholders = detail::makeList<detail::Item::Placeholder, F...>();
+    // title = ?, content = ?, ...
+    static constexpr auto assignments = detail::makeList<detail::Item::Assignment, F...>();
+};
+
+// fields中包含的列的"col = ?, ..."，顺序与bind()一致
+template <typename... F>
+QString assignments(PostSchema::List<F...>, Post::Fields fields)
+{
+    QString result;
+    PostSchema::forEach(PostSchema::List<F...>(), [&](auto field) {
+        using Field = decltype(field);
+        if (detail::included<Field>(fields)) {
+            if (!result.isEmpty()) {
+                result += QLatin1String(", ");
+            }
+            result += QLatin1String(Sql<PostSchema::List<Field>>::assignments.data());
+        }
+    });
+    return result;
+}
+
+// 从position开始按位置绑定fields中包含的列，返回下一个参数的位置
+template <typename... F>
+int bind(PostSchema::List<F...>, QSqlQuery& query, const Post& post, Post::Fields fields, bool compressContent,
+         int position = 0)
+{
+    PostSchema::forEach(PostSchema::List<F...>(), [&](auto field) {
+        using Field = decltype(field);
+        if (detail::included<Field>(fields)) {
+            query.bindValue(position++, detail::toSql<Field>(post, compressContent));
+        }
+    });
+    return position;
+}
+
+// 从结果的第position列开始按顺序读取全部列到post中，返回下一列的位置
+template <typename... F>
+int read(PostSchema::List<F...>, const QSqlQuery& query, Post& post, int position = 0)
+{
+    PostSchema::forEach(PostSchema::List<F...>(), [&](auto field) {
+        using Field = decltype(field);
+        detail::fromSql<Field>(post, query.value(position++));
+    });
+    return position;
+}
+
+}
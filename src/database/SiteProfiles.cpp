@@ -0,0 +1,156 @@
+#include "SiteProfiles.h"
+#include <QDir>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QStandardPaths>
+#include <algorithm>
+
+const char* const SiteProfiles::DefaultSiteId = "default";
+
+namespace {
+
+QString siteKey(const QString& id, const char* key)
+{
+    return QString("sites/%1/%2").arg(id, QLatin1String(key));
+}
+
+SiteProfile readProfile(QSettings& settings, const QString& id)
+{
+    SiteProfile profile;
+    profile.id = id;
+    profile.name = settings.value(siteKey(id, "name")).toString();
+    profile.apiUrl = settings.value(siteKey(id, "url")).toString();
+    profile.username = settings.value(siteKey(id, "username")).toString();
+    profile.password = settings.value(siteKey(id, "password")).toString();
+    return profile;
+}
+
+}
+
+QString SiteProfile::databasePath() const
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir dir(dataPath);
+    if (!dir.exists()) {
+        dir.mkpath(".");
+    }
+
+    // 默认站点沿用多站点之前的数据库文件
+    if (id == QLatin1String(SiteProfiles::DefaultSiteId)) {
+        return dataPath + "/blogclient.db";
+    }
+    return dataPath + "/blogclient-" + id + ".db";
+}
+
+QList<SiteProfile> SiteProfiles::all()
+{
+    migrateLegacySettings();
+
+    QSettings settings;
+    settings.beginGroup("sites");
+    QStringList ids = settings.childGroups();
+    settings.endGroup();
+    std::sort(ids.begin(), ids.end());
+
+    QList<SiteProfile> profiles;
+    for (const QString& id : ids) {
+        profiles.append(readProfile(settings, id));
+    }
+    if (profiles.isEmpty()) {
+        SiteProfile profile;
+        profile.id = DefaultSiteId;
+        profiles.append(profile);
+    }
+    return profiles;
+}
+
+SiteProfile SiteProfiles::find(const QString& id)
+{
+    for (const SiteProfile& profile : all()) {
+        if (profile.id == id) {
+            return profile;
+        }
+    }
+    return SiteProfile();
+}
+
+SiteProfile SiteProfiles::current()
+{
+    QList<SiteProfile> profiles = all();
+    QString id = QSettings().value("site/current").toString();
+    for (const SiteProfile& profile : profiles) {
+        if (profile.id == id) {
+            return profile;
+        }
+    }
+    // 记录的站点已被删除时使用第一个站点
+    return profiles.first();
+}
+
+void SiteProfiles::setCurrent(const QString& id)
+{
+    QSettings settings;
+    settings.setValue("site/current", id);
+}
+
+void SiteProfiles::save(const SiteProfile& profile)
+{
+    if (!isValidId(profile.id)) {
+        return;
+    }
+
+    migrateLegacySettings();
+    QSettings settings;
+    settings.setValue(siteKey(profile.id, "name"), profile.name);
+    settings.setValue(siteKey(profile.id, "url"), profile.apiUrl);
+    settings.setValue(siteKey(profile.id, "username"), profile.username);
+    settings.setValue(siteKey(profile.id, "password"), profile.password);
+    settings.sync();
+}
+
+void SiteProfiles::remove(const QString& id)
+{
+    QSettings settings;
+    settings.remove("sites/" + id);
+}
+
+bool SiteProfiles::isValidId(const QString& id)
+{
+    static const QRegularExpression pattern("^[A-Za-z0-9_-]+$");
+    return pattern.match(id).hasMatch();
+}
+
+QDateTime SiteProfiles::lastSyncTime(const QString& id)
+{
+    migrateLegacySettings();
+    return QSettings().value(siteKey(id, "lastSyncTime")).toDateTime();
+}
+
+void SiteProfiles::setLastSyncTime(const QString& id, const QDateTime& time)
+{
+    QSettings settings;
+    settings.setValue(siteKey(id, "lastSyncTime"), time);
+    settings.sync();
+}
+
+void SiteProfiles::migrateLegacySettings()
+{
+    QSettings settings;
+    if (!settings.contains("api/url") && !settings.contains("sync/lastSyncTime")) {
+        return;
+    }
+
+    // 已经有同名站点时不覆盖，只清理旧的键
+    QString id = DefaultSiteId;
+    if (!settings.contains(siteKey(id, "url"))) {
+        settings.setValue(siteKey(id, "url"), settings.value("api/url"));
+        settings.setValue(siteKey(id, "username"), settings.value("api/username"));
+        settings.setValue(siteKey(id, "password"), settings.value("api/password"));
+        if (settings.contains("sync/lastSyncTime")) {
+            settings.setValue(siteKey(id, "lastSyncTime"), settings.value("sync/lastSyncTime"));
+        }
+    }
+    settings.remove("api");
+    settings.remove("sync/lastSyncTime");
+    settings.sync();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+// 一个WordPress站点的配置
+struct SiteProfile
+{
+    QString id;         // 站点标识（字母、数字、-和_），也用于数据库文件名和命令行的--site
+    QString name;       // 显示名称
+    QString apiUrl;
+    QString username;
+    QString password;
+
+    bool isValid() const { return !id.isEmpty(); }
+    bool isConfigured() const { return !apiUrl.isEmpty() && !username.isEmpty() && !password.isEmpty(); }
+    QString displayName() const { return name.isEmpty() ? id : name; }
+    // 站点自己的数据库文件：文章、分类、标签和同步状态按站点分开保存
+    QString databasePath() const;
+};
+
+// 站点配置，保存在QSettings的sites/<id>/下
+// 每个站点有自己的数据库文件和API会话（WordPressAPI::session()），切换站点只是打开另一个数据库、
+// 切换当前会话，不改写其他站点的设置。
+// 旧版本只有一组api/*设置和一个数据库文件，第一次使用时迁移为"default"站点，沿用原来的数据库。
+class SiteProfiles
+{
+public:
+    static const char* const DefaultSiteId;
+
+    // 全部站点，按标识排序；没有配置任何站点时只有一个空的默认站点
+    static QList<SiteProfile> all();
+    // 找不到时返回的配置isValid()为false
+    static SiteProfile find(const QString& id);
+
+    // 当前站点（图形界面正在使用、命令行没有指定--site时使用的站点）
+    static SiteProfile current();
+    static void setCurrent(const QString& id);
+
+    static void save(const SiteProfile& profile);
+    // 只删除配置，不删除数据库文件
+    static void remove(const QString& id);
+    static bool isValidId(const QString& id);
+
+    // 上次完整成功同步的时间（增量同步的起点）
+    static QDateTime lastSyncTime(const QString& id);
+    static void setLastSyncTime(const QString& id, const QDateTime& time);
+
+private:
+    static void migrateLegacySettings();
+};
@@ -0,0 +1,226 @@
+#include "SyncMerge.h"
+#include "DatabaseManager.h"
+#include "diagnostics/Tracing.h"
+#include "models/PostMerge.h"
+#include "models/PostSchema.h"
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
+#include <QSqlDatabase>
+#include <QThreadPool>
+
+namespace SyncMerge {
+
+namespace {
+
+Result saveSynced(Post post)
+{
+    Result result;
+    DatabaseManager::SaveOutcome outcome = DatabaseManager::Unchanged;
+    if (!DatabaseManager::instance().savePost(post, &outcome)) {
+        qCWarning(lcDatabase) << "保存文章失败: 远程ID=" << post.remoteId() << "标题=" << post.title();
+        result.post = post;
+        return result;
+    }
+    DatabaseManager::instance().markSynced(post);
+
+    result.outcome = outcome == DatabaseManager::Inserted ? Inserted
+                   : outcome == DatabaseManager::Updated ? Updated : Unchanged;
+    result.post = post;
+    return result;
+}
+
+// 没有基线时无法判断哪一方修改了什么，两边不同的字段都算冲突
+Result conflictWithoutBase(const Post& local, const Post& remote)
+{
+    Result result;
+    result.outcome = Conflict;
+    result.post = remote;
+    result.post.setId(local.id());
+    result.conflicts = PostSchema::diff(local, remote);
+    return result;
+}
+
+Result finishMerge(const Post& local, const Post& remote, const PostMerge::Result& merge)
+{
+    if (merge.conflicts) {
+        qCDebug(lcDatabase) << "文章合并冲突: 本地ID=" << local.id() << "字段=" << int(merge.conflicts);
+        Result result;
+        result.outcome = Conflict;
+        result.post = remote;
+        result.post.setId(local.id());
+        result.conflicts = merge.conflicts;
+        return result;
+    }
+
+    Result result;
+    Post merged = merge.merged;
+    if (!DatabaseManager::instance().savePost(merged)) {
+        result.post = merged;
+        return result;
+    }
+    // 基线移到远程版本，之后只有合并进来的本地修改需要推送
+    acceptLocal(local.id(), remote);
+
+    qCDebug(lcDatabase) << "文章已自动合并: 本地ID=" << local.id() << "待推送字段=" << int(merge.localChanges);
+    result.outcome = Merged;
+    result.post = merged;
+    return result;
+}
+
+// 在线程池中合并，结果回到界面线程后交给finish
+void startMerge(const Post& base, const Post& local, const Post& remote, QObject* context,
+                std::function<void(const PostMerge::Result&)> finish)
+{
+    QPointer<QObject> guard(context);
+    // 合并期间切换了站点（打开了另一个数据库）时结果不能再写入
+    QString databasePath = DatabaseManager::instance().databasePath();
+    QThreadPool::globalInstance()->start([base, local, remote, guard, finish, databasePath]() {
+        TraceSpan span("sync.merge");
+        PostMerge::Result merge = PostMerge::merge(base, local, remote);
+        span.finish();
+
+        // 回到界面线程：数据库默认连接只能在创建它的线程中使用；context在界面线程中销毁，也只能在那里检查
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, finish, merge, databasePath]() {
+            if (DatabaseManager::instance().databasePath() != databasePath) {
+                qCDebug(lcDatabase) << "数据库已切换，丢弃合并结果";
+                return;
+            }
+            if (guard) {
+                finish(merge);
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+}
+
+Result saveRemote(const Post& remote, QObject* context, const Callback& done)
+{
+    DatabaseManager& db = DatabaseManager::instance();
+    int localId = remote.hasRemoteId() ? db.findPostIdByRemoteId(remote.remoteId()) : -1;
+    if (localId <= 0) {
+        return saveSynced(remote);
+    }
+
+    // 从未同步过的文章（没有摘要）无从判断本地修改，与以前一样直接覆盖
+    Post local = db.getPostById(localId);
+    PostSchema::FieldHashes synced = db.syncedHashes(localId);
+    if (synced.isEmpty() || !PostSchema::changedSince(synced, local)) {
+        Post post = remote;
+        post.setId(localId);
+        return saveSynced(post);
+    }
+
+    // 本地有修改：远程也修改过时才需要合并
+    bool remoteChanged = remote.remoteModified().isEmpty() || remote.remoteModified() != local.remoteModified();
+    if (!remoteChanged) {
+        Result result;
+        result.outcome = KeptLocal;
+        result.post = local;
+        return result;
+    }
+
+    Post base = db.syncBase(localId);
+    if (base.id() != localId) {
+        return conflictWithoutBase(local, remote);
+    }
+
+    startMerge(base, local, remote, context, [local, remote, context, done](const PostMerge::Result& merge) {
+        // 合并期间本地又保存过时结果已经过时，按最新的本地版本重新处理
+        Post current = DatabaseManager::instance().getPostById(local.id());
+        if (PostSchema::hashFields(current) != PostSchema::hashFields(local)) {
+            Result retry = saveRemote(remote, context, done);
+            if (retry.outcome != Pending) {
+                done(retry);
+            }
+            return;
+        }
+        done(finishMerge(local, remote, merge));
+    });
+
+    Result result;
+    result.outcome = Pending;
+    result.post = local;
+    return result;
+}
+
+Result prepareUpdate(const Post& local, const Post& remote, QObject* context, const Callback& done)
+{
+    if (!remote.remoteModified().isEmpty() && remote.remoteModified() == local.remoteModified()) {
+        Result result;
+        result.outcome = KeptLocal;
+        result.post = local;
+        return result;
+    }
+
+    Post base = DatabaseManager::instance().syncBase(local.id());
+    if (base.id() != local.id()) {
+        return conflictWithoutBase(local, remote);
+    }
+
+    startMerge(base, local, remote, context, [local, remote, context, done](const PostMerge::Result& merge) {
+        // 合并期间本地又保存过时结果已经过时，按最新的本地版本重新处理
+        Post current = DatabaseManager::instance().getPostById(local.id());
+        if (PostSchema::hashFields(current) != PostSchema::hashFields(local)) {
+            Result retry = prepareUpdate(current, remote, context, done);
+            if (retry.outcome != Pending) {
+                done(retry);
+            }
+            return;
+        }
+        done(finishMerge(local, remote, merge));
+    });
+
+    Result result;
+    result.outcome = Pending;
+    result.post = local;
+    return result;
+}
+
+bool acceptLocal(int localId, const Post& remote)
+{
+    Post synced = remote;
+    synced.setId(localId);
+    return DatabaseManager::instance().markSynced(synced);
+}
+
+Result acceptRemote(int localId, const Post& remote)
+{
+    Post post = remote;
+    post.setId(localId);
+    return saveSynced(post);
+}
+
+Removal removeDeleted(const QList<PostIndex::Stamp>& stamps, bool dryRun)
+{
+    DatabaseManager& db = DatabaseManager::instance();
+    Removal removal;
+    QSqlDatabase connection = QSqlDatabase::database();
+    if (!dryRun) {
+        connection.transaction();
+    }
+    for (const PostIndex::Stamp& stamp : stamps) {
+        // 上次同步后在本地修改过的文章不删除，留给用户处理
+        PostSchema::FieldHashes synced = db.syncedHashes(stamp.localId);
+        if (!synced.isEmpty() && PostSchema::changedSince(synced, db.getPostById(stamp.localId))) {
+            removal.conflicts.append(stamp.localId);
+            continue;
+        }
+
+        if (dryRun || db.deletePost(stamp.localId)) {
+            removal.deleted.append(stamp.localId);
+        } else {
+            removal.failed.append(stamp.localId);
+        }
+    }
+    if (!dryRun) {
+        connection.commit();
+    }
+
+    qCDebug(lcDatabase) << "远程已删除的文章: 删除" << removal.deleted.size() << "篇，保留本地修改"
+                        << removal.conflicts.size() << "篇，失败" << removal.failed.size() << "篇";
+    return removal;
+}
+
+}
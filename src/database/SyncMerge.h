@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+#include "models/Post.h"
+#include "models/PostIndex.h"
+
+// 获取和推送文章时的冲突检测与合并
+// 每次同步时把文章的完整版本保存为基线（DatabaseManager::syncBase()）。获取到远程文章时：
+// 本地自上次同步后没有修改的直接保存；只有本地修改过、远程modified_gmt与上次同步时相同的保留本地版本；
+// 两边都修改过的在线程池中与基线做三方合并（PostMerge），能自动合并的保存合并结果，
+// 有冲突的保留本地版本并报告冲突。合并在后台进行，不阻塞其他文章的保存。
+// 所有函数都在界面线程（数据库默认连接所在的线程）中调用，回调也在界面线程中执行。
+namespace SyncMerge {
+
+enum Outcome {
+    Inserted,       // 新文章，已保存
+    Updated,        // 本地没有修改，已保存远程版本
+    Unchanged,      // 与本地内容相同，没有写入
+    KeptLocal,      // 远程没有修改，保留本地修改（推送时：可以直接更新远程）
+    Pending,        // 两边都有修改，正在后台合并，完成后调用回调
+    Merged,         // 已自动合并并保存到本地，同步基线已移到远程版本
+    Conflict,       // 有无法自动合并的字段，本地版本保持不变
+    Failed          // 保存失败
+};
+
+struct Result
+{
+    Outcome outcome = Failed;
+    // Conflict时为远程版本（ID为本地ID），KeptLocal时为本地版本，其他情况为保存后的文章
+    Post post;
+    Post::Fields conflicts;     // Conflict：两边都修改过且无法合并的字段
+};
+
+using Callback = std::function<void(const Result&)>;
+
+// 保存获取到的远程文章；返回Pending时合并完成后调用done（context销毁后不再调用）
+Result saveRemote(const Post& remote, QObject* context, const Callback& done);
+
+// 推送本地修改之前调用，remote是刚获取的远程版本
+// 远程自上次同步后没有修改时返回KeptLocal，可以直接更新；否则返回Pending并在后台合并：
+// Merged时合并结果已经保存，之后updatePost()只发送本地修改的部分；Conflict时本地不变
+Result prepareUpdate(const Post& local, const Post& remote, QObject* context, const Callback& done);
+
+// 解决冲突：保留本地版本（以远程版本为基线，之后updatePost()发送与远程不同的全部字段）
+bool acceptLocal(int localId, const Post& remote);
+// 解决冲突：放弃本地修改，保存远程版本
+Result acceptRemote(int localId, const Post& remote);
+
+// 远程已删除的文章（PostIndex::compare()的deleted）的处理结果，都是本地ID
+struct Removal
+{
+    QList<int> deleted;     // 已删除（dryRun时为将要删除）
+    QList<int> conflicts;   // 上次同步后在本地修改过，没有删除
+    QList<int> failed;      // 删除失败
+};
+
+// 在一个事务中删除远程已删除的文章；只有远程文章列表完整（所有页都获取成功、期间总数没有变化）时才能调用
+Removal removeDeleted(const QList<PostIndex::Stamp>& stamps, bool dryRun = false);
+
+}
@@ -0,0 +1,135 @@
+#include "Tracing.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+Q_LOGGING_CATEGORY(lcNetwork, "blogclient.network", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcDatabase, "blogclient.database", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcParse, "blogclient.parse", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcUi, "blogclient.ui", QtWarningMsg)
+
+double SpanSummary::rowsPerSecond() const
+{
+    if (totalMs <= 0) {
+        return 0;
+    }
+    return rows * 1000.0 / totalMs;
+}
+
+TraceStats& TraceStats::instance()
+{
+    // 其他线程也会记录耗时，这里用静态局部变量保证初始化线程安全
+    static TraceStats instance;
+    return instance;
+}
+
+TraceStats::TraceStats()
+{
+}
+
+TraceStats::~TraceStats()
+{
+}
+
+void TraceStats::record(const QString& name, qint64 nanoseconds, qint64 bytes, qint64 rows)
+{
+    QMutexLocker locker(&m_mutex);
+    
+    Span& span = m_spans[name];
+    span.count++;
+    span.totalNanoseconds += nanoseconds;
+    span.bytes += bytes;
+    span.rows += rows;
+    
+    // 样本数达到上限后循环覆盖最旧的样本
+    if (span.samples.size() < MaxSamples) {
+        span.samples.append(nanoseconds);
+    } else {
+        span.samples[span.nextSample] = nanoseconds;
+        span.nextSample = (span.nextSample + 1) % MaxSamples;
+    }
+}
+
+void TraceStats::addCounter(const QString& name, qint64 value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters[name] += value;
+}
+
+QList<SpanSummary> TraceStats::spans() const
+{
+    QMutexLocker locker(&m_mutex);
+    
+    QList<SpanSummary> result;
+    for (auto it = m_spans.constBegin(); it != m_spans.constEnd(); ++it) {
+        const Span& span = it.value();
+        
+        SpanSummary summary;
+        summary.name = it.key();
+        summary.count = span.count;
+        summary.totalMs = span.totalNanoseconds / 1e6;
+        summary.bytes = span.bytes;
+        summary.rows = span.rows;
+        
+        if (!span.samples.isEmpty()) {
+            QVector<qint64> samples = span.samples;
+            auto percentile = [&samples](double fraction) {
+                int index = qMin(samples.size() - 1, int(fraction * samples.size()));
+                std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+                return samples[index] / 1e6;
+            };
+            summary.p50Ms = percentile(0.50);
+            summary.p95Ms = percentile(0.95);
+        }
+        
+        result.append(summary);
+    }
+    
+    std::sort(result.begin(), result.end(), [](const SpanSummary& a, const SpanSummary& b) {
+        return a.name < b.name;
+    });
+    return result;
+}
+
+QHash<QString, qint64> TraceStats::counters() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_counters;
+}
+
+void TraceStats::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_spans.clear();
+    m_counters.clear();
+}
+
+TraceSpan::TraceSpan(const QString& name)
+    : m_name(name), m_bytes(0), m_rows(0), m_finished(false)
+{
+    m_timer.start();
+}
+
+TraceSpan::~TraceSpan()
+{
+    finish();
+}
+
+void TraceSpan::addBytes(qint64 bytes)
+{
+    m_bytes += bytes;
+}
+
+void TraceSpan::addRows(qint64 rows)
+{
+    m_rows += rows;
+}
+
+void TraceSpan::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    
+    m_finished = true;
+    TraceStats::instance().record(m_name, m_timer.nsecsElapsed(), m_bytes, m_rows);
+}
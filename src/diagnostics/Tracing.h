@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QLoggingCategory>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+// 日志分类，默认只输出警告及以上级别
+// 需要详细日志时通过环境变量开启，例如：QT_LOGGING_RULES="blogclient.*.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcNetwork)
+Q_DECLARE_LOGGING_CATEGORY(lcDatabase)
+Q_DECLARE_LOGGING_CATEGORY(lcParse)
+Q_DECLARE_LOGGING_CATEGORY(lcUi)
+
+// 单个统计项的汇总结果
+struct SpanSummary
+{
+    QString name;
+    qint64 count = 0;
+    double p50Ms = 0;
+    double p95Ms = 0;
+    double totalMs = 0;
+    qint64 bytes = 0;
+    qint64 rows = 0;
+
+    // 每秒处理的行数（按累计耗时计算）
+    double rowsPerSecond() const;
+};
+
+// 进程内的耗时统计，按名称聚合网络请求、解析阶段和SQL语句的耗时
+// 每个名称保留最近的若干个样本用于计算分位数，可在多个线程中使用
+class TraceStats
+{
+public:
+    static TraceStats& instance();
+    ~TraceStats();
+
+    void record(const QString& name, qint64 nanoseconds, qint64 bytes = 0, qint64 rows = 0);
+
+    // 计数器，用于没有耗时的指标（例如节省的字节数）
+    void addCounter(const QString& name, qint64 value);
+
+    QList<SpanSummary> spans() const;
+    QHash<QString, qint64> counters() const;
+    void reset();
+
+private:
+    TraceStats();
+
+    // 禁止复制构造和赋值操作
+    TraceStats(const TraceStats&) = delete;
+    TraceStats& operator=(const TraceStats&) = delete;
+
+    struct Span
+    {
+        qint64 count = 0;
+        qint64 totalNanoseconds = 0;
+        qint64 bytes = 0;
+        qint64 rows = 0;
+        QVector<qint64> samples;
+        int nextSample = 0;
+    };
+
+    static const int MaxSamples = 2048;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Span> m_spans;
+    QHash<QString, qint64> m_counters;
+};
+
+// 作用域计时器：析构时把耗时记录到TraceStats
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const QString& name);
+    ~TraceSpan();
+
+    void addBytes(qint64 bytes);
+    void addRows(qint64 rows);
+
+    // 提前结束计时（之后析构不再重复记录）
+    void finish();
+
+private:
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    QString m_name;
+    QElapsedTimer m_timer;
+    qint64 m_bytes;
+    qint64 m_rows;
+    bool m_finished;
+};
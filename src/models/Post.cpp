@@ -1,162 +1,302 @@
 #include "Post.h"
+#include <utility>
+
+class PostData : public QSharedData
+{
+public:
+    int m_id = -1;              // 本地数据库ID
+    int m_remoteId = -1;        // WordPress远程ID
+    int m_featureMediaId = -1;  // 特色图片ID
+    QString m_remoteModified;   // 服务器上的修改时间
+    QString m_title;
+    QString m_content;
+    QString m_excerpt;
+    QDateTime m_publishDate;
+    QString m_author;
+    Post::Status m_status = Post::Draft;
+    bool m_contentLoaded = true;
+    TermIds m_categoryIds;
+    TermIds m_tagIds;
+    QString m_featuredImageUrl;
+};
 
 Post::Post()
-    : m_id(-1), m_remoteId(-1), m_status(Status::Draft)
+    : d(new PostData)
 {
-    m_publishDate = QDateTime::currentDateTime();
+    d->m_publishDate = QDateTime::currentDateTime();
 }
 
-Post::Post(int id, const QString& title, const QString& content, 
-         const QString& excerpt, const QDateTime& publishDate,
-         const QString& author, Status status)
-    : m_id(id), m_remoteId(-1), m_title(title), m_content(content),
-      m_excerpt(excerpt), m_publishDate(publishDate),
-      m_author(author), m_status(status)
+Post::Post(int id, QString title, QString content,
+         QString excerpt, QDateTime publishDate,
+         QString author, Status status)
+    : d(new PostData)
 {
+    d->m_id = id;
+    d->m_title = std::move(title);
+    d->m_content = std::move(content);
+    d->m_excerpt = std::move(excerpt);
+    d->m_publishDate = std::move(publishDate);
+    d->m_author = std::move(author);
+    d->m_status = status;
 }
 
+Post::Post(const Post& other) = default;
+Post::Post(Post&& other) noexcept = default;
+Post& Post::operator=(const Post& other) = default;
+Post& Post::operator=(Post&& other) noexcept = default;
+
 Post::~Post()
 {
 }
 
 int Post::id() const
 {
-    return m_id;
+    return d->m_id;
 }
 
 void Post::setId(int id)
 {
-    m_id = id;
+    d->m_id = id;
 }
 
 int Post::remoteId() const
 {
-    return m_remoteId;
+    return d->m_remoteId;
 }
 
 void Post::setRemoteId(int remoteId)
 {
-    m_remoteId = remoteId;
+    d->m_remoteId = remoteId;
 }
 
 bool Post::hasRemoteId() const
 {
-    return m_remoteId > 0;
+    return d->m_remoteId > 0;
+}
+
+const QString& Post::remoteModified() const
+{
+    return d->m_remoteModified;
+}
+
+void Post::setRemoteModified(QString modified)
+{
+    d->m_remoteModified = std::move(modified);
+}
+
+const QString& Post::title() const
+{
+    return d->m_title;
+}
+
+void Post::setTitle(QString title)
+{
+    d->m_title = std::move(title);
 }
 
-QString Post::title() const
+const QString& Post::content() const
 {
-    return m_title;
+    return d->m_content;
 }
 
-void Post::setTitle(const QString& title)
+void Post::setContent(QString content)
 {
-    m_title = title;
+    d->m_content = std::move(content);
+    d->m_contentLoaded = true;
 }
 
-QString Post::content() const
+bool Post::isContentLoaded() const
 {
-    return m_content;
+    return d->m_contentLoaded;
 }
 
-void Post::setContent(const QString& content)
+void Post::setContentLoaded(bool loaded)
 {
-    m_content = content;
+    if (!loaded) {
+        d->m_content.clear();
+    }
+    d->m_contentLoaded = loaded;
 }
 
-QString Post::excerpt() const
+const QString& Post::excerpt() const
 {
-    return m_excerpt;
+    return d->m_excerpt;
 }
 
-void Post::setExcerpt(const QString& excerpt)
+void Post::setExcerpt(QString excerpt)
 {
-    m_excerpt = excerpt;
+    d->m_excerpt = std::move(excerpt);
 }
 
-QDateTime Post::publishDate() const
+const QDateTime& Post::publishDate() const
 {
-    return m_publishDate;
+    return d->m_publishDate;
 }
 
-void Post::setPublishDate(const QDateTime& date)
+void Post::setPublishDate(QDateTime date)
 {
-    m_publishDate = date;
+    d->m_publishDate = std::move(date);
 }
 
-QString Post::author() const
+const QString& Post::author() const
 {
-    return m_author;
+    return d->m_author;
 }
 
-void Post::setAuthor(const QString& author)
+void Post::setAuthor(QString author)
 {
-    m_author = author;
+    d->m_author = std::move(author);
 }
 
 Post::Status Post::status() const
 {
-    return m_status;
+    return d->m_status;
 }
 
 void Post::setStatus(Post::Status status)
 {
-    m_status = status;
+    d->m_status = status;
+}
+
+const TermIds& Post::categoryIds() const
+{
+    return d->m_categoryIds;
+}
+
+void Post::setCategoryIds(TermIds ids)
+{
+    TermTable::normalize(ids);
+    d->m_categoryIds = std::move(ids);
+}
+
+void Post::addCategoryId(int id)
+{
+    if (!hasCategoryId(id)) {
+        TermTable::insertId(d->m_categoryIds, id);
+    }
+}
+
+void Post::removeCategoryId(int id)
+{
+    if (hasCategoryId(id)) {
+        TermTable::removeId(d->m_categoryIds, id);
+    }
+}
+
+bool Post::hasCategoryId(int id) const
+{
+    return TermTable::containsId(d->m_categoryIds, id);
+}
+
+const TermIds& Post::tagIds() const
+{
+    return d->m_tagIds;
+}
+
+void Post::setTagIds(TermIds ids)
+{
+    TermTable::normalize(ids);
+    d->m_tagIds = std::move(ids);
+}
+
+void Post::addTagId(int id)
+{
+    if (!hasTagId(id)) {
+        TermTable::insertId(d->m_tagIds, id);
+    }
+}
+
+void Post::removeTagId(int id)
+{
+    if (hasTagId(id)) {
+        TermTable::removeId(d->m_tagIds, id);
+    }
+}
+
+bool Post::hasTagId(int id) const
+{
+    return TermTable::containsId(d->m_tagIds, id);
 }
 
 QStringList Post::categories() const
 {
-    return m_categories;
+    return TermTable::categories().names(d->m_categoryIds);
 }
 
 void Post::setCategories(const QStringList& categories)
 {
-    m_categories = categories;
+    TermIds ids;
+    for (const QString& category : categories) {
+        ids.append(TermTable::categories().intern(category));
+    }
+    setCategoryIds(std::move(ids));
 }
 
 void Post::addCategory(const QString& category)
 {
-    if (!m_categories.contains(category)) {
-        m_categories.append(category);
-    }
+    addCategoryId(TermTable::categories().intern(category));
 }
 
 void Post::removeCategory(const QString& category)
 {
-    m_categories.removeAll(category);
+    // 按名称比较而不是按ID查找：文章里可能还是保存前分配的临时ID
+    const TermTable& table = TermTable::categories();
+    TermIds ids = d->m_categoryIds;
+    for (int id : ids) {
+        if (table.name(id) == category) {
+            removeCategoryId(id);
+        }
+    }
 }
 
 QStringList Post::tags() const
 {
-    return m_tags;
+    return TermTable::tags().names(d->m_tagIds);
 }
 
 void Post::setTags(const QStringList& tags)
 {
-    m_tags = tags;
+    TermIds ids;
+    for (const QString& tag : tags) {
+        ids.append(TermTable::tags().intern(tag));
+    }
+    setTagIds(std::move(ids));
 }
 
 void Post::addTag(const QString& tag)
 {
-    if (!m_tags.contains(tag)) {
-        m_tags.append(tag);
-    }
+    addTagId(TermTable::tags().intern(tag));
 }
 
 void Post::removeTag(const QString& tag)
 {
-    m_tags.removeAll(tag);
+    // 按名称比较而不是按ID查找：文章里可能还是保存前分配的临时ID
+    const TermTable& table = TermTable::tags();
+    TermIds ids = d->m_tagIds;
+    for (int id : ids) {
+        if (table.name(id) == tag) {
+            removeTagId(id);
+        }
+    }
 }
 
-QString Post::featuredImageUrl() const
+const QString& Post::featuredImageUrl() const
 {
-    return m_featuredImageUrl;
+    return d->m_featuredImageUrl;
 }
 
-void Post::setFeaturedImageUrl(const QString& url)
+void Post::setFeaturedImageUrl(QString url)
 {
-    m_featuredImageUrl = url;
+    d->m_featuredImageUrl = std::move(url);
 } 
 
-void Post::setFeatureMediaId(int id) { m_featureMediaId = id; }
-int Post::featureMediaId() const { return m_featureMediaId; }
\ No newline at end of file
+void Post::setFeatureMediaId(int id) { d->m_featureMediaId = id; }
+int Post::featureMediaId() const { return d->m_featureMediaId; }
+
+QString Post::displayText() const
+{
+    return QString("%1 (%2)").arg(
+        d->m_title.length() > 30 ? d->m_title.left(30) + "..." : d->m_title,
+        d->m_publishDate.toString("yyyy-MM-dd")
+    );
+}
@@ -3,7 +3,17 @@
 #include <QString>
 #include <QDateTime>
 #include <QStringList>
+#include <QSharedDataPointer>
+#include <QFlags>
 
+#include "TermTable.h"
+
+class PostData;
+
+// 博客文章
+// 数据通过QSharedDataPointer隐式共享：复制Post只增加引用计数，修改时才真正复制（写时复制），
+// 因此在列表、请求句柄和编辑器之间按值传递文章的开销是O(1)。引用计数是原子的，副本也可以直接交给
+// 后台线程（自动保存、合并），不会复制正文；之后任何一方修改时自动分离。
 class Post {
 public:
     enum Status {
@@ -11,13 +21,34 @@ public:
         Published
     };
 
+    // 可编辑的字段，用于记录哪些字段被修改过（自动保存时只写入这些列）
+    enum Field {
+        TitleField = 0x01,
+        ContentField = 0x02,
+        ExcerptField = 0x04,
+        PublishDateField = 0x08,
+        AuthorField = 0x10,
+        StatusField = 0x20,
+        FeaturedImageField = 0x40,
+        TermsField = 0x80,
+        AllFields = 0xff
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+
     Post();
-    Post(int id, const QString& title, const QString& content, 
-         const QString& excerpt, const QDateTime& publishDate,
-         const QString& author, Status status);
+    Post(int id, QString title, QString content,
+         QString excerpt, QDateTime publishDate,
+         QString author, Status status);
+    Post(const Post& other);
+    Post(Post&& other) noexcept;
+    Post& operator=(const Post& other);
+    Post& operator=(Post&& other) noexcept;
     ~Post();
 
+    void swap(Post& other) noexcept { d.swap(other.d); }
+
     // 获取器和设置器
+    // 设置器按值接收参数，调用方可以用std::move把临时字符串直接转交进来
     int id() const;
     void setId(int id);
 
@@ -25,25 +56,45 @@ public:
     int remoteId() const;
     void setRemoteId(int remoteId);
     bool hasRemoteId() const;
+    // 服务器上最后修改的时间（modified_gmt原样保存），与远程文章列表对比时判断是否有更新
+    const QString& remoteModified() const;
+    void setRemoteModified(QString modified);
 
-    QString title() const;
-    void setTitle(const QString& title);
+    const QString& title() const;
+    void setTitle(QString title);
 
-    QString content() const;
-    void setContent(const QString& content);
+    const QString& content() const;
+    void setContent(QString content);
+    // 列表加载的文章不带正文，需要正文时通过DatabaseManager::loadPostContent()补上
+    bool isContentLoaded() const;
+    void setContentLoaded(bool loaded);
 
-    QString excerpt() const;
-    void setExcerpt(const QString& excerpt);
+    const QString& excerpt() const;
+    void setExcerpt(QString excerpt);
 
-    QDateTime publishDate() const;
-    void setPublishDate(const QDateTime& date);
+    const QDateTime& publishDate() const;
+    void setPublishDate(QDateTime date);
 
-    QString author() const;
-    void setAuthor(const QString& author);
+    const QString& author() const;
+    void setAuthor(QString author);
 
     Status status() const;
     void setStatus(Status status);
 
+    // 分类和标签以升序ID集合保存，名称通过TermTable解析
+    const TermIds& categoryIds() const;
+    void setCategoryIds(TermIds ids);
+    void addCategoryId(int id);
+    void removeCategoryId(int id);
+    bool hasCategoryId(int id) const;
+
+    const TermIds& tagIds() const;
+    void setTagIds(TermIds ids);
+    void addTagId(int id);
+    void removeTagId(int id);
+    bool hasTagId(int id) const;
+
+    // 按名称访问：添加数据库中还没有的名称时分配临时ID，保存文章时换成正式ID
     QStringList categories() const;
     void setCategories(const QStringList& categories);
     void addCategory(const QString& category);
@@ -54,23 +105,18 @@ public:
     void addTag(const QString& tag);
     void removeTag(const QString& tag);
 
-    QString featuredImageUrl() const;
-    void setFeaturedImageUrl(const QString& url);
+    const QString& featuredImageUrl() const;
+    void setFeaturedImageUrl(QString url);
 
     void setFeatureMediaId(int id);
     int featureMediaId() const;
 
+    // 文章列表中的显示文本：标题 (日期)，标题过长时截断
+    QString displayText() const;
+
 private:
-    int m_id;           // 本地数据库ID
-    int m_remoteId;     // WordPress远程ID
-    int m_featureMediaId = -1;//特色图片ID
-    QString m_title;
-    QString m_content;
-    QString m_excerpt;
-    QDateTime m_publishDate;
-    QString m_author;
-    Status m_status;
-    QStringList m_categories;
-    QStringList m_tags;
-    QString m_featuredImageUrl;
-}; 
\ No newline at end of file
+    QSharedDataPointer<PostData> d;
+};
+
+Q_DECLARE_SHARED(Post)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Post::Fields)
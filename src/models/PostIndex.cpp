@@ -0,0 +1,55 @@
+#include "PostIndex.h"
+#include <algorithm>
+
+namespace PostIndex {
+
+namespace {
+
+void sortByRemoteId(QList<Stamp>& stamps)
+{
+    std::sort(stamps.begin(), stamps.end(), [](const Stamp& a, const Stamp& b) {
+        return a.remoteId < b.remoteId;
+    });
+}
+
+}
+
+Diff compare(QList<Stamp> remote, QList<Stamp> local)
+{
+    // 服务器按ID升序返回时已经有序，排序只是保证归并的前提
+    sortByRemoteId(remote);
+    sortByRemoteId(local);
+
+    Diff diff;
+    int r = 0;
+    int l = 0;
+    while (r < remote.size() || l < local.size()) {
+        if (l == local.size() || (r < remote.size() && remote.at(r).remoteId < local.at(l).remoteId)) {
+            diff.added.append(remote.at(r).remoteId);
+            ++r;
+        } else if (r == remote.size() || local.at(l).remoteId < remote.at(r).remoteId) {
+            diff.deleted.append(local.at(l));
+            ++l;
+        } else {
+            // 没有记录修改时间的旧数据也算作有更新
+            const Stamp& remoteStamp = remote.at(r);
+            if (local.at(l).modified.isEmpty() || local.at(l).modified != remoteStamp.modified) {
+                diff.changed.append(remoteStamp.remoteId);
+            } else {
+                ++diff.unchanged;
+            }
+            // 同一远程ID对应多篇本地文章或分页时重复返回的条目，只比较一次
+            while (r < remote.size() && remote.at(r).remoteId == remoteStamp.remoteId) {
+                ++r;
+            }
+            int remoteId = local.at(l).remoteId;
+            while (l < local.size() && local.at(l).remoteId == remoteId) {
+                ++l;
+            }
+        }
+    }
+
+    return diff;
+}
+
+}
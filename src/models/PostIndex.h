@@ -0,0 +1,28 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+
+// 远程文章列表与本地文章的对比
+// 两边都只有远程ID和修改时间：远程来自WordPressAPI::fetchPostIndex()，本地来自
+// DatabaseManager::getPostStamps()。两边按远程ID排序后一次归并，不需要读取任何正文。
+namespace PostIndex {
+
+struct Stamp
+{
+    int remoteId = -1;
+    QString modified;   // modified_gmt，本地没有记录时为空
+    int localId = -1;   // 本地文章ID（只有本地一侧有）
+};
+
+struct Diff
+{
+    QList<int> added;       // 只在远程存在的文章（远程ID）
+    QList<int> changed;     // 两边都有但修改时间不同的文章（远程ID）
+    QList<Stamp> deleted;   // 远程已经不存在的本地文章
+    int unchanged = 0;
+};
+
+Diff compare(QList<Stamp> remote, QList<Stamp> local);
+
+}
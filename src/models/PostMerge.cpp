@@ -0,0 +1,215 @@
+#include "PostMerge.h"
+#include "PostSchema.h"
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace PostMerge {
+
+namespace {
+
+// 超过这个编辑距离时不再对齐中间部分，整段视为修改（只会让合并更保守）
+const int MaxEditDistance = 2000;
+
+// base的每一行在other中对应的行号，没有对应时为-1
+// 先去掉公共的开头和结尾，中间部分用Myers算法求最长公共子序列
+QVector<int> matchLines(const QStringList& base, const QStringList& other)
+{
+    const int n = base.size();
+    const int m = other.size();
+    QVector<int> match(n, -1);
+
+    int prefix = 0;
+    while (prefix < n && prefix < m && base.at(prefix) == other.at(prefix)) {
+        match[prefix] = prefix;
+        ++prefix;
+    }
+    int suffix = 0;
+    while (suffix < n - prefix && suffix < m - prefix && base.at(n - 1 - suffix) == other.at(m - 1 - suffix)) {
+        match[n - 1 - suffix] = m - 1 - suffix;
+        ++suffix;
+    }
+
+    const int a0 = prefix;
+    const int b0 = prefix;
+    const int lengthA = n - prefix - suffix;
+    const int lengthB = m - prefix - suffix;
+    if (lengthA == 0 || lengthB == 0) {
+        return match;
+    }
+
+    // v[k]：对角线k上当前能到达的最远x；trace[d]保存第d轮结束时对角线-d..d的值，用于回溯
+    const int maxD = std::min(lengthA + lengthB, MaxEditDistance);
+    const int offset = maxD + 1;
+    std::vector<int> v(2 * maxD + 3, 0);
+    std::vector<std::vector<int>> trace;
+    int found = -1;
+    for (int d = 0; d <= maxD && found < 0; ++d) {
+        for (int k = -d; k <= d; k += 2) {
+            int x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ? v[offset + k + 1]
+                                                                                  : v[offset + k - 1] + 1;
+            int y = x - k;
+            while (x < lengthA && y < lengthB && base.at(a0 + x) == other.at(b0 + y)) {
+                ++x;
+                ++y;
+            }
+            v[offset + k] = x;
+            if (x >= lengthA && y >= lengthB) {
+                found = d;
+                break;
+            }
+        }
+        trace.emplace_back(v.begin() + offset - d, v.begin() + offset + d + 1);
+    }
+    if (found < 0) {
+        return match;
+    }
+
+    int x = lengthA;
+    int y = lengthB;
+    for (int d = found; d > 0; --d) {
+        const std::vector<int>& previous = trace[d - 1];
+        auto previousX = [&](int k) { return previous[k + d - 1]; };
+        int k = x - y;
+        int previousK = (k == -d || (k != d && previousX(k - 1) < previousX(k + 1))) ? k + 1 : k - 1;
+        int startX = previousX(previousK);
+        int startY = startX - previousK;
+        while (x > startX && y > startY) {
+            --x;
+            --y;
+            match[a0 + x] = b0 + y;
+        }
+        x = startX;
+        y = startY;
+    }
+    while (x > 0 && y > 0) {
+        --x;
+        --y;
+        match[a0 + x] = b0 + y;
+    }
+    return match;
+}
+
+template <typename T>
+bool mergeValue(const T& base, const T& local, const T& remote, T* merged)
+{
+    if (local == base || local == remote) {
+        *merged = remote;
+        return true;
+    }
+    if (remote == base) {
+        *merged = local;
+        return true;
+    }
+    return false;
+}
+
+}
+
+TextResult mergeText(const QString& base, const QString& local, const QString& remote)
+{
+    TextResult result;
+    if (mergeValue(base, local, remote, &result.text)) {
+        return result;
+    }
+
+    const QStringList baseLines = base.split(QLatin1Char('\n'));
+    const QStringList localLines = local.split(QLatin1Char('\n'));
+    const QStringList remoteLines = remote.split(QLatin1Char('\n'));
+    const QVector<int> localMatch = matchLines(baseLines, localLines);
+    const QVector<int> remoteMatch = matchLines(baseLines, remoteLines);
+
+    QStringList merged;
+    int baseStart = 0;
+    int localStart = 0;
+    int remoteStart = 0;
+    auto mergeChunk = [&](int baseEnd, int localEnd, int remoteEnd) {
+        const QStringList baseChunk = baseLines.mid(baseStart, baseEnd - baseStart);
+        const QStringList localChunk = localLines.mid(localStart, localEnd - localStart);
+        const QStringList remoteChunk = remoteLines.mid(remoteStart, remoteEnd - remoteStart);
+        QStringList chunk;
+        if (mergeValue(baseChunk, localChunk, remoteChunk, &chunk)) {
+            merged += chunk;
+        } else {
+            result.clean = false;
+        }
+    };
+
+    for (int i = 0; i < baseLines.size() && result.clean; ++i) {
+        if (localMatch.at(i) < 0 || remoteMatch.at(i) < 0) {
+            continue;
+        }
+        // 两方都保留了这一行，之前的部分作为一块合并
+        mergeChunk(i, localMatch.at(i), remoteMatch.at(i));
+        merged += baseLines.at(i);
+        baseStart = i + 1;
+        localStart = localMatch.at(i) + 1;
+        remoteStart = remoteMatch.at(i) + 1;
+    }
+    if (result.clean) {
+        mergeChunk(baseLines.size(), localLines.size(), remoteLines.size());
+    }
+
+    result.text = result.clean ? merged.join(QLatin1Char('\n')) : local;
+    return result;
+}
+
+TermIds mergeTerms(const TermIds& base, const TermIds& local, const TermIds& remote)
+{
+    TermIds all = base;
+    all.append(local.constData(), local.size());
+    all.append(remote.constData(), remote.size());
+    TermTable::normalize(all);
+
+    TermIds merged;
+    for (int id : all) {
+        bool inBase = TermTable::containsId(base, id);
+        bool inLocal = TermTable::containsId(local, id);
+        bool inRemote = TermTable::containsId(remote, id);
+        bool inMerged = false;
+        if (mergeValue(inBase, inLocal, inRemote, &inMerged) && inMerged) {
+            merged.append(id);
+        }
+    }
+    return merged;
+}
+
+Result merge(const Post& base, const Post& local, const Post& remote)
+{
+    Result result;
+    result.merged = remote;
+    result.merged.setId(local.id());
+
+    PostSchema::forEach(PostSchema::EditableColumns(), [&](auto field) {
+        using F = decltype(field);
+        using Type = typename F::Type;
+        if constexpr (std::is_same_v<Type, QString>) {
+            // 正文和摘要按行合并，标题等单行字段整体比较
+            if (F::flag == Post::ContentField || F::flag == Post::ExcerptField) {
+                TextResult text = mergeText(F::get(base), F::get(local), F::get(remote));
+                if (text.clean) {
+                    F::set(result.merged, text.text);
+                } else {
+                    result.conflicts |= Post::Field(F::flag);
+                }
+                return;
+            }
+        }
+        Type value{};
+        if (mergeValue<Type>(F::get(base), F::get(local), F::get(remote), &value)) {
+            F::set(result.merged, value);
+        } else {
+            result.conflicts |= Post::Field(F::flag);
+        }
+    });
+
+    result.merged.setCategoryIds(mergeTerms(base.categoryIds(), local.categoryIds(), remote.categoryIds()));
+    result.merged.setTagIds(mergeTerms(base.tagIds(), local.tagIds(), remote.tagIds()));
+
+    result.localChanges = PostSchema::diff(result.merged, remote);
+    return result;
+}
+
+}
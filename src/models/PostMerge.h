@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QString>
+
+#include "Post.h"
+#include "TermTable.h"
+
+// 同一篇文章在本地和远程都修改过时的三方合并
+// base是上次同步时的版本。每个字段只有一方修改过时取修改的一方；两方改成同样的值时取这个值；
+// 两方改得不同时，正文和摘要按行合并（修改的行不重叠时可以自动合并），其他字段记为冲突。
+// 分类和标签按集合合并，不会冲突。只依赖QtCore，可以在任意线程中调用。
+namespace PostMerge {
+
+struct TextResult
+{
+    QString text;       // 合并结果；有冲突时为local
+    bool clean = true;
+};
+
+// 行级三方合并（diff3）：base与两方分别按最长公共子序列对齐，两方都保留的行把文本分成若干块，
+// 每块只有一方修改时取修改的一方，两方改得相同时取其一，否则冲突
+TextResult mergeText(const QString& base, const QString& local, const QString& remote);
+
+// 集合的三方合并：每个ID取修改过它的一方的状态
+TermIds mergeTerms(const TermIds& base, const TermIds& local, const TermIds& remote);
+
+struct Result
+{
+    // 以remote为基础（远程ID、修改时间等只读信息来自远程），应用本地的修改
+    Post merged;
+    // 无法自动合并的字段；不为空时merged没有意义
+    Post::Fields conflicts;
+    // merged与remote不同的字段，也就是合并后还需要推送到远程的本地修改
+    Post::Fields localChanges;
+};
+
+// 三篇文章都需要已经加载正文
+Result merge(const Post& base, const Post& local, const Post& remote);
+
+}
@@ -0,0 +1,437 @@
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLatin1String>
+#include <QString>
+#include <type_traits>
+#include <utility>
+
+#include "Post.h"
+#include "StringPool.h"
+
+// Post字段的编译期描述表
+// 每个字段一个描述类型：读写Post的方式、数据库列名、WordPress REST中的键和格式、对应的Post::Field。
+// 数据库的列清单、语句绑定和行解码（database/PostColumns.h）、REST请求体和响应解析、字段级差异
+// 都按这张表在编译期展开，不再各自手写一份字段映射；增加字段时只需要在这里登记。
+namespace PostSchema {
+
+// 字段在REST JSON中的格式
+enum class Json {
+    None,       // 不出现在REST中
+    Value,      // 字符串或数值本身
+    Rendered,   // 读取{"rendered": ...}，写入{"raw": ...}
+    Embedded    // 只读，来自_embed：_embedded[jsonKey][0][embeddedKey]
+};
+
+// REST中的读写方向
+enum JsonAccess {
+    NoAccess = 0,
+    JsonRead = 0x1,     // 从响应中解析
+    JsonWrite = 0x2     // 写入创建/更新请求
+};
+
+// 各字段的默认属性，描述类型中只需写出不同的部分
+struct FieldBase
+{
+    static constexpr int flag = 0;                  // 对应的Post::Field，0表示不是可编辑字段
+    static constexpr const char* column = nullptr;  // posts表中的列
+    static constexpr const char* jsonKey = nullptr;
+    static constexpr const char* embeddedKey = nullptr;  // Json::Embedded：关联对象中的键
+    static constexpr Json json = Json::None;
+    static constexpr int access = NoAccess;
+    static constexpr bool compressible = false;     // 数据库中可以保存为压缩BLOB
+};
+
+struct Title : FieldBase
+{
+    using Type = QString;
+    static constexpr int flag = Post::TitleField;
+    static constexpr const char* column = "title";
+    static constexpr const char* jsonKey = "title";
+    static constexpr Json json = Json::Rendered;
+    static constexpr int access = JsonRead | JsonWrite;
+    static const QString& get(const Post& post) { return post.title(); }
+    static void set(Post& post, QString value) { post.setTitle(std::move(value)); }
+};
+
+struct Content : FieldBase
+{
+    using Type = QString;
+    static constexpr int flag = Post::ContentField;
+    static constexpr const char* column = "content";
+    static constexpr const char* jsonKey = "content";
+    static constexpr Json json = Json::Rendered;
+    static constexpr int access = JsonRead | JsonWrite;
+    static constexpr bool compressible = true;
+    static const QString& get(const Post& post) { return post.content(); }
+    static void set(Post& post, QString value) { post.setContent(std::move(value)); }
+};
+
+struct Excerpt : FieldBase
+{
+    using Type = QString;
+    static constexpr int flag = Post::ExcerptField;
+    static constexpr const char* column = "excerpt";
+    static constexpr const char* jsonKey = "excerpt";
+    static constexpr Json json = Json::Rendered;
+    static constexpr int access = JsonRead | JsonWrite;
+    static const QString& get(const Post& post) { return post.excerpt(); }
+    static void set(Post& post, QString value) { post.setExcerpt(std::move(value)); }
+};
+
+struct PublishDate : FieldBase
+{
+    using Type = QDateTime;
+    static constexpr int flag = Post::PublishDateField;
+    static constexpr const char* column = "publish_date";
+    static constexpr const char* jsonKey = "date";
+    static constexpr Json json = Json::Value;
+    static constexpr int access = JsonRead;
+    static const QDateTime& get(const Post& post) { return post.publishDate(); }
+    static void set(Post& post, QDateTime value) { post.setPublishDate(std::move(value)); }
+};
+
+struct Author : FieldBase
+{
+    using Type = QString;
+    static constexpr int flag = Post::AuthorField;
+    static constexpr const char* column = "author";
+    // 文章对象中的author是用户ID，作者名来自嵌入的用户对象
+    static constexpr const char* jsonKey = "author";
+    static constexpr const char* embeddedKey = "name";
+    static constexpr Json json = Json::Embedded;
+    static constexpr int access = JsonRead;
+    static const QString& get(const Post& post) { return post.author(); }
+    // 同一作者的文章共用一份作者名
+    static void set(Post& post, QString value) { post.setAuthor(StringPool::instance().intern(value)); }
+};
+
+struct Status : FieldBase
+{
+    using Type = Post::Status;
+    static constexpr int flag = Post::StatusField;
+    static constexpr const char* column = "status";
+    static constexpr const char* jsonKey = "status";
+    static constexpr Json json = Json::Value;
+    static constexpr int access = JsonRead | JsonWrite;
+    static Post::Status get(const Post& post) { return post.status(); }
+    static void set(Post& post, Post::Status value) { post.setStatus(value); }
+};
+
+struct FeaturedImageUrl : FieldBase
+{
+    using Type = QString;
+    static constexpr int flag = Post::FeaturedImageField;
+    static constexpr const char* column = "featured_image_url";
+    // 文章对象中只有featured_media（媒体ID），地址来自嵌入的媒体对象
+    static constexpr const char* jsonKey = "wp:featuredmedia";
+    static constexpr const char* embeddedKey = "source_url";
+    static constexpr Json json = Json::Embedded;
+    static constexpr int access = JsonRead;
+    static const QString& get(const Post& post) { return post.featuredImageUrl(); }
+    static void set(Post& post, QString value) { post.setFeaturedImageUrl(std::move(value)); }
+};
+
+// 特色图片的媒体ID：只在内存中使用（发布时作为featured_media发送），不保存在posts表中
+struct FeaturedMediaId : FieldBase
+{
+    using Type = int;
+    static constexpr const char* jsonKey = "featured_media";
+    static constexpr Json json = Json::Value;
+    static constexpr int access = JsonRead;
+    static int get(const Post& post) { return post.featureMediaId(); }
+    static void set(Post& post, int value) { post.setFeatureMediaId(value > 0 ? value : -1); }
+};
+
+// 远程ID：本地保存在remote_id列，REST中是文章的id
+struct RemoteId : FieldBase
+{
+    using Type = int;
+    static constexpr const char* column = "remote_id";
+    static constexpr const char* jsonKey = "id";
+    static constexpr Json json = Json::Value;
+    static constexpr int access = JsonRead;
+    static int get(const Post& post) { return post.remoteId(); }
+    static void set(Post& post, int value) { post.setRemoteId(value); }
+};
+
+// 服务器上的修改时间：对比远程文章列表时判断哪些文章有更新
+struct RemoteModified : FieldBase
+{
+    using Type = QString;
+    static constexpr const char* column = "remote_modified";
+    static constexpr const char* jsonKey = "modified_gmt";
+    static constexpr Json json = Json::Value;
+    static constexpr int access = JsonRead;
+    static const QString& get(const Post& post) { return post.remoteModified(); }
+    static void set(Post& post, QString value) { post.setRemoteModified(std::move(value)); }
+};
+
+// 字段列表（顺序即数据库语句中列的顺序）
+template <typename... F>
+struct List
+{
+    static constexpr int size = int(sizeof...(F));
+};
+
+// posts表中除本地ID以外的全部列
+using Columns = List<Title, Content, Excerpt, PublishDate, Author, Status, FeaturedImageUrl, RemoteId, RemoteModified>;
+// 文章列表使用的列（不含正文）
+using SummaryColumns = List<Title, Excerpt, PublishDate, Author, Status, FeaturedImageUrl, RemoteId, RemoteModified>;
+// 可编辑的字段（都有对应的Post::Field）
+using EditableColumns = List<Title, Content, Excerpt, PublishDate, Author, Status, FeaturedImageUrl>;
+// 出现在REST中的字段
+using JsonFields = List<Title, Content, Excerpt, PublishDate, Author, Status, FeaturedImageUrl, FeaturedMediaId, RemoteId,
+                        RemoteModified>;
+
+// 对列表中的每个字段调用fn(F())，在编译期展开
+template <typename... F, typename Fn>
+void forEach(List<F...>, Fn&& fn)
+{
+    (fn(F()), ...);
+}
+
+// 字段值与JSON值之间的转换
+template <typename T>
+struct JsonCodec;
+
+template <>
+struct JsonCodec<QString>
+{
+    static QJsonValue toJson(const QString& value) { return value; }
+    static QString fromJson(const QJsonValue& value) { return value.toString(); }
+};
+
+template <>
+struct JsonCodec<int>
+{
+    static QJsonValue toJson(int value) { return value; }
+    static int fromJson(const QJsonValue& value) { return value.toInt(); }
+};
+
+template <>
+struct JsonCodec<QDateTime>
+{
+    static QJsonValue toJson(const QDateTime& value) { return value.toString(Qt::ISODate); }
+    static QDateTime fromJson(const QJsonValue& value) { return QDateTime::fromString(value.toString(), Qt::ISODate); }
+};
+
+template <>
+struct JsonCodec<Post::Status>
+{
+    static QJsonValue toJson(Post::Status value) { return value == Post::Published ? "publish" : "draft"; }
+    static Post::Status fromJson(const QJsonValue& value) { return value.toString() == "publish" ? Post::Published : Post::Draft; }
+};
+
+// 解码一个字段的JSON值（Rendered格式的字段传入的是其中rendered的值）
+template <typename F>
+void setFromJson(Post& post, const QJsonValue& value)
+{
+    F::set(post, JsonCodec<typename F::Type>::fromJson(value));
+}
+
+// 把fields中可以写入REST的字段写入请求体
+inline void writeJson(const Post& post, QJsonObject& object, Post::Fields fields = Post::AllFields)
+{
+    forEach(JsonFields(), [&](auto field) {
+        using F = decltype(field);
+        if constexpr ((F::access & JsonWrite) != 0) {
+            if (fields & Post::Field(F::flag)) {
+                QJsonValue value = JsonCodec<typename F::Type>::toJson(F::get(post));
+                if constexpr (F::json == Json::Rendered) {
+                    object.insert(QLatin1String(F::jsonKey), QJsonObject{{"raw", value}});
+                } else {
+                    object.insert(QLatin1String(F::jsonKey), value);
+                }
+            }
+        }
+    });
+}
+
+// 字符串按UTF-8编码的字节数，不生成编码后的副本
+inline qint64 utf8Size(const QString& value)
+{
+    qint64 size = 0;
+    for (QChar ch : value) {
+        ushort code = ch.unicode();
+        // 代理对的两半各算2字节，合起来是4字节
+        size += code < 0x80 ? 1 : (code < 0x800 || ch.isSurrogate()) ? 2 : 3;
+    }
+    return size;
+}
+
+// writeJson()写入fields时请求体的大致字节数（不计转义），只用于统计，不需要序列化文章
+inline qint64 jsonSize(const Post& post, Post::Fields fields = Post::AllFields)
+{
+    qint64 size = 0;
+    forEach(JsonFields(), [&](auto field) {
+        using F = decltype(field);
+        if constexpr ((F::access & JsonWrite) != 0) {
+            if (fields & Post::Field(F::flag)) {
+                // "key":值, 以及Rendered字段的{"raw":}
+                size += qint64(qstrlen(F::jsonKey)) + 4 + (F::json == Json::Rendered ? 8 : 0);
+                if constexpr (std::is_same_v<typename F::Type, QString>) {
+                    size += utf8Size(F::get(post)) + 2;
+                } else {
+                    QJsonValue value = JsonCodec<typename F::Type>::toJson(F::get(post));
+                    size += value.isString() ? utf8Size(value.toString()) + 2
+                                             : QByteArray::number(value.toDouble()).size();
+                }
+            }
+        }
+    });
+    return size;
+}
+
+// 获取文章时_embed参数的值：Embedded字段用到的关联，例如"author,wp:featuredmedia"
+inline QString embedRelations()
+{
+    QString relations;
+    forEach(JsonFields(), [&](auto field) {
+        using F = decltype(field);
+        if constexpr (F::json == Json::Embedded) {
+            if (!relations.isEmpty()) {
+                relations += QLatin1Char(',');
+            }
+            relations += QLatin1String(F::jsonKey);
+        }
+    });
+    return relations;
+}
+
+// 从REST响应的文章对象中读取字段，响应中没有的字段保持不变
+inline void readJson(Post& post, const QJsonObject& object)
+{
+    const QJsonObject embedded = object.value(QLatin1String("_embedded")).toObject();
+    forEach(JsonFields(), [&](auto field) {
+        using F = decltype(field);
+        if constexpr (F::json == Json::Embedded) {
+            // 关联对象无法访问时（例如没有权限）WordPress嵌入的是错误对象，其中没有对应的键
+            const QJsonArray items = embedded.value(QLatin1String(F::jsonKey)).toArray();
+            const QJsonObject related = items.isEmpty() ? QJsonObject() : items.first().toObject();
+            auto it = related.constFind(QLatin1String(F::embeddedKey));
+            if (it != related.constEnd()) {
+                setFromJson<F>(post, it.value());
+            }
+        } else if constexpr ((F::access & JsonRead) != 0) {
+            auto it = object.constFind(QLatin1String(F::jsonKey));
+            if (it == object.constEnd()) {
+                return;
+            }
+            if constexpr (F::json == Json::Rendered) {
+                setFromJson<F>(post, it.value().toObject().value(QLatin1String("rendered")));
+            } else {
+                setFromJson<F>(post, it.value());
+            }
+        }
+    });
+}
+
+// 两篇文章之间有差异的字段（任一方没有加载正文时不比较正文）
+inline Post::Fields diff(const Post& a, const Post& b)
+{
+    Post::Fields changed;
+    forEach(EditableColumns(), [&](auto field) {
+        using F = decltype(field);
+        if (F::flag == Post::ContentField && (!a.isContentLoaded() || !b.isContentLoaded())) {
+            return;
+        }
+        if (!(F::get(a) == F::get(b))) {
+            changed |= Post::Field(F::flag);
+        }
+    });
+
+    if (a.categoryIds() != b.categoryIds() || a.tagIds() != b.tagIds()) {
+        changed |= Post::TermsField;
+    }
+    return changed;
+}
+
+// 上次同步时各字段的摘要（Post::Field -> 64位哈希）
+// 判断一个字段是否修改过只比较摘要，不需要读取已同步的副本；三方合并用的完整副本另存在post_sync_base表中
+using FieldHashes = QHash<int, quint64>;
+
+// FNV-1a：结果在不同进程和Qt版本之间保持不变，可以保存在数据库中
+inline quint64 hashBytes(const void* data, int size, quint64 hash)
+{
+    const uchar* bytes = static_cast<const uchar*>(data);
+    for (int i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+const quint64 HashSeed = 14695981039346656037ULL;
+
+// 先计入长度，多个值连续计算时不会因为边界不同而得到相同的结果
+inline quint64 hashValue(const QString& value, quint64 hash = HashSeed)
+{
+    int size = value.size();
+    hash = hashBytes(&size, int(sizeof(size)), hash);
+    return hashBytes(value.constData(), int(size * sizeof(QChar)), hash);
+}
+
+template <typename T>
+quint64 hashValue(const T& value, quint64 hash = HashSeed)
+{
+    // 按JSON形式计算，例如状态是"publish"/"draft"
+    return hashValue(JsonCodec<T>::toJson(value).toVariant().toString(), hash);
+}
+
+inline quint64 hashTerms(const Post& post)
+{
+    // 分类和标签同属一个Post::TermsField，两组ID之间用数量分隔
+    int categoryCount = post.categoryIds().size();
+    quint64 hash = hashBytes(&categoryCount, int(sizeof(categoryCount)), HashSeed);
+    hash = hashBytes(post.categoryIds().constData(), int(categoryCount * sizeof(int)), hash);
+    return hashBytes(post.tagIds().constData(), int(post.tagIds().size() * sizeof(int)), hash);
+}
+
+// posts表中一行（全部列）的摘要；调用方需要保证已经加载正文
+inline quint64 hashRow(const Post& post)
+{
+    quint64 hash = HashSeed;
+    forEach(Columns(), [&](auto field) {
+        using F = decltype(field);
+        hash = hashValue(F::get(post), hash);
+    });
+    return hash;
+}
+
+// 可以写入REST的字段以及分类/标签的摘要；没有加载正文时不包含正文
+inline FieldHashes hashFields(const Post& post)
+{
+    FieldHashes hashes;
+    forEach(JsonFields(), [&](auto field) {
+        using F = decltype(field);
+        if constexpr ((F::access & JsonWrite) != 0) {
+            if (F::flag == Post::ContentField && !post.isContentLoaded()) {
+                return;
+            }
+            hashes.insert(F::flag, hashValue(F::get(post)));
+        }
+    });
+    hashes.insert(Post::TermsField, hashTerms(post));
+    return hashes;
+}
+
+// 与上次同步时的摘要相比修改过的字段；没有摘要的字段（包括从未同步过的文章）视为已修改
+// 没有加载正文时无法比较，也不会发送正文
+inline Post::Fields changedSince(const FieldHashes& synced, const Post& post)
+{
+    Post::Fields changed;
+    const FieldHashes current = hashFields(post);
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        auto syncedHash = synced.constFind(it.key());
+        if (syncedHash == synced.constEnd() || syncedHash.value() != it.value()) {
+            changed |= Post::Field(it.key());
+        }
+    }
+    return changed;
+}
+
+}
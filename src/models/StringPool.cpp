@@ -0,0 +1,58 @@
+#include "StringPool.h"
+#include <QMutexLocker>
+
+StringPool& StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+QString StringPool::intern(const QString& value)
+{
+    // 空字符串本来就共享同一个空缓冲区
+    if (value.isEmpty()) {
+        return value;
+    }
+
+    qint64 bytes = qint64(value.size()) * qint64(sizeof(QChar));
+
+    QMutexLocker locker(&m_mutex);
+    ++m_stats.lookups;
+
+    auto it = m_strings.constFind(value);
+    if (it != m_strings.constEnd()) {
+        ++m_stats.hits;
+        // 传入的已经是池内字符串时没有节省
+        if (it->constData() != value.constData()) {
+            m_stats.bytesSaved += bytes;
+        }
+        return *it;
+    }
+
+    m_strings.insert(value);
+    m_stats.bytesStored += bytes;
+    return value;
+}
+
+StringPool::Stats StringPool::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.strings = m_strings.size();
+    return stats;
+}
+
+void StringPool::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    qint64 bytesStored = m_stats.bytesStored;
+    m_stats = Stats();
+    m_stats.bytesStored = bytesStored;
+}
+
+void StringPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_strings.clear();
+    m_stats = Stats();
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+// 字符串驻留池：相同内容的字符串共用一份缓冲区（QString的隐式共享）
+// 数据库加载和JSON解析时，作者、分类和标签名称这类重复度很高的字段先经过这里，
+// 上万篇文章的同一个作者名只占一份内存。池中的字符串不会释放，
+// 所以只用于取值范围有限的字段，不要用于标题、正文等。
+class StringPool
+{
+public:
+    struct Stats
+    {
+        int strings = 0;            // 池中不同字符串的数量
+        qint64 lookups = 0;         // intern()调用次数
+        qint64 hits = 0;            // 命中已有字符串的次数
+        qint64 bytesStored = 0;     // 池中字符串占用的字符字节数
+        qint64 bytesSaved = 0;      // 命中时少分配的字符字节数
+    };
+
+    static StringPool& instance();
+
+    // 返回与value内容相同的池内字符串
+    QString intern(const QString& value);
+
+    Stats stats() const;
+    // 只清零计数，池中的字符串保留
+    void resetStats();
+    void clear();
+
+private:
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    mutable QMutex m_mutex;
+    QSet<QString> m_strings;
+    Stats m_stats;
+};
@@ -0,0 +1,147 @@
+#include "TermTable.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+
+TermTable& TermTable::categories()
+{
+    static TermTable table;
+    return table;
+}
+
+TermTable& TermTable::tags()
+{
+    static TermTable table;
+    return table;
+}
+
+QString TermTable::name(int id) const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.value(id);
+}
+
+int TermTable::id(const QString& name) const
+{
+    QReadLocker locker(&m_lock);
+    return m_ids.value(name, 0);
+}
+
+bool TermTable::contains(int id) const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.contains(id);
+}
+
+int TermTable::intern(const QString& name)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_ids.constFind(name);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    int id = m_nextProvisionalId--;
+    m_names.insert(id, name);
+    m_ids.insert(name, id);
+    return id;
+}
+
+void TermTable::insert(int id, const QString& name)
+{
+    QWriteLocker locker(&m_lock);
+
+    // 改名时去掉旧名称的映射
+    auto oldName = m_names.constFind(id);
+    if (oldName != m_names.constEnd() && oldName.value() != name) {
+        m_ids.remove(oldName.value());
+    }
+
+    // 同名的临时词条已经保存到数据库，记录解析关系
+    // 临时ID的名称保留下来，还持有临时ID的文章副本仍然可以正常显示
+    auto existing = m_ids.constFind(name);
+    if (existing != m_ids.constEnd() && existing.value() != id && isProvisional(existing.value())) {
+        m_resolved.insert(existing.value(), id);
+    }
+
+    m_names.insert(id, name);
+    m_ids.insert(name, id);
+}
+
+void TermTable::remove(int id)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_names.find(id);
+    if (it == m_names.end()) {
+        return;
+    }
+    if (m_ids.value(it.value()) == id) {
+        m_ids.remove(it.value());
+    }
+    m_names.erase(it);
+}
+
+void TermTable::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_names.clear();
+    m_ids.clear();
+    m_resolved.clear();
+}
+
+int TermTable::resolved(int provisionalId) const
+{
+    QReadLocker locker(&m_lock);
+    return m_resolved.value(provisionalId, 0);
+}
+
+QStringList TermTable::names(const TermIds& ids) const
+{
+    QReadLocker locker(&m_lock);
+    QStringList result;
+    result.reserve(ids.size());
+    for (int id : ids) {
+        auto it = m_names.constFind(id);
+        if (it != m_names.constEnd()) {
+            result.append(it.value());
+        }
+    }
+    return result;
+}
+
+int TermTable::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_names.size();
+}
+
+void TermTable::normalize(TermIds& ids)
+{
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+bool TermTable::insertId(TermIds& ids, int id)
+{
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it != ids.end() && *it == id) {
+        return false;
+    }
+    ids.insert(it, id);
+    return true;
+}
+
+bool TermTable::removeId(TermIds& ids, int id)
+{
+    auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id) {
+        return false;
+    }
+    ids.erase(it);
+    return true;
+}
+
+bool TermTable::containsId(const TermIds& ids, int id)
+{
+    return std::binary_search(ids.begin(), ids.end(), id);
+}
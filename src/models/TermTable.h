@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QStringList>
+#include <QVarLengthArray>
+
+// 文章的分类或标签ID集合，保持升序且无重复
+// 绝大多数文章只有几个分类和十几个以内的标签，8个以内不需要堆分配
+using TermIds = QVarLengthArray<int, 8>;
+
+// 分类或标签的ID与名称对照表（每种分类法一张，进程内共享）
+// 文章只保存ID，显示和按名称查找时通过这张表解析，同一个名称在内存中只保存一份。
+// 正数ID与数据库（也就是WordPress）中的ID一致；按名称添加、数据库中还没有的词条
+// 先分配一个负数的临时ID，保存文章时由DatabaseManager写入数据库并换成正式ID。
+class TermTable
+{
+public:
+    static TermTable& categories();
+    static TermTable& tags();
+
+    // 按ID查名称，未知ID返回空字符串
+    QString name(int id) const;
+    // 按名称查ID，未知名称返回0
+    int id(const QString& name) const;
+    bool contains(int id) const;
+
+    // 返回名称对应的ID，名称未知时分配一个临时ID
+    int intern(const QString& name);
+    // 登记一个已保存到数据库的词条；同名的临时ID随后会解析为这个ID
+    void insert(int id, const QString& name);
+    void remove(int id);
+    void clear();
+
+    // 临时ID对应的正式ID，尚未保存时返回0
+    int resolved(int provisionalId) const;
+    static bool isProvisional(int id) { return id < 0; }
+
+    // 把ID集合转换成名称列表（顺序与ID相同）
+    QStringList names(const TermIds& ids) const;
+    int size() const;
+
+    // ID集合的辅助函数
+    static void normalize(TermIds& ids);
+    static bool insertId(TermIds& ids, int id);
+    static bool removeId(TermIds& ids, int id);
+    static bool containsId(const TermIds& ids, int id);
+
+private:
+    TermTable() = default;
+    TermTable(const TermTable&) = delete;
+    TermTable& operator=(const TermTable&) = delete;
+
+    mutable QReadWriteLock m_lock;
+    QHash<int, QString> m_names;
+    QHash<QString, int> m_ids;
+    QHash<int, int> m_resolved;     // 临时ID -> 正式ID
+    int m_nextProvisionalId = -1;
+};
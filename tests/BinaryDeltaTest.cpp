@@ -0,0 +1,135 @@
+#include <QRandomGenerator>
+#include <QTest>
+#include <iterator>
+
+#include "database/BinaryDelta.h"
+
+// 修订历史依赖差异还原的正确性：还原结果必须与原文逐字节相同，损坏的差异必须被拒绝或安全地失败
+class BinaryDeltaTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void randomEdits();
+    void corruptDelta();
+    void wrongBase();
+};
+
+namespace {
+
+// 确定性的多行正文，重复的行使基准中有大量相同的块
+QByteArray makeText(QRandomGenerator& random, int lines)
+{
+    static const char* const words[] = {"文章", "修订", "同步", "WordPress", "the", "quick", "brown", "fox", "\t", "<p>"};
+    QByteArray text;
+    for (int i = 0; i < lines; ++i) {
+        int count = 3 + random.bounded(12);
+        for (int w = 0; w < count; ++w) {
+            text += words[random.bounded(int(std::size(words)))];
+            text += ' ';
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+// 1-5处随机插入、删除或替换
+QByteArray edit(QRandomGenerator& random, QByteArray target)
+{
+    int changes = 1 + random.bounded(5);
+    for (int c = 0; c < changes; ++c) {
+        int pos = random.bounded(int(target.size()) + 1);
+        int length = qMin(random.bounded(200), int(target.size()) - pos);
+        QByteArray text = makeText(random, 1 + random.bounded(3));
+        switch (random.bounded(3)) {
+        case 0:
+            target.insert(pos, text);
+            break;
+        case 1:
+            target.remove(pos, length);
+            break;
+        default:
+            target.replace(pos, length, text);
+            break;
+        }
+    }
+    return target;
+}
+
+}
+
+void BinaryDeltaTest::roundTrip_data()
+{
+    QTest::addColumn<QByteArray>("base");
+    QTest::addColumn<QByteArray>("target");
+
+    QByteArray text = "第一段\n第二段 with some ASCII\n第三段\n";
+    QTest::newRow("empty") << QByteArray() << QByteArray();
+    QTest::newRow("from empty") << QByteArray() << text;
+    QTest::newRow("to empty") << text << QByteArray();
+    QTest::newRow("identical") << text << text;
+    QTest::newRow("append") << text << text + "第四段\n";
+    QTest::newRow("prepend") << text << "前言\n" + text;
+    QTest::newRow("binary") << QByteArray("\x00\x01\x02\xff", 4) << QByteArray("\xff\x00\x00\x01\x02", 5);
+    QTest::newRow("repeated") << QByteArray(10000, 'a') << QByteArray(10000, 'a') + "b" + QByteArray(5000, 'a');
+}
+
+void BinaryDeltaTest::roundTrip()
+{
+    QFETCH(QByteArray, base);
+    QFETCH(QByteArray, target);
+
+    QByteArray delta = BinaryDelta::encode(base, target);
+    QByteArray restored;
+    QVERIFY(BinaryDelta::apply(base, delta, &restored));
+    QCOMPARE(restored, target);
+}
+
+void BinaryDeltaTest::randomEdits()
+{
+    QRandomGenerator random(42);
+    for (int i = 0; i < 200; ++i) {
+        QByteArray base = makeText(random, 20 + random.bounded(200));
+        QByteArray target = edit(random, base);
+
+        QByteArray delta = BinaryDelta::encode(base, target);
+        QByteArray restored;
+        QVERIFY2(BinaryDelta::apply(base, delta, &restored), qPrintable(QString("第%1组").arg(i)));
+        QCOMPARE(restored, target);
+    }
+}
+
+void BinaryDeltaTest::corruptDelta()
+{
+    QRandomGenerator random(7);
+    for (int i = 0; i < 200; ++i) {
+        QByteArray base = makeText(random, 20 + random.bounded(100));
+        QByteArray delta = BinaryDelta::encode(base, edit(random, base));
+
+        // 截断的差异少了指令或长度，必须被拒绝
+        QByteArray restored;
+        QVERIFY(!BinaryDelta::apply(base, delta.left(random.bounded(int(delta.size()))), &restored));
+
+        // 改写过的差异可能恰好仍然有效，只要求不越界、不崩溃
+        QByteArray corrupted = delta;
+        for (int c = 0; c < 4; ++c) {
+            corrupted[random.bounded(int(corrupted.size()))] = char(random.bounded(256));
+        }
+        BinaryDelta::apply(base, corrupted, &restored);
+    }
+}
+
+void BinaryDeltaTest::wrongBase()
+{
+    // 复制指令超出了较短的基准
+    QByteArray base = QByteArray(4096, 'x') + "tail";
+    QByteArray delta = BinaryDelta::encode(base, base + "more");
+    QByteArray restored;
+    QVERIFY(!BinaryDelta::apply(base.left(100), delta, &restored));
+}
+
+QTEST_APPLESS_MAIN(BinaryDeltaTest)
+
+#include "BinaryDeltaTest.moc"
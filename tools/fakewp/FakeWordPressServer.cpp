@@ -0,0 +1,735 @@
+#include "FakeWordPressServer.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTimeZone>
+#include <QTimer>
+
+namespace {
+
+const QString ApiPrefix = "/wp-json/wp/v2/";
+const QString BatchPath = "/wp-json/batch/v1";
+// 与WordPress的默认值一致
+const int BatchLimit = 25;
+
+// 带宽受限时的发送间隔
+const int ThrottleIntervalMs = 10;
+
+const char* const Words[] = {
+    "WordPress", "Qt", "SQLite", "REST", "HTTP", "cache", "latency", "sync", "draft", "publish",
+    "缓存", "性能", "同步", "草稿", "发布", "分类", "标签", "数据库", "网络", "界面"
+};
+const int WordCount = sizeof(Words) / sizeof(Words[0]);
+
+QString gmtString(const QDateTime& dateTime)
+{
+    return dateTime.toUTC().toString("yyyy-MM-ddTHH:mm:ss");
+}
+
+}
+
+FakeWordPressServer::FakeWordPressServer(const Options& options, QObject* parent)
+    : QObject(parent), m_options(options), m_random(options.seed), m_nextObjectId(1), m_nextTermId(1)
+{
+    connect(&m_server, &QTcpServer::newConnection, this, &FakeWordPressServer::onNewConnection);
+    generateData();
+}
+
+FakeWordPressServer::~FakeWordPressServer()
+{
+    m_server.close();
+}
+
+bool FakeWordPressServer::listen(quint16 port)
+{
+    return m_server.listen(QHostAddress::LocalHost, port);
+}
+
+quint16 FakeWordPressServer::port() const
+{
+    return m_server.serverPort();
+}
+
+QString FakeWordPressServer::apiUrl() const
+{
+    return QString("http://127.0.0.1:%1%2").arg(port()).arg(ApiPrefix);
+}
+
+FakeWordPressServer::Options FakeWordPressServer::options() const
+{
+    return m_options;
+}
+
+void FakeWordPressServer::setOptions(const Options& options)
+{
+    // 只更新故障注入相关的设置，已生成的数据保持不变
+    m_options.latencyMs = options.latencyMs;
+    m_options.jitterMs = options.jitterMs;
+    m_options.bandwidthBytesPerSecond = options.bandwidthBytesPerSecond;
+    m_options.errorRate = options.errorRate;
+    m_options.disconnectRate = options.disconnectRate;
+    m_options.requireAuth = options.requireAuth;
+}
+
+FakeWordPressServer::Stats FakeWordPressServer::stats() const
+{
+    return m_stats;
+}
+
+void FakeWordPressServer::resetStats()
+{
+    m_stats = Stats();
+    m_stats.connections = m_connections.size();
+}
+
+int FakeWordPressServer::postCount() const
+{
+    return m_posts.size();
+}
+
+QJsonObject FakeWordPressServer::post(int id) const
+{
+    return m_posts.value(id);
+}
+
+void FakeWordPressServer::onNewConnection()
+{
+    while (QTcpSocket* socket = m_server.nextPendingConnection()) {
+        m_connections.insert(socket, Connection());
+        m_stats.connections = m_connections.size();
+        m_stats.peakConnections = qMax(m_stats.peakConnections, m_stats.connections);
+
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            onReadyRead(socket);
+        });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            onDisconnected(socket);
+        });
+    }
+}
+
+void FakeWordPressServer::onReadyRead(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+
+    it->input += socket->readAll();
+    processInput(socket);
+}
+
+void FakeWordPressServer::onDisconnected(QTcpSocket* socket)
+{
+    Connection connection = m_connections.take(socket);
+    if (connection.throttle) {
+        connection.throttle->stop();
+        connection.throttle->deleteLater();
+    }
+    m_stats.connections = m_connections.size();
+    socket->deleteLater();
+}
+
+void FakeWordPressServer::processInput(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end() || it->busy) {
+        return;
+    }
+
+    int headerEnd = it->input.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return;
+    }
+
+    // 请求行和请求头
+    QList<QByteArray> lines = it->input.left(headerEnd).split('\n');
+    QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+    if (requestLine.size() < 3) {
+        socket->abort();
+        return;
+    }
+
+    Request request;
+    request.method = requestLine.at(0);
+    request.url = QUrl::fromEncoded(requestLine.at(1));
+    for (const QByteArray& line : lines) {
+        int colon = line.indexOf(':');
+        if (colon > 0) {
+            request.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+        }
+    }
+
+    // 请求体需要完整到达后才处理
+    int contentLength = request.headers.value("content-length", "0").toInt();
+    if (it->input.size() < headerEnd + 4 + contentLength) {
+        return;
+    }
+    request.body = it->input.mid(headerEnd + 4, contentLength);
+    it->input.remove(0, headerEnd + 4 + contentLength);
+    it->busy = true;
+
+    ++m_stats.requests;
+    bool keepAlive = requestLine.at(2) == "HTTP/1.1"
+                     && request.headers.value("connection").toLower() != "close";
+
+    // 故障注入
+    double roll = m_random.generateDouble();
+    bool drop = roll < m_options.disconnectRate;
+    bool fail = !drop && roll < m_options.disconnectRate + m_options.errorRate;
+
+    Response response;
+    if (drop) {
+        ++m_stats.injectedDisconnects;
+    } else if (fail) {
+        ++m_stats.injectedErrors;
+        response = errorResponse(500, "internal_server_error", "注入的服务器错误");
+    } else if (request.headers.value("transfer-encoding").toLower() == "chunked") {
+        response = errorResponse(411, "length_required", "不支持分块传输的请求体");
+    } else {
+        response = route(request);
+    }
+
+    int delay = m_options.latencyMs;
+    if (m_options.jitterMs > 0) {
+        delay += m_random.bounded(m_options.jitterMs + 1);
+    }
+    response.headers.append({"Server-Timing", QString("total;dur=%1").arg(delay).toLatin1()});
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delay, this, [this, guard, response, keepAlive, drop]() {
+        if (!guard) {
+            return;
+        }
+        if (drop) {
+            guard->abort();
+            return;
+        }
+        sendResponse(guard, response, keepAlive);
+    });
+}
+
+void FakeWordPressServer::sendResponse(QPointer<QTcpSocket> socket, const Response& response, bool keepAlive)
+{
+    auto it = m_connections.find(socket.data());
+    if (it == m_connections.end()) {
+        return;
+    }
+
+    QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + " " + reasonPhrase(response.status) + "\r\n";
+    data += "Content-Type: application/json; charset=UTF-8\r\n";
+    data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+    for (const auto& header : response.headers) {
+        data += header.first + ": " + header.second + "\r\n";
+    }
+    data += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    data += "\r\n";
+    data += response.body;
+
+    it->closeAfterWrite = !keepAlive;
+
+    if (m_options.bandwidthBytesPerSecond <= 0) {
+        m_stats.bytesSent += data.size();
+        socket->write(data);
+        requestDone(socket.data());
+        return;
+    }
+
+    it->output += data;
+    if (!it->throttle) {
+        QTcpSocket* rawSocket = socket.data();
+        it->throttle = new QTimer(this);
+        it->throttle->setInterval(ThrottleIntervalMs);
+        connect(it->throttle, &QTimer::timeout, this, [this, rawSocket]() {
+            writeThrottled(rawSocket);
+        });
+    }
+    writeThrottled(socket.data());
+    it->throttle->start();
+}
+
+void FakeWordPressServer::writeThrottled(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+
+    qint64 chunk = qMax<qint64>(1, m_options.bandwidthBytesPerSecond * ThrottleIntervalMs / 1000);
+    QByteArray data = it->output.left(static_cast<int>(qMin<qint64>(chunk, it->output.size())));
+    it->output.remove(0, data.size());
+    m_stats.bytesSent += data.size();
+    socket->write(data);
+
+    if (it->output.isEmpty()) {
+        it->throttle->stop();
+        requestDone(socket);
+    }
+}
+
+void FakeWordPressServer::requestDone(QTcpSocket* socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+
+    it->busy = false;
+    if (it->closeAfterWrite) {
+        socket->disconnectFromHost();
+        return;
+    }
+
+    // 处理客户端已经发来的下一个请求
+    processInput(socket);
+}
+
+FakeWordPressServer::Response FakeWordPressServer::route(const Request& request)
+{
+    QString path = request.url.path();
+    if (m_options.batch && request.method == "POST" && (path == BatchPath || path == BatchPath + "/")) {
+        return batch(request);
+    }
+    if (!path.startsWith(ApiPrefix)) {
+        return errorResponse(404, "rest_no_route", "未找到匹配的路由");
+    }
+
+    QStringList parts = path.mid(ApiPrefix.size()).split('/', Qt::SkipEmptyParts);
+    QUrlQuery query(request.url);
+    const QByteArray& method = request.method;
+    bool isRead = method == "GET" || method == "HEAD";
+
+    if (m_options.requireAuth && !request.headers.value("authorization").startsWith("Basic ")
+        && (!isRead || parts.value(0) == "users")) {
+        return errorResponse(401, "rest_not_logged_in", "您目前没有登录。");
+    }
+
+    QJsonObject body;
+    if (!request.body.isEmpty() && request.headers.value("content-type").startsWith("application/json")) {
+        QJsonParseError parseError;
+        QJsonDocument document = QJsonDocument::fromJson(request.body, &parseError);
+        if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+            return errorResponse(400, "rest_invalid_json", "请求体不是有效的JSON");
+        }
+        body = document.object();
+    }
+
+    QString collection = parts.value(0);
+    bool hasId = parts.size() == 2;
+    int id = hasId ? parts.at(1).toInt() : 0;
+
+    if (collection == "users" && parts.value(1) == "me" && isRead) {
+        return jsonResponse(200, QJsonObject{{"id", 1}, {"name", "admin"}, {"slug", "admin"}});
+    }
+
+    if (collection == "posts") {
+        if (!hasId && isRead) {
+            return listItems(m_posts, query, true);
+        }
+        if (!hasId && method == "POST") {
+            return createPost(body);
+        }
+        if (hasId && !m_posts.contains(id)) {
+            return errorResponse(404, "rest_post_invalid_id", "无效的文章ID。");
+        }
+        if (hasId && isRead) {
+            return jsonResponse(200, m_posts.value(id));
+        }
+        if (hasId && (method == "POST" || method == "PUT" || method == "PATCH")) {
+            return updatePost(id, body);
+        }
+        if (hasId && method == "DELETE") {
+            return deletePost(id, query);
+        }
+    }
+
+    if (collection == "categories" || collection == "tags") {
+        QMap<int, QJsonObject>& terms = collection == "categories" ? m_categories : m_tags;
+        if (!hasId && isRead) {
+            return listItems(terms, query, false);
+        }
+        if (!hasId && method == "POST") {
+            return createTerm(terms, collection == "categories" ? "category" : "post_tag", body);
+        }
+        if (hasId && isRead && terms.contains(id)) {
+            return jsonResponse(200, terms.value(id));
+        }
+    }
+
+    if (collection == "media" && !hasId && method == "POST") {
+        return uploadMedia(request);
+    }
+
+    return errorResponse(404, "rest_no_route", "未找到匹配的路由");
+}
+
+FakeWordPressServer::Response FakeWordPressServer::batch(const Request& request)
+{
+    QJsonParseError parseError;
+    QJsonDocument document = QJsonDocument::fromJson(request.body, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        return errorResponse(400, "rest_invalid_json", "请求体不是有效的JSON");
+    }
+
+    QJsonArray requests = document.object().value("requests").toArray();
+    if (requests.isEmpty() || requests.size() > BatchLimit) {
+        return errorResponse(400, "rest_invalid_param", QString("requests必须包含1到%1项").arg(BatchLimit));
+    }
+
+    // 每一项按单独的请求路由（沿用外层请求的认证头），结果按顺序返回
+    QJsonArray responses;
+    for (const QJsonValue& value : requests) {
+        QJsonObject item = value.toObject();
+        Request subRequest;
+        subRequest.method = item.value("method").toString("POST").toUpper().toLatin1();
+        subRequest.url = QUrl("http://127.0.0.1/wp-json" + item.value("path").toString());
+        subRequest.headers = request.headers;
+        subRequest.headers.insert("content-type", "application/json");
+        if (item.contains("body")) {
+            subRequest.body = QJsonDocument(item.value("body").toObject()).toJson(QJsonDocument::Compact);
+        }
+
+        Response response = route(subRequest);
+        responses.append(QJsonObject{
+            {"status", response.status},
+            {"body", QJsonDocument::fromJson(response.body).object()},
+            {"headers", QJsonObject()}
+        });
+    }
+
+    return jsonResponse(207, QJsonObject{{"responses", responses}});
+}
+
+FakeWordPressServer::Response FakeWordPressServer::listItems(const QMap<int, QJsonObject>& items,
+                                                             const QUrlQuery& query, bool isPosts) const
+{
+    int perPage = query.hasQueryItem("per_page") ? query.queryItemValue("per_page").toInt() : 10;
+    int page = query.hasQueryItem("page") ? query.queryItemValue("page").toInt() : 1;
+    if (perPage < 1 || perPage > 100 || page < 1) {
+        return errorResponse(400, "rest_invalid_param", "无效的分页参数");
+    }
+
+    // 文章默认只返回已发布的，status=any返回回收站以外的全部
+    QStringList statuses = query.hasQueryItem("status")
+                               ? query.queryItemValue("status").split(',')
+                               : QStringList{"publish"};
+    QDateTime modifiedAfter;
+    if (query.hasQueryItem("modified_after")) {
+        // 没有时区后缀的时间按UTC处理
+        modifiedAfter = QDateTime::fromString(query.queryItemValue("modified_after", QUrl::FullyDecoded), Qt::ISODate);
+        if (modifiedAfter.timeSpec() == Qt::LocalTime) {
+            modifiedAfter.setTimeZone(QTimeZone::utc());
+        }
+    }
+
+    // include：只返回列出的ID
+    QList<int> include;
+    for (const QString& id : query.queryItemValue("include", QUrl::FullyDecoded).split(',', Qt::SkipEmptyParts)) {
+        include.append(id.toInt());
+    }
+
+    // WordPress默认按日期倒序返回文章，分类和标签按名称排序；这里统一按ID排序，结果稳定即可
+    QList<QJsonObject> matched;
+    for (const QJsonObject& item : items) {
+        if (!include.isEmpty() && !include.contains(item["id"].toInt())) {
+            continue;
+        }
+        if (isPosts) {
+            QString status = item["status"].toString();
+            if (statuses.contains("any") ? status == "trash" : !statuses.contains(status)) {
+                continue;
+            }
+            if (modifiedAfter.isValid()) {
+                QDateTime modified = QDateTime::fromString(item["modified_gmt"].toString(), Qt::ISODate);
+                modified.setTimeZone(QTimeZone::utc());
+                if (modified <= modifiedAfter) {
+                    continue;
+                }
+            }
+        }
+        matched.append(item);
+    }
+
+    int total = matched.size();
+    int totalPages = (total + perPage - 1) / perPage;
+    if (page > qMax(totalPages, 1)) {
+        return errorResponse(400, "rest_post_invalid_page_number", "请求的页码大于总页数。");
+    }
+
+    QStringList fields;
+    if (query.hasQueryItem("_fields")) {
+        fields = query.queryItemValue("_fields", QUrl::FullyDecoded).split(',', Qt::SkipEmptyParts);
+    }
+
+    // _embed不带值时嵌入全部关联，否则只嵌入列出的关联
+    bool embed = isPosts && query.hasQueryItem("_embed");
+    QStringList relations = query.queryItemValue("_embed", QUrl::FullyDecoded).split(',', Qt::SkipEmptyParts);
+
+    QJsonArray array;
+    for (int i = (page - 1) * perPage; i < qMin(total, page * perPage); ++i) {
+        QJsonObject item = matched.at(i);
+        if (embed) {
+            item["_embedded"] = embeddedFor(item, relations);
+        }
+        if (fields.isEmpty()) {
+            array.append(item);
+            continue;
+        }
+        QJsonObject filtered;
+        for (const QString& field : fields) {
+            if (item.contains(field)) {
+                filtered[field] = item.value(field);
+            }
+        }
+        array.append(filtered);
+    }
+
+    Response response = jsonResponse(200, array);
+    response.headers.append({"X-WP-Total", QByteArray::number(total)});
+    response.headers.append({"X-WP-TotalPages", QByteArray::number(totalPages)});
+    return response;
+}
+
+QJsonObject FakeWordPressServer::embeddedFor(const QJsonObject& post, const QStringList& relations) const
+{
+    QJsonObject embedded;
+    if (relations.isEmpty() || relations.contains("author")) {
+        // 所有文章的作者都是users/me返回的用户
+        embedded["author"] = QJsonArray{QJsonObject{{"id", post["author"].toInt()}, {"name", "admin"}, {"slug", "admin"}}};
+    }
+    int mediaId = post["featured_media"].toInt();
+    if ((relations.isEmpty() || relations.contains("wp:featuredmedia")) && m_media.contains(mediaId)) {
+        embedded["wp:featuredmedia"] = QJsonArray{m_media.value(mediaId)};
+    }
+    return embedded;
+}
+
+FakeWordPressServer::Response FakeWordPressServer::createPost(const QJsonObject& body)
+{
+    int id = m_nextObjectId++;
+    QJsonObject post = makePost(id, QString(), QString(), QString(), QDateTime::currentDateTimeUtc(), "draft");
+    applyPostFields(post, body);
+    m_posts.insert(id, post);
+    return jsonResponse(201, post);
+}
+
+FakeWordPressServer::Response FakeWordPressServer::updatePost(int id, const QJsonObject& body)
+{
+    QJsonObject post = m_posts.value(id);
+    applyPostFields(post, body);
+
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    post["modified"] = gmtString(now);
+    post["modified_gmt"] = gmtString(now);
+    m_posts.insert(id, post);
+    return jsonResponse(200, post);
+}
+
+FakeWordPressServer::Response FakeWordPressServer::deletePost(int id, const QUrlQuery& query)
+{
+    QJsonObject post = m_posts.value(id);
+
+    // 不带force时WordPress把文章移到回收站
+    if (query.queryItemValue("force") != "true") {
+        post["status"] = "trash";
+        m_posts.insert(id, post);
+        return jsonResponse(200, post);
+    }
+
+    m_posts.remove(id);
+    return jsonResponse(200, QJsonObject{{"deleted", true}, {"previous", post}});
+}
+
+FakeWordPressServer::Response FakeWordPressServer::createTerm(QMap<int, QJsonObject>& terms, const QString& taxonomy,
+                                                              const QJsonObject& body)
+{
+    QString name = body["name"].toString();
+    if (name.isEmpty()) {
+        return errorResponse(400, "rest_missing_callback_param", "缺少参数：name");
+    }
+    for (const QJsonObject& term : terms) {
+        if (term["name"].toString() == name) {
+            return errorResponse(400, "term_exists", "具有相同名称的项目已存在。");
+        }
+    }
+
+    int id = m_nextTermId++;
+    QJsonObject term{{"id", id}, {"name", name}, {"slug", name.toLower()}, {"taxonomy", taxonomy}, {"count", 0}};
+    terms.insert(id, term);
+    return jsonResponse(201, term);
+}
+
+FakeWordPressServer::Response FakeWordPressServer::uploadMedia(const Request& request)
+{
+    if (request.body.isEmpty()) {
+        return errorResponse(400, "rest_upload_no_data", "未提供数据。");
+    }
+
+    int id = m_nextObjectId++;
+    QString url = QString("http://127.0.0.1:%1/wp-content/uploads/fake-%2.jpg").arg(port()).arg(id);
+    QJsonObject media{
+        {"id", id},
+        {"media_type", "image"},
+        {"source_url", url},
+        {"guid", QJsonObject{{"rendered", url}}}
+    };
+    m_media.insert(id, media);
+    return jsonResponse(201, media);
+}
+
+FakeWordPressServer::Response FakeWordPressServer::jsonResponse(int status, const QJsonValue& value)
+{
+    Response response;
+    response.status = status;
+    response.body = value.isArray() ? QJsonDocument(value.toArray()).toJson(QJsonDocument::Compact)
+                                    : QJsonDocument(value.toObject()).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+FakeWordPressServer::Response FakeWordPressServer::errorResponse(int status, const QString& code, const QString& message)
+{
+    return jsonResponse(status, QJsonObject{
+        {"code", code},
+        {"message", message},
+        {"data", QJsonObject{{"status", status}}}
+    });
+}
+
+QByteArray FakeWordPressServer::reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 411: return "Length Required";
+    case 500: return "Internal Server Error";
+    default: return "Unknown";
+    }
+}
+
+QString FakeWordPressServer::fieldValue(const QJsonValue& value)
+{
+    // 客户端可能发送字符串，也可能发送{"raw": ...}对象
+    return value.isObject() ? value.toObject()["raw"].toString() : value.toString();
+}
+
+void FakeWordPressServer::generateData()
+{
+    for (int i = 0; i < m_options.categories; ++i) {
+        int id = m_nextTermId++;
+        QString name = QString("分类%1").arg(i + 1);
+        m_categories.insert(id, QJsonObject{{"id", id}, {"name", name}, {"slug", QString("category-%1").arg(i + 1)},
+                                            {"taxonomy", "category"}, {"count", 0}});
+    }
+    for (int i = 0; i < m_options.tags; ++i) {
+        int id = m_nextTermId++;
+        QString name = QString("tag-%1").arg(i + 1);
+        m_tags.insert(id, QJsonObject{{"id", id}, {"name", name}, {"slug", name}, {"taxonomy", "post_tag"}, {"count", 0}});
+    }
+
+    QList<int> categoryIds = m_categories.keys();
+    QList<int> tagIds = m_tags.keys();
+    QDateTime start(QDate(2019, 1, 1), QTime(8, 0), QTimeZone::utc());
+
+    for (int i = 0; i < m_options.posts; ++i) {
+        QStringList paragraphs;
+        for (int p = 0, count = 3 + m_random.bounded(10); p < count; ++p) {
+            QStringList words;
+            for (int w = 0, length = 20 + m_random.bounded(60); w < length; ++w) {
+                words << QString::fromUtf8(Words[m_random.bounded(WordCount)]);
+            }
+            paragraphs << "<p>" + words.join(' ') + "</p>";
+        }
+
+        QStringList titleWords;
+        for (int w = 0, length = 3 + m_random.bounded(8); w < length; ++w) {
+            titleWords << QString::fromUtf8(Words[m_random.bounded(WordCount)]);
+        }
+
+        int id = m_nextObjectId++;
+        QDateTime date = start.addSecs(static_cast<qint64>(i) * 3600 * 7);
+        QJsonObject post = makePost(id, titleWords.join(' '), paragraphs.join('\n'), paragraphs.first(), date,
+                                    m_random.bounded(10) < 9 ? "publish" : "draft");
+
+        QJsonArray categories;
+        if (!categoryIds.isEmpty()) {
+            categories.append(categoryIds.at(m_random.bounded(categoryIds.size())));
+        }
+        QJsonArray tags;
+        for (int t = 0, count = tagIds.isEmpty() ? 0 : 2 + m_random.bounded(8); t < count; ++t) {
+            int tagId = tagIds.at(m_random.bounded(tagIds.size()));
+            if (!tags.contains(tagId)) {
+                tags.append(tagId);
+            }
+        }
+        post["categories"] = categories;
+        post["tags"] = tags;
+        m_posts.insert(id, post);
+    }
+
+    // 每4篇文章中有一篇带特色图片（不消耗随机数，其他数据与之前相同）
+    const QList<int> postIds = m_posts.keys();
+    for (int i = 0; i < postIds.size(); i += 4) {
+        int id = m_nextObjectId++;
+        QString url = QString("https://example.com/wp-content/uploads/fake-%1.jpg").arg(id);
+        m_media.insert(id, QJsonObject{
+            {"id", id},
+            {"media_type", "image"},
+            {"source_url", url},
+            {"guid", QJsonObject{{"rendered", url}}}
+        });
+        m_posts[postIds.at(i)]["featured_media"] = id;
+    }
+}
+
+QJsonObject FakeWordPressServer::makePost(int id, const QString& title, const QString& content, const QString& excerpt,
+                                          const QDateTime& date, const QString& status) const
+{
+    return QJsonObject{
+        {"id", id},
+        {"date", gmtString(date)},
+        {"date_gmt", gmtString(date)},
+        {"modified", gmtString(date)},
+        {"modified_gmt", gmtString(date)},
+        {"slug", QString("post-%1").arg(id)},
+        {"status", status},
+        {"type", "post"},
+        {"link", QString("https://example.com/?p=%1").arg(id)},
+        {"title", QJsonObject{{"raw", title}, {"rendered", title}}},
+        {"content", QJsonObject{{"raw", content}, {"rendered", content}, {"protected", false}}},
+        {"excerpt", QJsonObject{{"raw", excerpt}, {"rendered", excerpt}, {"protected", false}}},
+        {"author", 1},
+        {"featured_media", 0},
+        {"categories", QJsonArray()},
+        {"tags", QJsonArray()}
+    };
+}
+
+void FakeWordPressServer::applyPostFields(QJsonObject& post, const QJsonObject& body) const
+{
+    for (const QString& key : {QString("title"), QString("content"), QString("excerpt")}) {
+        if (body.contains(key)) {
+            QString value = fieldValue(body[key]);
+            QJsonObject field = post[key].toObject();
+            field["raw"] = value;
+            field["rendered"] = value;
+            post[key] = field;
+        }
+    }
+
+    for (const QString& key : {QString("status"), QString("categories"), QString("tags"), QString("featured_media")}) {
+        if (body.contains(key)) {
+            post[key] = body[key];
+        }
+    }
+
+    if (body.contains("date")) {
+        QDateTime date = QDateTime::fromString(body["date"].toString(), Qt::ISODate);
+        if (date.isValid()) {
+            post["date"] = gmtString(date);
+            post["date_gmt"] = gmtString(date);
+        }
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QPointer>
+#include <QHash>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QDateTime>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QUrl>
+#include <QUrlQuery>
+
+class QTimer;
+
+// 本地的WordPress REST API模拟服务器，用于可重复的负载测试
+// 实现了posts、categories、tags、media和users/me这几个客户端用到的接口，
+// 列表接口支持分页（X-WP-Total/X-WP-TotalPages）、modified_after、_fields和_embed参数。
+// batch/v1把最多25个写请求合并为一个请求，每项的结果按顺序返回（HTTP 207）。
+// 可以注入固定延迟、带宽限制、HTTP 500错误和连接中断，所有随机行为都由种子决定。
+class FakeWordPressServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        int posts = 1000;                   // 初始文章数
+        int categories = 20;                // 初始分类数
+        int tags = 200;                     // 初始标签数
+        int latencyMs = 0;                  // 每个响应的固定延迟
+        int jitterMs = 0;                   // 在固定延迟上追加的随机延迟（0..jitterMs）
+        qint64 bandwidthBytesPerSecond = 0; // 每个连接的发送带宽，0表示不限
+        double errorRate = 0;               // 返回HTTP 500的概率
+        double disconnectRate = 0;          // 不返回响应直接断开连接的概率
+        bool requireAuth = true;            // 写操作和users/me是否要求Basic认证
+        bool batch = true;                  // 是否提供batch/v1接口
+        quint32 seed = 1;
+    };
+
+    struct Stats
+    {
+        int requests = 0;
+        int injectedErrors = 0;
+        int injectedDisconnects = 0;
+        int connections = 0;
+        int peakConnections = 0;
+        qint64 bytesSent = 0;
+    };
+
+    explicit FakeWordPressServer(const Options& options = Options(), QObject* parent = nullptr);
+    ~FakeWordPressServer();
+
+    // 在本机回环地址上监听，port为0时由系统分配
+    bool listen(quint16 port = 0);
+    quint16 port() const;
+
+    // 客户端使用的API地址，例如 http://127.0.0.1:8080/wp-json/wp/v2/
+    QString apiUrl() const;
+
+    Options options() const;
+    void setOptions(const Options& options);
+
+    Stats stats() const;
+    void resetStats();
+
+    int postCount() const;
+    QJsonObject post(int id) const;
+
+private:
+    struct Request
+    {
+        QByteArray method;
+        QUrl url;
+        QHash<QByteArray, QByteArray> headers;   // 键为小写
+        QByteArray body;
+    };
+
+    struct Response
+    {
+        int status = 200;
+        QList<QPair<QByteArray, QByteArray>> headers;
+        QByteArray body;
+    };
+
+    struct Connection
+    {
+        QByteArray input;
+        QByteArray output;      // 带宽受限时等待发送的数据
+        bool busy = false;      // 正在处理一个请求（包括延迟期间）
+        bool closeAfterWrite = false;
+        QTimer* throttle = nullptr;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket* socket);
+    void onDisconnected(QTcpSocket* socket);
+
+    // 从缓冲区中取出下一个完整的请求并处理
+    void processInput(QTcpSocket* socket);
+    void sendResponse(QPointer<QTcpSocket> socket, const Response& response, bool keepAlive);
+    void writeThrottled(QTcpSocket* socket);
+    void requestDone(QTcpSocket* socket);
+
+    // 路由
+    Response route(const Request& request);
+    Response listItems(const QMap<int, QJsonObject>& items, const QUrlQuery& query, bool isPosts) const;
+    // _embed：文章的作者和特色图片（relations为空时全部嵌入）
+    QJsonObject embeddedFor(const QJsonObject& post, const QStringList& relations) const;
+    Response createPost(const QJsonObject& body);
+    Response updatePost(int id, const QJsonObject& body);
+    Response deletePost(int id, const QUrlQuery& query);
+    Response createTerm(QMap<int, QJsonObject>& terms, const QString& taxonomy, const QJsonObject& body);
+    Response uploadMedia(const Request& request);
+    Response batch(const Request& request);
+
+    static Response jsonResponse(int status, const QJsonValue& value);
+    static Response errorResponse(int status, const QString& code, const QString& message);
+    static QByteArray reasonPhrase(int status);
+    static QString fieldValue(const QJsonValue& value);
+
+    void generateData();
+    QJsonObject makePost(int id, const QString& title, const QString& content, const QString& excerpt,
+                         const QDateTime& date, const QString& status) const;
+    void applyPostFields(QJsonObject& post, const QJsonObject& body) const;
+
+    Options m_options;
+    Stats m_stats;
+    QRandomGenerator m_random;
+    QTcpServer m_server;
+    QHash<QTcpSocket*, Connection> m_connections;
+
+    QMap<int, QJsonObject> m_posts;
+    QMap<int, QJsonObject> m_categories;
+    QMap<int, QJsonObject> m_tags;
+    QMap<int, QJsonObject> m_media;
+
+    // 文章和媒体共用一个ID序列，分类和标签共用另一个（与WordPress的表结构一致）
+    int m_nextObjectId;
+    int m_nextTermId;
+};
@@ -0,0 +1,56 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <cstdio>
+
+#include "FakeWordPressServer.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("fakewp-server");
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("模拟WordPress REST API的本地服务器，用于可重复的负载测试。");
+    parser.addHelpOption();
+    
+    QCommandLineOption portOption("port", "监听端口，0表示由系统分配", "port", "8080");
+    QCommandLineOption postsOption("posts", "初始文章数", "n", "1000");
+    QCommandLineOption categoriesOption("categories", "初始分类数", "n", "20");
+    QCommandLineOption tagsOption("tags", "初始标签数", "n", "200");
+    QCommandLineOption latencyOption("latency", "每个响应的延迟（毫秒）", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "追加的随机延迟上限（毫秒）", "ms", "0");
+    QCommandLineOption bandwidthOption("bandwidth", "每个连接的发送带宽（字节/秒），0表示不限", "bytes", "0");
+    QCommandLineOption errorRateOption("error-rate", "返回HTTP 500的概率（0-1）", "rate", "0");
+    QCommandLineOption disconnectRateOption("disconnect-rate", "直接断开连接的概率（0-1）", "rate", "0");
+    QCommandLineOption noAuthOption("no-auth", "不检查认证头");
+    QCommandLineOption noBatchOption("no-batch", "不提供batch/v1接口（模拟WordPress 5.6之前的版本）");
+    QCommandLineOption seedOption("seed", "随机种子", "seed", "1");
+    parser.addOptions({portOption, postsOption, categoriesOption, tagsOption, latencyOption, jitterOption,
+                       bandwidthOption, errorRateOption, disconnectRateOption, noAuthOption, noBatchOption,
+                       seedOption});
+    parser.process(app);
+    
+    FakeWordPressServer::Options options;
+    options.posts = parser.value(postsOption).toInt();
+    options.categories = parser.value(categoriesOption).toInt();
+    options.tags = parser.value(tagsOption).toInt();
+    options.latencyMs = parser.value(latencyOption).toInt();
+    options.jitterMs = parser.value(jitterOption).toInt();
+    options.bandwidthBytesPerSecond = parser.value(bandwidthOption).toLongLong();
+    options.errorRate = parser.value(errorRateOption).toDouble();
+    options.disconnectRate = parser.value(disconnectRateOption).toDouble();
+    options.requireAuth = !parser.isSet(noAuthOption);
+    options.batch = !parser.isSet(noBatchOption);
+    options.seed = parser.value(seedOption).toUInt();
+    
+    FakeWordPressServer server(options);
+    if (!server.listen(static_cast<quint16>(parser.value(portOption).toUInt()))) {
+        std::fprintf(stderr, "无法监听端口 %s\n", qPrintable(parser.value(portOption)));
+        return 1;
+    }
+    
+    std::printf("%s\n", qPrintable(server.apiUrl()));
+    std::fflush(stdout);
+    
+    return app.exec();
+}